@@ -19,6 +19,7 @@
 
 #ifndef DIRENT_H_
 #define DIRENT_H_
+#ifndef _ASM_FILE_
 
 	#include <sys/types.h>
 	#include <limits.h>
@@ -29,9 +30,21 @@
 	struct dirent
 	{
 		ino_t d_ino;           /* File serial number. */
+		unsigned char d_type;  /* File type.          */
 		char d_name[NAME_MAX]; /* Name of entry.      */
 	};
 
+	/* File types. */
+	#define DT_UNKNOWN  0 /* Unknown.              */
+	#define DT_FIFO     1 /* FIFO.                 */
+	#define DT_CHR      2 /* Character device.     */
+	#define DT_DIR      4 /* Directory.            */
+	#define DT_BLK      6 /* Block device.         */
+	#define DT_REG      8 /* Regular file.         */
+
+	/* Converts a file mode to a file type. */
+	#define IFTODT(mode) (((mode) & 0170000) >> 12)
+
 	/* Directory stream buffer size. */
 	#define _DIR_BUFSIZ ((1024/sizeof(struct dirent))*sizeof(struct dirent))
 
@@ -71,4 +84,10 @@
 	 */
 	extern void rewinddir(DIR *dirp);
 
+	/*
+	 * Reads directory entries.
+	 */
+	extern ssize_t getdents(int fd, struct dirent *buf, size_t nbytes);
+
+#endif /* _ASM_FILE_ */
 #endif /* DIRENT_H_ */
@@ -132,8 +132,17 @@
 	 */
 	/**@{*/
 
+#ifndef __NANVIX_KERNEL__
+
 	/* Forward definitions. */
-	extern int errno;
+	extern int *__errno(void);
+
+	/**
+	 * @brief Number of last error of the calling thread.
+	 */
+	#define errno (*__errno())
+
+#endif /* __NANVIX_KERNEL__ */
 
 	/**@}*/
 
@@ -40,11 +40,13 @@
 	#define FD_CLOEXEC 01 /* Close on exec. */
 
 	/* Commands for fcntl(). */
-	#define F_DUPFD  0 /* Duplicate file descriptor.                   */
-	#define F_GETFD  1 /* Get file descriptor flags.                   */
-	#define F_SETFD  2 /* Set file descriptor flags.                   */
-	#define F_GETFL  3 /* Get file status flags and file access modes. */
-	#define F_SETFL  4 /* Set file status flags.                       */
+	#define F_DUPFD      0 /* Duplicate file descriptor.                   */
+	#define F_GETFD      1 /* Get file descriptor flags.                   */
+	#define F_SETFD      2 /* Set file descriptor flags.                   */
+	#define F_GETFL      3 /* Get file status flags and file access modes. */
+	#define F_SETFL      4 /* Set file status flags.                       */
+	#define F_SETPIPE_SZ 5 /* Set pipe buffer size.                        */
+	#define F_GETPIPE_SZ 6 /* Get pipe buffer size.                        */
 
 	/*
 	 * Returns file's access mode.
@@ -40,6 +40,14 @@
 	#define DWORD_BIT  32 /* 32 bits. */
 	#define QWORD_BIT  64 /* 64 bits. */
 
+	/* EFLAGS bits. */
+	#define EFLAGS_IF 0x00000200 /* Interrupt enable flag. */
+
+	/* Model-specific registers. */
+	#define MSR_SYSENTER_CS  0x174 /* sysenter code segment.   */
+	#define MSR_SYSENTER_ESP 0x175 /* sysenter stack pointer.  */
+	#define MSR_SYSENTER_EIP 0x176 /* sysenter entry point.    */
+
 	/* Offsets to the jmp_buf structure*/
 	#define JMP_BUF_EBX     0
 	#define JMP_BUF_ESI     4
@@ -81,11 +89,21 @@
 	 */
 	EXTERN void tlb_flush(void);
 
+	/*
+	 * Loads the page directory at physical address pgdir.
+	 */
+	EXTERN void pgdir_flush(addr_t pgdir);
+
 	/*
 	 * Flushes the IDT pointed to by idtptr.
 	 */
 	EXTERN void idt_flush(struct idtptr *idtptr);
 
+	/*
+	 * Writes value to the model-specific register msr.
+	 */
+	EXTERN void msr_write(unsigned msr, dword_t value);
+
 #endif /* _ASM_FILE_ */
 
 #endif /* I386_H_ */
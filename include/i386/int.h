@@ -88,8 +88,9 @@
 	EXTERN void swint17();
 	EXTERN void swint19();
 
-	/* System call hook. */
+	/* System call hooks. */
 	EXTERN void syscall();
+	EXTERN void sysenter();
 
 	/* Hardware interrupt hooks. */
 	EXTERN void hwint0();
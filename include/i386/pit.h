@@ -26,5 +26,27 @@
 	/* Registers. */
 	#define PIT_CTRL 0x43 /* Control. */
 	#define PIT_DATA 0x40 /* Data.    */
+	#define PIT_CH2  0x42 /* Channel 2 data.      */
+	#define PIT_GATE 0x61 /* Channel 2 gate.      */
+
+	/* Control bytes for channel 0. */
+	#define PIT_LATCH    0x00 /* Latch counter.                */
+	#define PIT_ONESHOT  0x30 /* Interrupt on terminal count.  */
+	#define PIT_PERIODIC 0x36 /* Square wave generator.        */
+	#define PIT_READBACK 0xe2 /* Read back status.             */
+
+	/* Control byte for channel 2. */
+	#define PIT_CH2_ONESHOT 0xb0 /* Interrupt on terminal count. */
+
+	/* Channel 2 gate bits. */
+	#define PIT_GATE_ON  0x01 /* Gate input.               */
+	#define PIT_SPEAKER  0x02 /* Speaker data.             */
+	#define PIT_CH2_OUT  0x20 /* Output pin state.         */
+
+	/* Status bits. */
+	#define PIT_OUT 0x80 /* Output pin state. */
+
+	/* Largest counter value. */
+	#define PIT_COUNT_MAX 0xffff
 
 #endif /* I386_PIT_H_ */
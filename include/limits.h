@@ -59,6 +59,9 @@
 	/* Files that one process can have open simultaneously. */
 	#define OPEN_MAX 20
 
+	/* Maximum number of buffers in readv() and writev(). */
+	#define IOV_MAX 16
+
 	/* Length of argument to the execve(). */
 	#define ARG_MAX 2048
 
@@ -67,6 +70,9 @@
 	 */
 	#define PATH_MAX 512
 
+	/* Maximum value for an object of type ssize_t. */
+	#define SSIZE_MAX 2147483647
+
 	/* Maximum value for unsigned long. */
 	#define ULONG_MAX 4294967295u
 
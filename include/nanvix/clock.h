@@ -21,10 +21,14 @@
 #define TIMER_H_
 
 	#include <nanvix/const.h>
+	#include <stdint.h>
 
 	/* Clock frequency (in hertz). */
 	#define CLOCK_FREQ 100
 
+	/* Nanoseconds per clock tick. */
+	#define NSEC_PER_TICK (1000000000/CLOCK_FREQ)
+
 	/* Current time. */
 	#define CURRENT_TIME (startup_time + ticks/CLOCK_FREQ)
 
@@ -33,10 +37,28 @@
 	 */
 	EXTERN void clock_init(unsigned freq);
 
+	/*
+	 * Stops the periodic timer interrupt for a while.
+	 */
+	EXTERN void clock_sleep(unsigned nticks);
+
+	/*
+	 * Restarts the periodic timer interrupt.
+	 */
+	EXTERN void clock_wakeup(void);
+
+	/*
+	 * Returns the monotonic time in nanoseconds.
+	 */
+	EXTERN uint64_t clock_ns(void);
+
 	/* Ticks since system initialization. */
 	EXTERN unsigned ticks;
 
 	/* Time at system startup. */
 	EXTERN unsigned startup_time;
 
+	/* Worst delay in serving a periodic clock interrupt (in nanoseconds). */
+	EXTERN unsigned clock_latency;
+
 #endif /* TIMER_H_ */
@@ -31,7 +31,7 @@
 	/* Kernel configuration. */
 	#define MULTIUSER              0 /* Multiuser support?              */
 	#define KERNEL_VERSION     "1.2" /* Kernel version.                 */
-	#define PROC_MAX              64 /* Maximum number of process.      */
+	#define PROC_MAX             128 /* Maximum number of process.      */
 	#define PROC_SIZE_MAX  0x4000000 /* Maximum process size.           */
 	#define RAMDISK_SIZE    0x400000 /* RAM disks size.                 */
 	#define INITRD_SIZE      0x80000 /* Init RAM disk size.             */
@@ -39,9 +39,8 @@
 	#define NR_SUPERBLOCKS         4 /* Number of in-core super blocks. */
 	#define ROOT_DEV          0x0101 /* Root device number.             */
 	#define SWAP_DEV          0x0101 /* Swap device number.             */
-	#define NR_FILES             256 /* Number of opened files.         */
 	#define NR_REGIONS           128 /* Number of memory regions.       */
 	#define NR_BUFFERS           256 /* Number of block buffers.        */
-	#define SEM_ENABLED              /* Enable semaphore support        */
-	#define SEM_MAX               50 /* Maximum number of semaphores    */
+	#define SEM_MAX               50 /* Maximum number of sem sets      */
+	#define SHM_MAX               32 /* Maximum number of shm segments  */
 #endif /* CONFIG_H_ */
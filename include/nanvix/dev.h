@@ -83,6 +83,7 @@
 		ssize_t (*write)(unsigned, const char *, size_t); /* Write.   */
 		int (*ioctl)(unsigned, unsigned, unsigned);       /* Control. */
 		int (*close)(dev_t);                              /* Close.   */
+		int (*poll)(unsigned, int);                       /* Poll.    */
 	};
 
 	EXTERN int cdev_register(unsigned, const struct cdev *);
@@ -113,6 +114,11 @@
 	 */
 	EXTERN int cdev_ioctl(dev_t dev, unsigned cmd, unsigned arg);
 
+	/*
+	 * Checks whether a character device is ready for I/O.
+	 */
+	EXTERN int cdev_poll(dev_t dev, int events);
+
 	/*========================================================================*
 	 *                               block device                             *
 	 *========================================================================*/
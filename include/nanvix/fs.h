@@ -40,6 +40,7 @@
 	#include <nanvix/pm.h>
 	#include <sys/stat.h>
 	#include <sys/types.h>
+	#include <dirent.h>
 	#include <stdint.h>
 	#include <ustat.h>
 
@@ -91,6 +92,22 @@
 	 */
 	/**@{*/
 
+	/**
+	 * @brief Default pipe buffer size (in bytes).
+	 */
+	#define PIPE_SIZE PAGE_SIZE
+
+	/**
+	 * @brief Maximum pipe buffer size (in bytes).
+	 */
+	#define PIPE_SIZE_MAX (16*PAGE_SIZE)
+
+	/**
+	 * @brief Maximum number of pages, system-wide, that pipe buffers may hold
+	 *        above the default size before only the superuser may grow them.
+	 */
+	#define PIPE_EXTRA_MAX 64
+
 	/**
 	 * @brief Inode flags.
 	 */
@@ -120,13 +137,15 @@
 		struct superblock *sb;    /**< Superblock.                           */
 		unsigned count;           /**< Reference count.                      */
 		enum inode_flags flags;   /**< Flags.                                */
-		char *pipe;               /**< Pipe page.                            */
+		char **pipe;              /**< Pipe buffer pages.                    */
 		off_t head;               /**< Pipe head.                            */
 		off_t tail;               /**< Pipe tail.                            */
+		size_t pipelen;           /**< Bytes in the pipe buffer.             */
 		struct inode *free_next;  /**< Next inode in the free list.          */
 		struct inode *hash_next;  /**< Next inode in the hash table.         */
 		struct inode *hash_prev;  /**< Previous inode in the hash table.     */
 		struct process *chain;    /**< Sleeping chain.                       */
+		struct pollwait *polls;   /**< Polling processes (pipes only).       */
 	};
 
 	/**@}*/
@@ -139,10 +158,12 @@
 	EXTERN void inode_truncate(struct inode *i);
 	EXTERN struct inode *inode_alloc(struct superblock *sb);
 	EXTERN struct inode *inode_get(dev_t dev, ino_t num);
+	EXTERN mode_t inode_peek(dev_t dev, ino_t num);
 	EXTERN void inode_put(struct inode *i);
 	EXTERN struct inode *inode_dname(const char *path, const char **name);
 	EXTERN struct inode *inode_name(const char *pathname);
 	EXTERN struct inode *inode_pipe(void);
+	EXTERN int inode_path(struct inode *ip, char *buf, size_t size);
 
 /*============================================================================*
  *                            Super Block Library                             *
@@ -188,17 +209,17 @@
 	};
 	
 	EXTERN int test_mode_enabled;
-	
-	/*
-	 * File table.
-	 */
-	EXTERN struct file filetab[NR_FILES];
 
 	/*
 	 * Initializes the file system manager.
 	 */
 	EXTERN void fs_init(void);
 
+	/*
+	 * Writeback kernel thread.
+	 */
+	EXTERN void kflushd(void *arg);
+
 	/*
 	 * Checks permissions on a file
 	 */
@@ -224,6 +245,11 @@
 	 */
 	EXTERN struct file *getfile(void);
 
+	/*
+	 * Releases a file table entry.
+	 */
+	EXTERN void putfile(struct file *f);
+
 	/*
 	 * Closes a file.
 	 */
@@ -245,6 +271,12 @@
 	 */
 	EXTERN int dir_remove(struct inode *dinode, const char *filename);
 
+	/*
+	 * Reads live entries of a directory.
+	 */
+	EXTERN ssize_t dir_read
+	(struct inode *dinode, struct dirent *buf, size_t n, off_t *pos);
+
 	/*
 	 * Reads from a regular file.
 	 */
@@ -255,15 +287,38 @@
 	 */
 	EXTERN ssize_t file_write(struct inode *i, const void *buf, size_t n, off_t off);
 
+	/*
+	 * Copies data between regular files.
+	 */
+	EXTERN ssize_t file_copy
+	(struct inode *in, off_t inoff, struct inode *out, off_t outoff, size_t n);
+
 	/*
 	 * Reads data from a pipe.
 	 */
-	EXTERN ssize_t pipe_read(struct inode *inode, char *buf, size_t n);
+	EXTERN ssize_t pipe_read
+	(struct inode *inode, char *buf, size_t n, int nonblock);
 
 	/*
 	 * Writes data to a pipe.
 	 */
-	EXTERN ssize_t pipe_write(struct inode *inode, const char *buf, size_t n);
+	EXTERN ssize_t pipe_write
+	(struct inode *inode, const char *buf, size_t n, int nonblock);
+
+	/*
+	 * Checks whether a pipe is ready for I/O.
+	 */
+	EXTERN int pipe_poll(struct inode *inode, int events);
+
+	/*
+	 * Resizes the buffer of a pipe.
+	 */
+	EXTERN int pipe_resize(struct inode *inode, size_t size);
+
+	/*
+	 * Releases the buffer of a pipe.
+	 */
+	EXTERN void pipe_free(struct inode *inode);
 
 	/*
 	 * Root device.
@@ -58,15 +58,75 @@
 	EXTERN void enable_interrupts(void);
 	EXTERN void disable_interrupts(void);
 	EXTERN void halt(void);
+	EXTERN void processor_idle(void);
+	EXTERN uint64_t rdtsc(void);
+	EXTERN int cpu_has_tsc(void);
+	EXTERN int cpu_has_sep(void);
 	EXTERN void processor_drop(unsigned);
 	EXTERN unsigned processor_raise(unsigned);
 	EXTERN void processor_reload(void);
 	EXTERN void setup(void);
 	EXTERN void user_mode(addr_t, addr_t);
 	EXTERN void switch_to(struct process *);
+	EXTERN void kthread_start(void);
 	EXTERN unsigned irq_lvl(unsigned);
 	/**@}*/
 
+	/**
+	 * @brief Spinlock.
+	 */
+	typedef volatile unsigned spinlock_t;
+
+	/**
+	 * @brief Initial value of a spinlock.
+	 */
+	#define SPINLOCK_UNLOCKED 0
+
+	/**
+	 * @name Spinlock Functions
+	 */
+	/**@{*/
+	EXTERN void spin_lock(spinlock_t *);
+	EXTERN void spin_unlock(spinlock_t *);
+	EXTERN unsigned spin_lock_irqsave(spinlock_t *);
+	EXTERN void spin_unlock_irqrestore(spinlock_t *, unsigned);
+	/**@}*/
+
+	/**
+	 * @brief Deferred interrupt work.
+	 *
+	 * @details Interrupt handlers schedule tasklets to do the bulk of their
+	 *          work later on, with interrupts enabled. Tasklets run on the
+	 *          way out of the outermost hardware interrupt, never nest and
+	 *          must not sleep.
+	 */
+	struct tasklet
+	{
+		void (*func)(void *); /**< Work function.             */
+		void *arg;            /**< Argument to work function. */
+		int pending;          /**< Scheduled to run?          */
+		struct tasklet *next; /**< Next scheduled tasklet.    */
+	};
+
+	/**
+	 * @name Deferred Interrupt Work Functions
+	 */
+	/**@{*/
+	EXTERN void tasklet_schedule(struct tasklet *);
+	EXTERN void do_softirq(void);
+	EXTERN void hwint_stats(void);
+	/**@}*/
+
+	/**
+	 * @name Multiprocessor Functions
+	 */
+	/**@{*/
+	EXTERN void smp_init(void);
+	/**@}*/
+
+	/* Forward definitions. */
+	EXTERN unsigned ncpus;
+
 	/**
 	 * @name I/O Functions
 	 */
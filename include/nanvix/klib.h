@@ -103,6 +103,7 @@
 		unsigned tail;                      /**< Next free slot in the buf.  */
 		unsigned char buffer[KBUFFER_SIZE]; /**< Ring buffer.                */
 		struct process *chain;              /**< Sleeping chain.             */
+		struct pollwait *polls;             /**< Polling processes.          */
 	};
 
 	/**
@@ -157,6 +158,7 @@
 		(b).head = 0;       \
 		(b).tail = 0;       \
 		(b).chain = NULL;   \
+		(b).polls = NULL;   \
 	}                       \
 
 	/**
@@ -196,6 +198,13 @@
 	EXTERN void *kmemset(void *, int, size_t);
 	/**@}*/
 
+	/**
+	 * @name Arithmetic Functions
+	 */
+	/**@{*/
+	EXTERN uint64_t kdiv64(uint64_t, uint32_t, uint32_t *);
+	/**@}*/
+
 	/**
 	 * @brief Aligns a value on a boundary.
 	 *
@@ -44,6 +44,7 @@
 	/* User memory layout. */
 	#define USTACK_ADDR 0xc0000000 /* User stack. */
 	#define UHEAP_ADDR  0xa0000000 /* User heap.  */
+	#define UMMAP_ADDR  0x60000000 /* User maps.  */
 
 	/* Kernel memory size: 4 MB. */
 	#define KMEM_SIZE 0x00400000
@@ -51,22 +52,37 @@
 	/* Kernel page pool size: 4 MB. */
 	#define KPOOL_SIZE 0x00400000
 
+	/* Number of kernel pages. */
+	#define NR_KPAGES (KPOOL_SIZE/PAGE_SIZE)
+
 	/* User memory size. */
 	#define UMEM_SIZE (MEMORY_SIZE - KMEM_SIZE - KPOOL_SIZE)
 
 #ifndef _ASM_FILE_
 
+	/* Opaque object cache. */
+	struct kcache;
+
 	/* Forward definitions. */
 	EXTERN int chkmem(const void *, size_t, mode_t);
 	EXTERN int fubyte(const void *);
 	EXTERN int fudword(const void *);
 	EXTERN int crtpgdir(struct process *);
+	EXTERN int shrpgdir(struct process *);
+	EXTERN int unshrpgdir(int);
 	EXTERN int pfault(addr_t);
 	EXTERN int vfault(addr_t);
 	EXTERN void dstrypgdir(struct process *);
 	EXTERN void putkpg(void *);
 	EXTERN void mm_init(void);
 	EXTERN void *getkpg(int);
+	EXTERN struct kcache *kcache_create(const char *, size_t);
+	EXTERN void *kcache_alloc(struct kcache *);
+	EXTERN void kcache_free(struct kcache *, void *);
+	EXTERN void kcache_stats(void);
+	EXTERN void kmalloc_init(void);
+	EXTERN void *kmalloc(size_t);
+	EXTERN void kfree(void *);
 
 #endif /* _ASM_FILE_ */
 
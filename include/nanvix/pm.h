@@ -65,16 +65,19 @@
 	 * @name Process flags
 	 */
 	/**@{*/
-	#define PROC_NEW 0 /**< Is the process new?     */
-	#define PROC_SYS 1 /**< Handling a system call? */
+	#define PROC_NEW      0 /**< Is the process new?       */
+	#define PROC_SYS      1 /**< Handling a system call?  */
+	#define PROC_VFORK    2 /**< Borrowing address space? */
+	#define PROC_SYSENTER 3 /**< Entered through sysenter? */
 	/**@}*/
 
 	/**
 	 * @name Process parameters
 	 */
 	/**@{*/
-	#define PROC_QUANTUM 50 /**< Quantum.                  */
-	#define NR_PREGIONS   4 /**< Number of memory regions. */
+	#define PROC_QUANTUM 50              /**< Quantum.                  */
+	#define NR_MMAPS     16              /**< Number of memory maps.    */
+	#define NR_PREGIONS  (4 + NR_MMAPS)  /**< Number of memory regions. */
 	/**@}*/
 
 	/**
@@ -122,6 +125,25 @@
 
 #ifndef _ASM_FILE_
 
+	/**
+	 * @brief Thread group.
+	 *
+	 * @details Threads created with clone() share memory regions, opened
+	 *          files and directories through their thread group. A process
+	 *          that never calls clone() is a thread group on its own.
+	 */
+	struct tgroup
+	{
+		unsigned count;                    /**< Number of threads.         */
+		struct pregion pregs[NR_PREGIONS]; /**< Process memory regions.    */
+		size_t size;                       /**< Process size.              */
+		struct inode *pwd;                 /**< Working directory.         */
+		struct inode *root;                /**< Root directory.            */
+		struct file *ofiles[OPEN_MAX];     /**< Opened files.              */
+		int close;                         /**< Close on exec()?           */
+		mode_t umask;                      /**< User file's creation mask. */
+	};
+
 	/**
 	 * @brief Process.
 	 */
@@ -148,19 +170,13 @@
     	 */
 		/**@{*/
 		struct pde *pgdir;                 /**< Page directory.         */
-		struct pregion pregs[NR_PREGIONS]; /**< Process memory regions. */
-		size_t size;                       /**< Process size.           */
+		struct tgroup *tg;                 /**< Thread group.           */
 		/**@}*/
 
 		/**
 		 * @name File system information
 		 */
 		/**@{*/
-		struct inode *pwd;             /**< Working directory.         */
-		struct inode *root;            /**< Root directory.            */
-		struct file *ofiles[OPEN_MAX]; /**< Opened files.              */
-		int close;                     /**< Close on exec()?           */
-		mode_t umask;                  /**< User file's creation mask. */
 		dev_t tty;                     /**< Associated tty device.     */
 		/**@}*/
 
@@ -168,29 +184,47 @@
 		 * @name General information
 		 */
 		/**@{*/
-		int status;             /**< Exit status.             */
-		int errno;              /**< Error code.              */
-		unsigned nchildren;     /**< Number of children.      */
-		uid_t uid;              /**< User ID.                 */
-		uid_t euid;             /**< Effective user ID.       */
-		uid_t suid;             /**< Saved set-user-ID.       */
-		gid_t gid;              /**< Group ID.                */
-		gid_t egid;             /**< Effective group user ID. */
-		gid_t sgid;             /**< Saved set-group-ID.      */
-    	pid_t pid;              /**< Process ID.              */
-    	struct process *pgrp;   /**< Process group ID.        */
-    	struct process *father; /**< Father process.          */
-		char name[NAME_MAX];    /**< Process name.            */
+		int status;              /**< Exit status.             */
+		int errno;               /**< Error code.              */
+		unsigned nchildren;      /**< Number of children.      */
+		uid_t uid;               /**< User ID.                 */
+		uid_t euid;              /**< Effective user ID.       */
+		uid_t suid;              /**< Saved set-user-ID.       */
+		gid_t gid;               /**< Group ID.                */
+		gid_t egid;              /**< Effective group user ID. */
+		gid_t sgid;              /**< Saved set-group-ID.      */
+    	pid_t pid;               /**< Process ID.              */
+    	struct process *pgrp;    /**< Process group ID.        */
+    	struct process *father;  /**< Father process.          */
+		char name[NAME_MAX];     /**< Process name.            */
+		struct semundo *semundo; /**< Semaphore adjustments.   */
+		int *cleartid;           /**< Cleared on thread exit.  */
+		void *tp;                /**< Thread pointer.          */
+		/**@}*/
+
+		/**
+		 * @name Process tree information
+		 */
+		/**@{*/
+		struct process *children;     /**< First child.               */
+		struct process *next_sibling; /**< Next sibling.              */
+		struct process *prev_sibling; /**< Previous sibling.          */
+		struct process *members;      /**< Process group members.     */
+		struct process *next_member;  /**< Next group member.         */
+		struct process *prev_member;  /**< Previous group member.     */
+		struct process *next_hash;    /**< Next process in PID hash.  */
+		struct process *wchain;       /**< Waiting for children.      */
 		/**@}*/
 
     	/**
     	 * @name Timing information
     	 */
 		/**@{*/
-    	unsigned utime;  /**< User CPU time.                          */
-    	unsigned ktime;  /**< Kernel CPU time.                        */
-		unsigned cutime; /**< User CPU time of terminated children.   */
-		unsigned cktime; /**< Kernel CPU time of terminated children. */
+    	unsigned utime;   /**< User CPU time.                          */
+    	unsigned ktime;   /**< Kernel CPU time.                        */
+		unsigned cutime;  /**< User CPU time of terminated children.   */
+		unsigned cktime;  /**< Kernel CPU time of terminated children. */
+		uint64_t cputime; /**< CPU time (in nanoseconds).              */
 		/**@}*/
 
     	/**
@@ -204,20 +238,70 @@
     	unsigned alarm;          /**< Alarm.                  */
 		struct process *next;    /**< Next process in a list. */
 		struct process **chain;  /**< Sleeping chain.         */
+		unsigned timeout;        /**< Sleep timeout (ticks).  */
+		struct region *futex;    /**< Futex waited on.        */
+		addr_t futex_off;        /**< Offset of that futex.   */
 		int ntickets;			/**< Number of tickets.      */
 		/**@}*/
 	};
 
+	/**
+	 * @brief Maximum number of objects polled at once.
+	 *
+	 * @details A file descriptor may refer to up to two objects, such as
+	 *          the input and output buffers of a terminal.
+	 */
+	#define NR_POLLWAITS (2*OPEN_MAX)
+
+	/**
+	 * @brief Entry in the chain of processes polling an object.
+	 */
+	struct pollwait
+	{
+		struct process *proc;    /**< Polling process.         */
+		struct pollwait **chain; /**< Chain of polled object.  */
+		struct pollwait *next;   /**< Next entry in the chain. */
+	};
+
+	/**
+	 * @brief Objects polled by a process.
+	 */
+	struct polltable
+	{
+		unsigned nwaits;                     /**< Entries in use. */
+		struct pollwait waits[NR_POLLWAITS]; /**< Entries.        */
+	};
+
 	/* Forward definitions. */
 	EXTERN void bury(struct process *);
+	EXTERN void charge(void);
 	EXTERN void die(int);
+	EXTERN void idle(void);
 	EXTERN int issig(void);
+	EXTERN pid_t kthread_create(const char *, void (*)(void *), void *);
+	EXTERN void pgrp_join(struct process *, struct process *);
+	EXTERN void pgrp_leave(struct process *);
 	EXTERN void pm_init(void);
+	EXTERN void proc_adopt(struct process *, struct process *);
+	EXTERN struct process *proc_alloc(void);
+	EXTERN void proc_free(struct process *);
+	EXTERN void proc_hash(struct process *);
+	EXTERN struct process *proc_lookup(pid_t);
+	EXTERN void proc_orphan(struct process *);
+	EXTERN void proc_unhash(struct process *);
 	EXTERN void sched(struct process *);
+	EXTERN int vfrelease(int);
 
 #ifdef __NANVIX_KERNEL__
 
 	EXTERN void sleep(struct process **, int);
+	EXTERN int sleep_until(unsigned);
+	EXTERN void unsleep(struct process *);
+	EXTERN unsigned pollstart(struct polltable *);
+	EXTERN void pollrecord(struct pollwait **);
+	EXTERN void pollsleep(struct polltable *, unsigned);
+	EXTERN void pollstop(struct polltable *, unsigned);
+	EXTERN void pollwakeup(struct pollwait **);
 
 #endif /* __NANVIX_KERNEL__ */
 
@@ -230,10 +314,11 @@
 	 * @name Process memory regions
 	 */
 	/**@{*/
-	#define TEXT(p)  (&p->pregs[0]) /**< Text region.  */
-	#define DATA(p)  (&p->pregs[1]) /**< Data region.  */
-	#define STACK(p) (&p->pregs[2]) /**< Stack region. */
-	#define HEAP(p)  (&p->pregs[3]) /**< Heap region.  */
+	#define TEXT(p)  (&p->tg->pregs[0]) /**< Text region.  */
+	#define DATA(p)  (&p->tg->pregs[1]) /**< Data region.  */
+	#define STACK(p) (&p->tg->pregs[2]) /**< Stack region. */
+	#define HEAP(p)  (&p->tg->pregs[3]) /**< Heap region.  */
+	#define MMAP(p, i) (&p->tg->pregs[4 + (i)]) /**< Memory map region. */
 	/**@}*/
 
 	/**
@@ -253,7 +338,7 @@
 	 *
 	 * @returns True if the process is the session leader, and false otherwise.
 	 */
-	#define IS_LEADER(p) ((p)->pgrp->pid == (p)->pid)
+	#define IS_LEADER(p) ((p)->pgrp == (p))
 
 	/**
 	 * @brief Asserts if a process is valid.
@@ -286,6 +371,7 @@
 	EXTERN struct process *curr_proc;
 	EXTERN struct process *last_proc;
 	EXTERN pid_t next_pid;
+	EXTERN unsigned next_timeout;
 	EXTERN unsigned nprocs;
 
 #endif /* _ASM_FILE */
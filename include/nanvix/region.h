@@ -74,8 +74,13 @@
 	{
 		addr_t start;       /* Starting address.         */
 		struct region *reg; /* Underlying memory region. */
+		int flags;          /* Flags (see below).        */
 	};
 
+	/* Process memory region flags. */
+	#define PREGION_RDONLY 0x01 /* Attached read-only.            */
+	#define PREGION_SHM    0x02 /* Shared memory segment attached. */
+
 	/**
 	 * @brief Returns access permissions to a memory region.
 	 *
@@ -108,6 +113,7 @@
 	EXTERN int editreg(struct region *, uid_t, gid_t, mode_t);
 	EXTERN int growreg(struct process *, struct pregion *, ssize_t);
 	EXTERN int loadreg(struct inode *, struct region *, off_t, size_t);
+	EXTERN int syncreg(struct pregion *);
 	EXTERN void detachreg(struct process *, struct pregion *);
 	EXTERN void freereg(struct region *);
 	EXTERN void initreg(void);
@@ -116,6 +122,7 @@
 	EXTERN struct region *allocreg(mode_t, size_t, int);
 	EXTERN struct region *dupreg(struct region *);
 	EXTERN struct pregion *findreg(struct process *, addr_t);
+	EXTERN struct region *lookupreg(struct inode *, off_t, size_t, mode_t);
 
 #endif /* _ASM_FILE */
 
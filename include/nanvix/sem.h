@@ -0,0 +1,121 @@
+
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NANVIX_SEM_H_
+#define NANVIX_SEM_H_
+
+	#include <nanvix/config.h>
+	#include <nanvix/const.h>
+	#include <sys/ipc.h>
+	#include <sys/types.h>
+
+	/**
+	 * @name Semaphore limits
+	 */
+	/**@{*/
+	#define SEMMSL        32 /**< Semaphores per set.            */
+	#define SEMOPM        32 /**< Operations per semop() call.   */
+	#define SEMVMX     32767 /**< Maximum semaphore value.       */
+	#define NR_SEMUNDO   128 /**< Number of undo entries.        */
+	#define SEM_HASHSIZE  16 /**< Size of the key hash table.    */
+	/**@}*/
+
+	/* Forward definitions. */
+	struct process;
+
+	/**
+	 * @brief Semaphore.
+	 */
+	struct semaphore
+	{
+		unsigned short semval;  /**< Value.                       */
+		unsigned short semncnt; /**< Waiting for value increase.  */
+		unsigned short semzcnt; /**< Waiting for value to be 0.   */
+		pid_t sempid;           /**< Last operating PID.          */
+	};
+
+	/**
+	 * @brief Semaphore set.
+	 *
+	 * @details Sets with a key other than IPC_PRIVATE are chained in a hash
+	 *          table. The sequence number is bumped whenever the set is
+	 *          removed, so that sleepers and undo entries can tell a removed
+	 *          set apart from a new set that reuses the same slot.
+	 */
+	struct semset
+	{
+		key_t key;                /**< Key.                        */
+		unsigned short nsems;     /**< Number of semaphores.       */
+		unsigned seq;             /**< Sequence number.            */
+		struct ipc_perm perm;     /**< Access permissions.         */
+		time_t otime;             /**< Last semop() time.          */
+		time_t ctime;             /**< Last change time.           */
+		struct semaphore *sems;   /**< Semaphores (NULL if free).  */
+		struct process *chain;    /**< Sleeping processes.         */
+		struct semset *next;      /**< Next set in the hash chain. */
+	};
+
+	/**
+	 * @brief Semaphore adjust on exit entry.
+	 */
+	struct semundo
+	{
+		int semid;            /**< Semaphore set ID.         */
+		unsigned seq;         /**< Sequence number of set.   */
+		unsigned short num;   /**< Semaphore number.         */
+		short adj;            /**< Adjustment value.         */
+		struct semundo *next; /**< Next entry of the owner.  */
+	};
+
+	/**
+	 * @brief Asserts if a semaphore set ID is valid.
+	 *
+	 * @param id ID to be checked.
+	 *
+	 * @returns True if @p id refers to a set in use, and false otherwise.
+	 */
+	#define SEM_VALID(id) \
+		(((id) >= 0) && ((id) < SEM_MAX) && (semtab[(id)].sems != NULL))
+
+	/**
+	 * @brief Returns access permissions to a semaphore set.
+	 *
+	 * @param set  Semaphore set to be queried.
+	 * @param mask Permissions to be queried.
+	 *
+	 * @returns True if access is allowed and false otherwise.
+	 */
+	#define accesssem(set, mask)                                    \
+		(permission((set)->perm.mode, (set)->perm.uid,              \
+			(set)->perm.gid, curr_proc, (mask), 0))
+
+	/* Forward definitions. */
+	EXTERN void sem_exit(struct process *);
+	EXTERN void sem_free(struct semset *);
+	EXTERN void sem_hash(struct semset *);
+	EXTERN void sem_init(void);
+	EXTERN struct semset *sem_lookup(key_t);
+	EXTERN void sem_unadj(int, int);
+	EXTERN struct semundo *sem_undo(int, unsigned short);
+
+	/* Forward definitions. */
+	EXTERN struct semset semtab[SEM_MAX];
+
+#endif /* NANVIX_SEM_H_ */
@@ -0,0 +1,60 @@
+
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NANVIX_SHM_H_
+#define NANVIX_SHM_H_
+
+	#include <nanvix/config.h>
+	#include <nanvix/const.h>
+	#include <sys/types.h>
+
+	/* Forward definitions. */
+	struct region;
+
+	/**
+	 * @brief Shared memory segment.
+	 *
+	 * @details A segment holds a reference to its underlying memory region,
+	 *          so the region outlives its last detach until the segment is
+	 *          removed. Attaches are counted by the region itself.
+	 */
+	struct shm
+	{
+		key_t key;          /**< Key.                              */
+		struct region *reg; /**< Underlying region (NULL if free). */
+		size_t size;        /**< Requested size.                   */
+		pid_t cpid;         /**< Creator PID.                      */
+		pid_t lpid;         /**< Last shmat()/shmdt() PID.         */
+	};
+
+	/**
+	 * @brief Asserts if a shared memory segment ID is valid.
+	 *
+	 * @param id ID to be checked.
+	 *
+	 * @returns True if @p id refers to a segment in use, and false otherwise.
+	 */
+	#define SHM_VALID(id) \
+		(((id) >= 0) && ((id) < SHM_MAX) && (shmtab[(id)].reg != NULL))
+
+	/* Forward definitions. */
+	EXTERN struct shm shmtab[SHM_MAX];
+
+#endif /* NANVIX_SHM_H_ */
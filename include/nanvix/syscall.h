@@ -26,13 +26,18 @@
 	#include <sys/times.h>
 	#include <sys/types.h>
 	#include <sys/utsname.h>
+	#include <dirent.h>
 	#include <signal.h>
 	#include <ustat.h>
 	#include <utime.h>
 	#include <sys/sem.h>
+	#include <sys/shm.h>
+	#include <sys/uio.h>
+	#include <poll.h>
+	#include <time.h>
 
 	/* Number of system calls. */
-	#define NR_SYSCALLS 52
+	#define NR_SYSCALLS 74
 
 	/* System call numbers. */
 	#define NR_alarm     0
@@ -87,6 +92,28 @@
  	#define NR_semctl   49
  	#define NR_semop    50
 	#define NR_test	    51
+	#define NR_vfork    52
+	#define NR_mmap     53
+	#define NR_munmap   54
+	#define NR_msync    55
+	#define NR_shmget   56
+	#define NR_shmat    57
+	#define NR_shmdt    58
+	#define NR_shmctl   59
+	#define NR_clock_gettime 60
+	#define NR_nanosleep     61
+	#define NR_futex         62
+	#define NR_semtimedop    63
+	#define NR_clone         64
+	#define NR_thread_exit   65
+	#define NR_getdents      66
+	#define NR_getcwd        67
+	#define NR_copy_file_range 68
+	#define NR_pread         69
+	#define NR_pwrite        70
+	#define NR_readv         71
+	#define NR_writev        72
+	#define NR_poll          73
 
 #ifndef _ASM_FILE_
 
@@ -267,25 +294,199 @@
 	EXTERN int sys_gticks(void);
 
 	/*
-	 * Creates a semaphore
+	 * Gets a semaphore set.
 	 */
-	EXTERN int sys_semget(int key);
+	EXTERN int sys_semget(key_t key, int nsems, int semflg);
 
 	/*
-	 * Controls a semaphore
+	 * Arguments of semctl(), which do not fit in registers.
 	 */
-	EXTERN int sys_semctl(int semid, int cmd, int val);
+	struct semctl_args
+	{
+		int semid;  /* Semaphore set ID.  */
+		int semnum; /* Semaphore number.  */
+		int cmd;    /* Control command.   */
+		union
+		{
+			int val;               /* Semaphore value.  */
+			struct semid_ds *buf;  /* Set information.  */
+			unsigned short *array; /* Semaphore values. */
+		} arg;
+	};
 
-	/* 
-	 Performs semaphore operations
+	/*
+	 * Performs control operations on a semaphore set.
+	 */
+	EXTERN int sys_semctl(const struct semctl_args *args);
+
+	/*
+	 * Performs operations on a semaphore set.
 	 */
-	EXTERN int sys_semop(int semid, int op);
+	EXTERN int sys_semop(int semid, struct sembuf *sops, size_t nsops);
 
 	/*
 	 * Test syscall
 	 */
 	EXTERN int sys_test(void);
 
+	/*
+	 * Creates a new process sharing the address space of the caller.
+	 */
+	EXTERN pid_t sys_vfork(void);
+
+	/*
+	 * Arguments of mmap(), which do not fit in registers.
+	 */
+	struct mmap_args
+	{
+		void *addr; /* Address hint.      */
+		size_t len; /* Mapping length.    */
+		int prot;   /* Protection.        */
+		int flags;  /* Mapping flags.     */
+		int fd;     /* File descriptor.   */
+		off_t off;  /* File offset.       */
+	};
+
+	/*
+	 * Maps pages of memory.
+	 */
+	EXTERN void *sys_mmap(const struct mmap_args *args);
+
+	/*
+	 * Unmaps pages of memory.
+	 */
+	EXTERN int sys_munmap(void *addr, size_t len);
+
+	/*
+	 * Synchronizes memory with physical storage.
+	 */
+	EXTERN int sys_msync(void *addr, size_t len, int flags);
+
+	/*
+	 * Gets a shared memory segment.
+	 */
+	EXTERN int sys_shmget(key_t key, size_t size, int shmflg);
+
+	/*
+	 * Attaches a shared memory segment.
+	 */
+	EXTERN void *sys_shmat(int shmid, const void *shmaddr, int shmflg);
+
+	/*
+	 * Detaches a shared memory segment.
+	 */
+	EXTERN int sys_shmdt(const void *shmaddr);
+
+	/*
+	 * Performs control operations on a shared memory segment.
+	 */
+	EXTERN int sys_shmctl(int shmid, int cmd, struct shmid_ds *buf);
+
+	/*
+	 * Gets the time of a clock.
+	 */
+	EXTERN int sys_clock_gettime(clockid_t clock_id, struct timespec *tp);
+
+	/*
+	 * Suspends execution for an interval of time.
+	 */
+	EXTERN int sys_nanosleep(const struct timespec *rqtp, struct timespec *rmtp);
+
+	/*
+	 * Fast user-space locking.
+	 */
+	EXTERN int sys_futex(int *uaddr, int op, int val);
+
+	/*
+	 * Arguments of semtimedop(), which do not fit in registers.
+	 */
+	struct semtimedop_args
+	{
+		int semid;                      /* Semaphore set ID.     */
+		struct sembuf *sops;            /* Operations.           */
+		size_t nsops;                   /* Number of operations. */
+		const struct timespec *timeout; /* Timeout.              */
+	};
+
+	/*
+	 * Performs operations on a semaphore set with a timeout.
+	 */
+	EXTERN int sys_semtimedop(const struct semtimedop_args *args);
+
+	/*
+	 * Creates a thread.
+	 */
+	EXTERN pid_t sys_clone(void *stack, int *ctid, void *tp);
+
+	/*
+	 * Terminates the calling thread.
+	 */
+	EXTERN void sys_thread_exit(int status);
+
+	/*
+	 * Reads directory entries.
+	 */
+	EXTERN ssize_t sys_getdents(int fd, struct dirent *buf, size_t n);
+
+	/*
+	 * Gets the path name of the current working directory.
+	 */
+	EXTERN int sys_getcwd(char *buf, size_t size);
+
+	/*
+	 * Arguments of copy_file_range(), which do not fit in registers.
+	 */
+	struct copy_file_range_args
+	{
+		int fd_in;      /* Source file descriptor. */
+		off_t *off_in;  /* Source offset.          */
+		int fd_out;     /* Target file descriptor. */
+		off_t *off_out; /* Target offset.          */
+		size_t len;     /* Number of bytes.        */
+		unsigned flags; /* Flags.                  */
+	};
+
+	/*
+	 * Copies a range of data from one file to another.
+	 */
+	EXTERN ssize_t sys_copy_file_range(const struct copy_file_range_args *args);
+
+	/*
+	 * Arguments of pread() and pwrite(), which do not fit in registers.
+	 */
+	struct pio_args
+	{
+		int fd;    /* File descriptor. */
+		void *buf; /* Buffer.          */
+		size_t n;  /* Number of bytes. */
+		off_t off; /* File offset.     */
+	};
+
+	/*
+	 * Reads from a file at a given offset.
+	 */
+	EXTERN ssize_t sys_pread(const struct pio_args *args);
+
+	/*
+	 * Writes to a file at a given offset.
+	 */
+	EXTERN ssize_t sys_pwrite(const struct pio_args *args);
+
+	/*
+	 * Reads from a file into multiple buffers.
+	 */
+	EXTERN ssize_t sys_readv(int fd, const struct iovec *iov, int iovcnt);
+
+	/*
+	 * Writes to a file from multiple buffers.
+	 */
+	EXTERN ssize_t sys_writev(int fd, const struct iovec *iov, int iovcnt);
+
+	/*
+	 * Waits for some event on a set of file descriptors.
+	 */
+	EXTERN int sys_poll(struct pollfd *fds, nfds_t nfds, int timeout);
+
 #endif /* _ASM_FILE_ */
 
 #endif /* NANVIX_SYSCALL_H_ */
@@ -0,0 +1,77 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna   <pedrohenriquepenna@gmail.com>
+ *              2015-2016 Davidson Francis <davidsondfgl@hotmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NANVIX_VDSO_H_
+#define NANVIX_VDSO_H_
+
+	#include <nanvix/const.h>
+	#include <sys/times.h>
+	#include <sys/types.h>
+	#include <stdint.h>
+
+	/**
+	 * @brief Virtual address of the vDSO data page.
+	 *
+	 * @details The page is mapped read-only in the user address space of
+	 *          every process, between the kernel identity mapping and the
+	 *          user base address.
+	 */
+	#define VDSO_ADDR 0x00400000
+
+	/**
+	 * @brief vDSO data page.
+	 *
+	 * @details The kernel bumps @p seq before and after each update, so
+	 *          readers take a snapshot and retry if @p seq was odd or changed
+	 *          meanwhile.
+	 */
+	struct vdso
+	{
+		unsigned seq;          /**< Update sequence number.               */
+		unsigned hz;           /**< Clock frequency (in hertz).           */
+		unsigned ticks;        /**< Clock ticks since system startup.     */
+		unsigned startup_time; /**< Time at system startup.               */
+		time_t time;           /**< Current time (in seconds).            */
+		pid_t pid;             /**< ID of the running process.            */
+		void *tp;              /**< Thread pointer of the running thread. */
+		struct tms times;      /**< Times of the running process.         */
+		unsigned tsc_shift;    /**< Fraction bits of tsc_mult.            */
+		uint32_t tsc_mult;     /**< TSC to nanoseconds (zero if no TSC).  */
+		uint64_t tsc_base;     /**< TSC at the last clock interrupt.      */
+		uint64_t mono_base;    /**< Monotonic time at tsc_base (in ns).   */
+	};
+
+	/**
+	 * @brief vDSO data page, as seen from user space.
+	 */
+	#define VDSO ((const volatile struct vdso *)VDSO_ADDR)
+
+#ifdef __NANVIX_KERNEL__
+
+	#include <nanvix/pm.h>
+
+	/* Forward definitions. */
+	EXTERN void vdso_init(void);
+	EXTERN void vdso_update(struct process *);
+	EXTERN void vdso_clock(uint32_t, unsigned, uint64_t, uint64_t);
+
+#endif /* __NANVIX_KERNEL__ */
+
+#endif /* NANVIX_VDSO_H_ */
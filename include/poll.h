@@ -0,0 +1,61 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLL_H_
+#define POLL_H_
+#ifndef _ASM_FILE_
+
+	/**
+	 * @name Poll events
+	 */
+	/**@{*/
+	#define POLLIN     0x001 /**< Data other than high-priority may be read. */
+	#define POLLPRI    0x002 /**< High-priority data may be read.            */
+	#define POLLOUT    0x004 /**< Normal data may be written.                */
+	#define POLLERR    0x008 /**< An error has occurred.                     */
+	#define POLLHUP    0x010 /**< Device has been disconnected.              */
+	#define POLLNVAL   0x020 /**< Invalid file descriptor.                   */
+	#define POLLRDNORM 0x040 /**< Normal data may be read.                   */
+	#define POLLRDBAND 0x080 /**< Priority data may be read.                 */
+	#define POLLWRNORM 0x100 /**< Equivalent to POLLOUT.                     */
+	#define POLLWRBAND 0x200 /**< Priority data may be written.              */
+	/**@}*/
+
+	/**
+	 * @brief Number of file descriptors.
+	 */
+	typedef unsigned nfds_t;
+
+	/**
+	 * @brief Polled file descriptor.
+	 */
+	struct pollfd
+	{
+		int fd;        /**< File descriptor.  */
+		short events;  /**< Requested events. */
+		short revents; /**< Returned events.  */
+	};
+
+	/*
+	 * Waits for events on file descriptors.
+	 */
+	extern int poll(struct pollfd fds[], nfds_t nfds, int timeout);
+
+#endif /* _ASM_FILE_ */
+#endif /* POLL_H_ */
@@ -0,0 +1,96 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna   <pedrohenriquepenna@gmail.com>
+ *              2015-2016 Davidson Francis <davidsondfgl@hotmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PTHREAD_H_
+#define PTHREAD_H_
+#ifndef _ASM_FILE_
+
+	/**
+	 * @name Mutex states
+	 */
+	/**@{*/
+	#define MUTEX_UNLOCKED  0 /**< Unlocked.                   */
+	#define MUTEX_LOCKED    1 /**< Locked, no waiters.         */
+	#define MUTEX_CONTENDED 2 /**< Locked, maybe with waiters. */
+	/**@}*/
+
+	/**
+	 * @brief Mutex.
+	 */
+	typedef struct
+	{
+		volatile int lock; /**< Lock word. */
+	} pthread_mutex_t;
+
+	/**
+	 * @brief Condition variable.
+	 */
+	typedef struct
+	{
+		volatile int seq; /**< Number of signals so far. */
+	} pthread_cond_t;
+
+	/**
+	 * @brief Thread.
+	 */
+	typedef struct pthread *pthread_t;
+
+	/**
+	 * @brief Thread attributes (none supported).
+	 */
+	typedef int pthread_attr_t;
+
+	/**
+	 * @brief Mutex attributes (none supported).
+	 */
+	typedef int pthread_mutexattr_t;
+
+	/**
+	 * @brief Condition variable attributes (none supported).
+	 */
+	typedef int pthread_condattr_t;
+
+	/**
+	 * @name Static initializers
+	 */
+	/**@{*/
+	#define PTHREAD_MUTEX_INITIALIZER { MUTEX_UNLOCKED } /**< Mutex.     */
+	#define PTHREAD_COND_INITIALIZER  { 0 }              /**< Condition. */
+	/**@}*/
+
+	/* Forward definitions. */
+	extern int pthread_create(pthread_t *, const pthread_attr_t *,
+		void *(*)(void *), void *);
+	extern void pthread_exit(void *);
+	extern int pthread_join(pthread_t, void **);
+	extern pthread_t pthread_self(void);
+	extern int pthread_mutex_init(pthread_mutex_t *, const pthread_mutexattr_t *);
+	extern int pthread_mutex_destroy(pthread_mutex_t *);
+	extern int pthread_mutex_lock(pthread_mutex_t *);
+	extern int pthread_mutex_trylock(pthread_mutex_t *);
+	extern int pthread_mutex_unlock(pthread_mutex_t *);
+	extern int pthread_cond_init(pthread_cond_t *, const pthread_condattr_t *);
+	extern int pthread_cond_destroy(pthread_cond_t *);
+	extern int pthread_cond_wait(pthread_cond_t *, pthread_mutex_t *);
+	extern int pthread_cond_signal(pthread_cond_t *);
+	extern int pthread_cond_broadcast(pthread_cond_t *);
+
+#endif /* _ASM_FILE_ */
+#endif /* PTHREAD_H_ */
@@ -24,7 +24,7 @@
 	#include <limits.h>
 	#include <stdarg.h>
 
-	/* Standard buffer size. */
+	/* Standard buffer size (file system block size). */
 	#define BUFSIZ 1024
 
 	/* End of file. */
@@ -92,6 +92,12 @@
 	#define feof(stream) \
 		(stream->flags & _IOEOF)
 
+	/*
+	 * Asserts if the error indicator for a stream is set.
+	 */
+	#define ferror(stream) \
+		(stream->flags & _IOERROR)
+
 	/*
 	 * Flushes a file stream.
 	 */
@@ -108,6 +114,11 @@
 	#define fileno(stream) \
 		(stream->fd)
 
+	/*
+	 * Associates a file stream with a file descriptor.
+	 */
+	extern FILE *fdopen(int fd, const char *mode);
+
 	/*
 	 * Writes a formated string to a file.
 	 */
@@ -123,6 +134,17 @@
 	 */
 	extern int fputs(const char *str, FILE *stream);
 
+	/*
+	 * Reads from a file.
+	 */
+	extern size_t fread(void *ptr, size_t size, size_t nitems, FILE *stream);
+
+	/*
+	 * Writes to a file.
+	 */
+	extern size_t fwrite(const void *ptr, size_t size, size_t nitems,
+	                     FILE *stream);
+
 	/* Forward definitions. */
 	extern FILE *fopen(const char *, const char *);
 	extern FILE *freopen(const char *filename, const char *mode, FILE *stream);
@@ -156,6 +156,8 @@
 	extern int mbtowc(wchar_t *restrict, const char *restrict, size_t);
 	extern void qsort(void *, size_t, size_t, int (*)(const void *,
 					  const void *));
+	extern void qsort_r(void *, size_t, size_t, int (*)(const void *,
+					  const void *, void *), void *);
 	extern int rand(void);
 	extern void *realloc(void *, size_t);
 	extern void srand(unsigned);
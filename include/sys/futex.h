@@ -0,0 +1,37 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna   <pedrohenriquepenna@gmail.com>
+ *              2015-2016 Davidson Francis <davidsondfgl@hotmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYS_FUTEX_H_
+#define SYS_FUTEX_H_
+#ifndef _ASM_FILE_
+
+	/**
+	 * @name Futex operations
+	 */
+	/**@{*/
+	#define FUTEX_WAIT 0 /**< Sleep while the futex holds a value. */
+	#define FUTEX_WAKE 1 /**< Wake up processes waiting on a futex. */
+	/**@}*/
+
+	/* Forward definitions. */
+	extern int futex(int *, int, int);
+
+#endif /* _ASM_FILE_ */
+#endif /* SYS_FUTEX_H_ */
@@ -0,0 +1,63 @@
+
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYS_IPC_H_
+#define SYS_IPC_H_
+#ifndef _ASM_FILE_
+
+	#include <sys/types.h>
+
+	/**
+	 * @name Mode bits
+	 */
+	/**@{*/
+	#define IPC_CREAT  0001000 /**< Create entry if key does not exist. */
+	#define IPC_EXCL   0002000 /**< Fail if key exists.                 */
+	#define IPC_NOWAIT 0004000 /**< Error if request must wait.         */
+	/**@}*/
+
+	/**
+	 * @brief Private key.
+	 */
+	#define IPC_PRIVATE 0
+
+	/**
+	 * @name Control commands
+	 */
+	/**@{*/
+	#define IPC_RMID 3 /**< Remove identifier. */
+	#define IPC_SET  4 /**< Set options.       */
+	#define IPC_STAT 5 /**< Get options.       */
+	/**@}*/
+
+	/**
+	 * @brief Interprocess communication access permissions.
+	 */
+	struct ipc_perm
+	{
+		uid_t uid;   /**< Owner's user ID.       */
+		gid_t gid;   /**< Owner's group ID.      */
+		uid_t cuid;  /**< Creator's user ID.     */
+		gid_t cgid;  /**< Creator's group ID.    */
+		mode_t mode; /**< Read/write permission. */
+	};
+
+#endif /* _ASM_FILE_ */
+#endif /* SYS_IPC_H_ */
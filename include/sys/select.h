@@ -0,0 +1,70 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYS_SELECT_H_
+#define SYS_SELECT_H_
+#ifndef _ASM_FILE_
+
+	#include <sys/types.h>
+
+	/**
+	 * @brief Maximum number of file descriptors in a file descriptor set.
+	 */
+	#define FD_SETSIZE 32
+
+	/**
+	 * @brief File descriptor set.
+	 */
+	typedef struct
+	{
+		unsigned fds_bits[(FD_SETSIZE + 31)/32]; /**< Bitmap. */
+	} fd_set;
+
+	/**
+	 * @name File descriptor set operations
+	 */
+	/**@{*/
+	#define FD_ZERO(set) \
+		do { for (unsigned _i = 0; _i < (FD_SETSIZE + 31)/32; _i++) \
+			(set)->fds_bits[_i] = 0; } while (0)
+	#define FD_SET(fd, set) \
+		((set)->fds_bits[(fd)/32] |= (1u << ((fd)%32)))
+	#define FD_CLR(fd, set) \
+		((set)->fds_bits[(fd)/32] &= ~(1u << ((fd)%32)))
+	#define FD_ISSET(fd, set) \
+		(((set)->fds_bits[(fd)/32] & (1u << ((fd)%32))) != 0)
+	/**@}*/
+
+	/**
+	 * @brief Time interval.
+	 */
+	struct timeval
+	{
+		time_t tv_sec; /**< Seconds.      */
+		long tv_usec;  /**< Microseconds. */
+	};
+
+	/*
+	 * Waits for file descriptors to become ready.
+	 */
+	extern int select(int nfds, fd_set *readfds, fd_set *writefds,
+		fd_set *errorfds, struct timeval *timeout);
+
+#endif /* _ASM_FILE_ */
+#endif /* SYS_SELECT_H_ */
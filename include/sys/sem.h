@@ -17,47 +17,59 @@
  * You should have received a copy of the GNU General Public License
  * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
  */
+
+#ifndef SYS_SEM_H_
+#define SYS_SEM_H_
 #ifndef _ASM_FILE_
 
-#include <nanvix/config.h>
-#include <nanvix/const.h>
+	#include <sys/ipc.h>
+	#include <sys/types.h>
+	#include <time.h>
+
+	/**
+	 * @brief Semaphore operation flag.
+	 */
+	#define SEM_UNDO 0010000 /**< Set up adjust on exit entry. */
 
-#ifdef SEM_ENABLED
-#ifndef SEM_H_
-#define SEM_H_
+	/**
+	 * @name Semaphore control commands
+	 */
+	/**@{*/
+	#define GETPID  11 /**< Get last operating PID.       */
+	#define GETVAL  12 /**< Get semval.                   */
+	#define GETALL  13 /**< Get all cases of semval.      */
+	#define GETNCNT 14 /**< Get semncnt.                  */
+	#define GETZCNT 15 /**< Get semzcnt.                  */
+	#define SETVAL  16 /**< Set semval.                   */
+	#define SETALL  17 /**< Set all cases of semval.      */
+	/**@}*/
 
+	/**
+	 * @brief Semaphore set information.
+	 */
+	struct semid_ds
+	{
+		struct ipc_perm sem_perm;  /**< Operation permissions.   */
+		unsigned short sem_nsems;  /**< Number of semaphores.    */
+		time_t sem_otime;          /**< Last semop() time.       */
+		time_t sem_ctime;          /**< Last semctl() time.      */
+	};
 
-/**
- * @brief Command values for semaphores.
- */
-/**@{*/
-#define GETVAL 0   /**< Returns the value of a semaphore. */
-#define SETVAL 1   /**< Sets the value of a semaphore.    */
-#define IPC_RMID 3 /**< Destroys a semaphore.            */
-/**@}*/
-
-/* Forward definitions. */
-extern int semget(unsigned);
-extern int semctl(int, int, int);
-extern int semop(int, int);
- 
-#define SEM_INVALID  0 /**< Invalid semaphore. */
-#define SEM_VALID    1 /**< Valid semaphore.   */
-
-struct sem
-{
-	int valid; /* Whether this entry in the semaphore table is valid (initialized) */
-	int key; /* The name identifying this semaphore	*/
-	int n; /* The semaphore's value. If zero, down() will be blocking */
 	/**
-	* @brief Chain of processes waiting on this semaphore
-	*/
-	struct process *sleep_chain;
-};
+	 * @brief Semaphore operation.
+	 */
+	struct sembuf
+	{
+		unsigned short sem_num; /**< Semaphore number.    */
+		short sem_op;           /**< Semaphore operation. */
+		short sem_flg;          /**< Operation flags.     */
+	};
 
-// Forward definitions
-EXTERN struct sem sems[SEM_MAX];
+	/* Forward definitions. */
+	extern int semctl(int, int, int, ...);
+	extern int semget(key_t, int, int);
+	extern int semop(int, struct sembuf *, size_t);
+	extern int semtimedop(int,struct sembuf *,size_t,const struct timespec *);
 
-#endif /* SEM_H_ */
-#endif /* SEM_ENABLED */
-#endif /* _ASM_FILE_ */
\ No newline at end of file
+#endif /* _ASM_FILE_ */
+#endif /* SYS_SEM_H_ */
@@ -0,0 +1,32 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SENDFILE_H_
+#define SENDFILE_H_
+#ifndef _ASM_FILE_
+
+	#include <sys/types.h>
+
+	/*
+	 * Transfers data between file descriptors.
+	 */
+	extern ssize_t sendfile(int out_fd, int in_fd, off_t *offset, size_t count);
+
+#endif /* _ASM_FILE_ */
+#endif /* SENDFILE_H_ */
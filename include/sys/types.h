@@ -36,6 +36,12 @@
 	/* Used as a general identifier. */
 	typedef int id_t;
 
+	/* Used for interprocess communication keys. */
+	typedef int key_t;
+
+	/* Used for clock ID type in the clock and timer functions. */
+	typedef int clockid_t;
+
 	/* Used for some file attributes. */
 	typedef int gid_t;
 
@@ -77,6 +77,12 @@
 	 */
 	extern int close(int fd);
 
+	/*
+	 * Copies a range of data from one file to another.
+	 */
+	extern ssize_t copy_file_range(int fd_in, off_t *off_in, int fd_out,
+		off_t *off_out, size_t len, unsigned flags);
+
 	/*
 	 * Duplicates an opened file descriptor.
 	 */
@@ -109,6 +115,11 @@
 	 */
 	extern pid_t fork(void);
 
+	/*
+	 * Creates a new process that shares the address space of the caller.
+	 */
+	extern pid_t vfork(void);
+
 	/*
 	 * Gets the pathname of the current working directory.
 	 */
@@ -164,6 +175,16 @@
 	 */
 	extern int pipe(int fildes[2]);
 
+	/*
+	 * Reads from a file at a given offset.
+	 */
+	extern ssize_t pread(int fd, void *buf, size_t n, off_t off);
+
+	/*
+	 * Writes to a file at a given offset.
+	 */
+	extern ssize_t pwrite(int fd, const void *buf, size_t n, off_t off);
+
 	/*
 	 * Reads from a file.
 	 */
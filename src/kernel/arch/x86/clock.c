@@ -17,10 +17,12 @@
  * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <nanvix/clock.h>
 #include <nanvix/const.h>
 #include <nanvix/hal.h>
 #include <nanvix/klib.h>
 #include <nanvix/pm.h>
+#include <nanvix/vdso.h>
 
 /* Clock ticks since system initialization. */
 PUBLIC unsigned ticks = 0;
@@ -28,43 +30,277 @@ PUBLIC unsigned ticks = 0;
 /* Time at system startup. */
 PUBLIC unsigned startup_time = 0;
 
+/* PIT frequency divisor. */
+PRIVATE uint16_t freq_divisor = 0;
+
+/* Ticks covered by the one-shot timer (zero if periodic). */
+PRIVATE unsigned oneshot_ticks = 0;
+
+/* Fraction bits of the TSC to nanoseconds multiplier. */
+#define TSC_SHIFT 22
+
+/* TSC to nanoseconds multiplier (zero if there is no TSC). */
+PRIVATE uint32_t tsc_mult = 0;
+
+/* TSC value at the last clock interrupt. */
+PRIVATE uint64_t tsc_base = 0;
+
+/* Monotonic time at the last clock interrupt (in nanoseconds). */
+PRIVATE uint64_t mono_base = 0;
+
+/* Monotonic clock lock. */
+PRIVATE spinlock_t mono_lock = SPINLOCK_UNLOCKED;
+
+/* Worst delay in serving a periodic clock interrupt (in nanoseconds). */
+PUBLIC unsigned clock_latency = 0;
+
+/* Was the timer periodic since the last clock interrupt? */
+PRIVATE int periodic = 0;
+
+/*
+ * Converts TSC cycles to nanoseconds.
+ */
+#define TSC_TO_NS(c) (((c)*tsc_mult) >> TSC_SHIFT)
+
+/*
+ * Calibrates the TSC against PIT channel 2.
+ */
+PRIVATE void tsc_calibrate(void)
+{
+	uint16_t count;     /* PIT counts.            */
+	uint64_t t0, t1;    /* TSC samples.           */
+	uint64_t period;    /* Sampling period (ns).  */
+	byte_t gate;        /* Channel 2 gate.        */
+
+	/* No time-stamp counter. */
+	if (!cpu_has_tsc())
+	{
+		kprintf("dev: no time-stamp counter found");
+		return;
+	}
+
+	/* Sample for 10 ms. */
+	count = PIT_FREQUENCY/100;
+	period = kdiv64((uint64_t)count*1000000000, PIT_FREQUENCY, NULL);
+
+	/* Enable channel 2 gate, keeping the speaker quiet. */
+	gate = inputb(PIT_GATE);
+	outputb(PIT_GATE, (gate & ~PIT_SPEAKER) | PIT_GATE_ON);
+
+	outputb(PIT_CTRL, PIT_CH2_ONESHOT);
+	outputb(PIT_CH2, (byte_t)(count & 0xff));
+	outputb(PIT_CH2, (byte_t)((count >> 8)));
+
+	t0 = rdtsc();
+	while (!(inputb(PIT_GATE) & PIT_CH2_OUT))
+		noop();
+	t1 = rdtsc();
+
+	outputb(PIT_GATE, gate);
+
+	/* Broken time-stamp counter. */
+	if ((t1 <= t0) || ((t1 - t0) >> 32))
+	{
+		kprintf("dev: failed to calibrate time-stamp counter");
+		return;
+	}
+
+	tsc_mult = (uint32_t)kdiv64(period << TSC_SHIFT, (uint32_t)(t1 - t0), NULL);
+	tsc_base = rdtsc();
+
+	kprintf("dev: time-stamp counter at %d kHz", (uint32_t)(t1 - t0)/10);
+}
+
+/*
+ * Advances the monotonic clock base to now, and returns how much it has
+ * advanced (zero if there is no TSC).
+ */
+PRIVATE uint64_t clock_rebase(void)
+{
+	uint64_t now;
+	uint64_t elapsed;
+	unsigned flags;
+
+	flags = spin_lock_irqsave(&mono_lock);
+
+	elapsed = 0;
+	if (tsc_mult > 0)
+	{
+		now = rdtsc();
+		elapsed = TSC_TO_NS(now - tsc_base);
+		mono_base += elapsed;
+		tsc_base = now;
+	}
+	else
+		mono_base = (uint64_t)ticks*NSEC_PER_TICK;
+
+	vdso_clock(tsc_mult, TSC_SHIFT, tsc_base, mono_base);
+
+	spin_unlock_irqrestore(&mono_lock, flags);
+
+	return (elapsed);
+}
+
+/*
+ * Returns the monotonic time in nanoseconds.
+ */
+PUBLIC uint64_t clock_ns(void)
+{
+	uint64_t ns;
+	unsigned flags;
+
+	flags = spin_lock_irqsave(&mono_lock);
+
+	ns = mono_base;
+	if (tsc_mult > 0)
+		ns += TSC_TO_NS(rdtsc() - tsc_base);
+
+	spin_unlock_irqrestore(&mono_lock, flags);
+
+	return (ns);
+}
+
+/*
+ * Programs the PIT.
+ */
+PRIVATE void pit_program(byte_t mode, uint16_t count)
+{
+	/* Send control byte: adjust frequency divisor. */
+	outputb(PIT_CTRL, mode);
+
+	/* Send data byte: divisor_low and divisor_high. */
+	outputb(PIT_DATA, (byte_t)(count & 0xff));
+	outputb(PIT_DATA, (byte_t)((count >> 8)));
+}
+
+/*
+ * Accounts ticks elapsed while the clock was sleeping.
+ */
+PRIVATE void clock_account(unsigned n)
+{
+	ticks += n;
+	curr_proc->ktime += n;
+	vdso_update(curr_proc);
+}
+
 /*
  * Handles a timer interrupt.
  */
 PRIVATE void do_clock()
 {
+	uint64_t elapsed;
+
+	elapsed = clock_rebase();
+
+	/* One-shot timer expired. */
+	if (oneshot_ticks > 0)
+	{
+		clock_account(oneshot_ticks);
+		oneshot_ticks = 0;
+		pit_program(PIT_PERIODIC, freq_divisor);
+		periodic = 0;
+		return;
+	}
+
+	/* Track how late this interrupt was served. */
+	if ((periodic) && (elapsed > NSEC_PER_TICK))
+	{
+		if (elapsed - NSEC_PER_TICK > clock_latency)
+			clock_latency = elapsed - NSEC_PER_TICK;
+	}
+	periodic = 1;
+
 	ticks++;
 
 	if (KERNEL_RUNNING(curr_proc))
 	{
 		curr_proc->ktime++;
+		vdso_update(curr_proc);
 		return;
 	}
 
 	curr_proc->utime++;
+	vdso_update(curr_proc);
 
-	/* Give up processor time. */
-	if (--curr_proc->counter == 0)
+	/*
+	 * Give up processor time, either because the
+	 * quantum is over or because a sleep timeout
+	 * has expired. Otherwise, sleepers would only
+	 * be woken up at the end of the quantum.
+	 */
+	if ((--curr_proc->counter == 0) || ((next_timeout) && (next_timeout <= ticks)))
 		yield();
 }
 
+/*
+ * Stops the periodic timer interrupt for a while.
+ *
+ * The PIT is programmed in one-shot mode to fire after nticks ticks, or as
+ * far as its 16-bit counter allows. Interrupts must be disabled.
+ */
+PUBLIC void clock_sleep(unsigned nticks)
+{
+	unsigned max;
+
+	max = PIT_COUNT_MAX/freq_divisor;
+
+	if ((nticks == 0) || (nticks > max))
+		nticks = max;
+
+	/* Not worth it. */
+	if (nticks <= 1)
+		return;
+
+	oneshot_ticks = nticks;
+	pit_program(PIT_ONESHOT, nticks*freq_divisor);
+}
+
+/*
+ * Restarts the periodic timer interrupt.
+ *
+ * If the processor was woken up by some other interrupt, the ticks that
+ * have elapsed so far are accounted. Interrupts must be disabled.
+ */
+PUBLIC void clock_wakeup(void)
+{
+	unsigned elapsed; /* Elapsed counts.   */
+	uint16_t count;   /* Remaining counts. */
+
+	/* Timer interrupt already handled. */
+	if (oneshot_ticks == 0)
+		return;
+
+	/* Timer expired, but its interrupt is still pending. */
+	outputb(PIT_CTRL, PIT_READBACK);
+	if (inputb(PIT_DATA) & PIT_OUT)
+		return;
+
+	/* Read remaining counts. */
+	outputb(PIT_CTRL, PIT_LATCH);
+	count = inputb(PIT_DATA);
+	count |= inputb(PIT_DATA) << 8;
+
+	elapsed = oneshot_ticks*freq_divisor;
+	if (count < elapsed)
+		elapsed -= count;
+	clock_account(elapsed/freq_divisor);
+	oneshot_ticks = 0;
+	pit_program(PIT_PERIODIC, freq_divisor);
+	periodic = 0;
+}
+
 /*
  * Initializes the system's clock.
  */
 PUBLIC void clock_init(unsigned freq)
 {
-	uint16_t freq_divisor;
-
 	kprintf("dev: initializing clock device driver");
 
 	set_hwint(INT_CLOCK, &do_clock);
 
 	freq_divisor = PIT_FREQUENCY/freq;
 
-	/* Send control byte: adjust frequency divisor. */
-	outputb(PIT_CTRL, 0x36);
+	tsc_calibrate();
 
-	/* Send data byte: divisor_low and divisor_high. */
-	outputb(PIT_DATA, (byte_t)(freq_divisor & 0xff));
-	outputb(PIT_DATA, (byte_t)((freq_divisor >> 8)));
+	pit_program(PIT_PERIODIC, freq_divisor);
 }
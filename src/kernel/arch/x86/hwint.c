@@ -17,9 +17,11 @@
  * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <nanvix/clock.h>
 #include <nanvix/const.h>
 #include <nanvix/hal.h>
 #include <nanvix/klib.h>
+#include <nanvix/pm.h>
 #include <errno.h>
 
 /* Forward definitions. */
@@ -35,6 +37,36 @@ PUBLIC void (*hwint_handlers[])(void) = {
 	&default_hwint, &default_hwint,	&default_hwint, &default_hwint
 };
 
+/**
+ * @brief Scheduled tasklets.
+ */
+PRIVATE struct tasklet *tasklets = NULL;
+
+/**
+ * @brief Tail of scheduled tasklets.
+ */
+PRIVATE struct tasklet **tasklets_tail = &tasklets;
+
+/**
+ * @brief Tasklets lock.
+ */
+PRIVATE spinlock_t tasklets_lock = SPINLOCK_UNLOCKED;
+
+/**
+ * @brief Are tasklets running?
+ */
+PRIVATE int softirq_running = 0;
+
+/**
+ * @brief Longest tasklet run (in nanoseconds).
+ */
+PRIVATE unsigned softirq_max = 0;
+
+/**
+ * @brief Number of tasklet runs.
+ */
+PRIVATE unsigned softirq_count = 0;
+
 /**
  * @brief Default hardware interrupt handler.
  */
@@ -90,3 +122,89 @@ PUBLIC void do_hwint(unsigned irq)
 
 	processor_drop(old_irqlvl);
 }
+
+/**
+ * @brief Schedules a tasklet.
+ *
+ * @details A tasklet that is already scheduled is not scheduled again, so
+ *          it runs once for any number of calls made before it runs.
+ *
+ * @param t Target tasklet.
+ */
+PUBLIC void tasklet_schedule(struct tasklet *t)
+{
+	unsigned flags;
+
+	flags = spin_lock_irqsave(&tasklets_lock);
+
+	if (!t->pending)
+	{
+		t->pending = 1;
+		t->next = NULL;
+		*tasklets_tail = t;
+		tasklets_tail = &t->next;
+	}
+
+	spin_unlock_irqrestore(&tasklets_lock, flags);
+}
+
+/**
+ * @brief Runs scheduled tasklets.
+ *
+ * @details This is called on the way out of hardware interrupts, and by
+ *          code that schedules tasklets from process context. Nothing is
+ *          done if tasklets are already running, or if some interrupt
+ *          handler was interrupted, since that handler will get here later.
+ *          Tasklets run with interrupts enabled, and the interrupt state of
+ *          the caller is restored on return.
+ */
+PUBLIC void do_softirq(void)
+{
+	unsigned flags;    /* Interrupt state. */
+	struct tasklet *t; /* Working tasklet. */
+	uint64_t t0, t1;   /* Samples.         */
+
+	flags = spin_lock_irqsave(&tasklets_lock);
+
+	/* Nothing to be done. */
+	if ((softirq_running) || (curr_proc->irqlvl != INT_LVL_5))
+	{
+		spin_unlock_irqrestore(&tasklets_lock, flags);
+		return;
+	}
+
+	softirq_running = 1;
+
+	while ((t = tasklets) != NULL)
+	{
+		if ((tasklets = t->next) == NULL)
+			tasklets_tail = &tasklets;
+		t->pending = 0;
+
+		spin_unlock(&tasklets_lock);
+		enable_interrupts();
+
+		t0 = clock_ns();
+		t->func(t->arg);
+		t1 = clock_ns();
+
+		spin_lock(&tasklets_lock);
+
+		softirq_count++;
+		if (t1 - t0 > softirq_max)
+			softirq_max = t1 - t0;
+	}
+
+	softirq_running = 0;
+
+	spin_unlock_irqrestore(&tasklets_lock, flags);
+}
+
+/**
+ * @brief Prints interrupt handling statistics.
+ */
+PUBLIC void hwint_stats(void)
+{
+	kprintf("clock interrupt latency: %d ns max", clock_latency);
+	kprintf("tasklets: %d runs, %d ns max", softirq_count, softirq_max);
+}
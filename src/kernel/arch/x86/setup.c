@@ -36,6 +36,10 @@ PRIVATE struct idtptr idtptr; /* Interrupt descriptor table pointer. */
 /* Task state segment. */
 PUBLIC struct tss tss;
 
+/* Stack loaded by sysenter. */
+#define SYSENTER_STACK_SIZE 16
+PRIVATE dword_t sysenter_stack[SYSENTER_STACK_SIZE];
+
 /*
  * Sets a GDT entry.
  */
@@ -191,6 +195,30 @@ PRIVATE void idt_setup(void)
     idt_flush(&idtptr);
 }
 
+/*
+ * Sets up the fast system call entry.
+ */
+PRIVATE void sysenter_setup(void)
+{
+	/* Not supported. */
+	if (!cpu_has_sep())
+	{
+		kprintf("kernel: sysenter not supported");
+		return;
+	}
+
+	/*
+	 * The entry point switches to the kernel stack
+	 * of the running process on its own, so the stack
+	 * loaded by the processor is never used.
+	 */
+	msr_write(MSR_SYSENTER_CS, KERNEL_CS);
+	msr_write(MSR_SYSENTER_ESP, (unsigned)&sysenter_stack[SYSENTER_STACK_SIZE]);
+	msr_write(MSR_SYSENTER_EIP, (unsigned)sysenter);
+
+	kprintf("kernel: sysenter at %x", sysenter);
+}
+
 /*
  * Sets up machine.
  */
@@ -202,4 +230,5 @@ PUBLIC void setup(void)
 	tss_setup();
     kprintf("boot: loading interrupt descriptor table");
 	idt_setup();
+	sysenter_setup();
 }
@@ -0,0 +1,319 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <i386/i386.h>
+#include <nanvix/const.h>
+#include <nanvix/hal.h>
+#include <nanvix/klib.h>
+#include <nanvix/mm.h>
+#include <stdint.h>
+
+/**
+ * @brief Maximum number of processors that are recorded.
+ */
+#define NR_CPUS 8
+
+/**
+ * @name MP configuration table entry types
+ */
+/**@{*/
+#define MP_PROC   0 /**< Processor.                  */
+#define MP_BUS    1 /**< Bus.                        */
+#define MP_IOAPIC 2 /**< I/O APIC.                   */
+#define MP_IOINTR 3 /**< I/O interrupt assignment.   */
+#define MP_LINTR  4 /**< Local interrupt assignment. */
+/**@}*/
+
+/**
+ * @name MP processor flags
+ */
+/**@{*/
+#define MP_PROC_ENABLED 0x01 /**< Processor is enabled.      */
+#define MP_PROC_BSP     0x02 /**< Bootstrap processor.       */
+/**@}*/
+
+/**
+ * @brief MP floating pointer structure.
+ */
+struct mpfp
+{
+	char signature[4];  /**< "_MP_".                   */
+	uint32_t physaddr;  /**< Configuration table.      */
+	uint8_t length;     /**< Length in 16-byte units.  */
+	uint8_t revision;   /**< Specification revision.   */
+	uint8_t checksum;   /**< All bytes add up to zero. */
+	uint8_t type;       /**< Default configuration.    */
+	uint8_t feature[4]; /**< Feature flags.            */
+} __attribute__((packed));
+
+/**
+ * @brief MP configuration table header.
+ */
+struct mpconf
+{
+	char signature[4];    /**< "PCMP".                   */
+	uint16_t length;      /**< Base table length.        */
+	uint8_t revision;     /**< Specification revision.   */
+	uint8_t checksum;     /**< All bytes add up to zero. */
+	char oem[8];          /**< OEM ID.                   */
+	char product[12];     /**< Product ID.               */
+	uint32_t oemtable;    /**< OEM table pointer.        */
+	uint16_t oemlength;   /**< OEM table size.           */
+	uint16_t entries;     /**< Number of entries.        */
+	uint32_t lapicaddr;   /**< Local APIC address.       */
+	uint16_t xlength;     /**< Extended table length.    */
+	uint8_t xchecksum;    /**< Extended table checksum.  */
+	uint8_t reserved;     /**< Reserved.                 */
+} __attribute__((packed));
+
+/**
+ * @brief MP processor entry.
+ */
+struct mpproc
+{
+	uint8_t type;         /**< Entry type (MP_PROC).     */
+	uint8_t apicid;       /**< Local APIC ID.            */
+	uint8_t version;      /**< Local APIC version.       */
+	uint8_t flags;        /**< Processor flags.          */
+	uint32_t signature;   /**< Processor signature.      */
+	uint32_t features;    /**< Feature flags.            */
+	uint8_t reserved[8];  /**< Reserved.                 */
+} __attribute__((packed));
+
+/**
+ * @brief MP I/O APIC entry.
+ */
+struct mpioapic
+{
+	uint8_t type;         /**< Entry type (MP_IOAPIC).   */
+	uint8_t apicid;       /**< I/O APIC ID.              */
+	uint8_t version;      /**< I/O APIC version.         */
+	uint8_t flags;        /**< I/O APIC flags.           */
+	uint32_t addr;        /**< I/O APIC address.         */
+} __attribute__((packed));
+
+/**
+ * @brief Number of processors in the system.
+ */
+PUBLIC unsigned ncpus = 1;
+
+/**
+ * @brief Local APIC IDs of processors.
+ */
+PRIVATE uint8_t cpu_apicids[NR_CPUS];
+
+/**
+ * @brief Local APIC ID of the bootstrap processor.
+ */
+PRIVATE uint8_t bsp_apicid = 0;
+
+/**
+ * @brief Physical address of local APICs.
+ */
+PRIVATE addr_t lapic_addr = 0;
+
+/**
+ * @brief Physical address of the I/O APIC.
+ */
+PRIVATE addr_t ioapic_addr = 0;
+
+/**
+ * @brief Converts a physical address in low memory to a kernel address.
+ *
+ * @param addr Physical address.
+ * @param size Size of the object.
+ *
+ * @returns The kernel address of @p addr, or NULL if it is not mapped.
+ */
+PRIVATE void *mp_phys(addr_t addr, size_t size)
+{
+	if ((addr >= KMEM_SIZE) || (size > KMEM_SIZE - addr))
+		return (NULL);
+
+	return ((void *)(KBASE_VIRT + addr));
+}
+
+/**
+ * @brief Sums up the bytes of a memory area.
+ *
+ * @param addr Start address.
+ * @param size Size of the memory area.
+ *
+ * @returns The byte sum of the memory area.
+ */
+PRIVATE uint8_t mp_sum(const void *addr, size_t size)
+{
+	uint8_t sum = 0;
+	const uint8_t *p = addr;
+
+	while (size-- > 0)
+		sum += *p++;
+
+	return (sum);
+}
+
+/**
+ * @brief Searches for an MP floating pointer structure.
+ *
+ * @param addr Physical address where the search shall start.
+ * @param size Number of bytes to search.
+ *
+ * @returns A pointer to the MP floating pointer structure, or NULL if it is
+ *          not found.
+ */
+PRIVATE struct mpfp *mp_search(addr_t addr, size_t size)
+{
+	struct mpfp *mp;  /* Working structure. */
+	struct mpfp *end; /* End of search.     */
+
+	if ((mp = mp_phys(addr, size)) == NULL)
+		return (NULL);
+
+	for (end = mp + size/sizeof(struct mpfp); mp < end; mp++)
+	{
+		if (kstrncmp(mp->signature, "_MP_", 4))
+			continue;
+
+		/* Found. */
+		if (mp_sum(mp, sizeof(struct mpfp)) == 0)
+			return (mp);
+	}
+
+	return (NULL);
+}
+
+/**
+ * @brief Locates the MP floating pointer structure.
+ *
+ * @details The structure lives in the first kilobyte of the extended BIOS
+ *          data area, in the last kilobyte of base memory, or in the BIOS
+ *          ROM between 0xf0000 and 0xfffff.
+ *
+ * @returns A pointer to the MP floating pointer structure, or NULL if it is
+ *          not found.
+ */
+PRIVATE struct mpfp *mp_find(void)
+{
+	addr_t addr;     /* Search address. */
+	struct mpfp *mp; /* MP structure.   */
+	uint8_t *bda;    /* BIOS data area. */
+
+	bda = mp_phys(0x400, 0x100);
+
+	/* Extended BIOS data area. */
+	if ((addr = ((bda[0x0f] << 8) | bda[0x0e]) << 4) != 0)
+	{
+		if ((mp = mp_search(addr, 1024)) != NULL)
+			return (mp);
+	}
+
+	/* Last kilobyte of base memory. */
+	else
+	{
+		addr = ((bda[0x14] << 8) | bda[0x13])*1024;
+		if ((mp = mp_search(addr - 1024, 1024)) != NULL)
+			return (mp);
+	}
+
+	return (mp_search(0xf0000, 0x10000));
+}
+
+/**
+ * @brief Discovers processors in the system.
+ *
+ * @details Parses the Intel MultiProcessor configuration table and records
+ *          the processors and the I/O APIC that are described there.
+ *          Application processors are left halted.
+ */
+PUBLIC void smp_init(void)
+{
+	uint8_t *p;           /* Working entry.       */
+	uint8_t *end;         /* Last entry.          */
+	struct mpfp *mp;      /* Floating pointer.    */
+	struct mpconf *conf;  /* Configuration table. */
+	struct mpproc *proc;  /* Processor entry.     */
+	unsigned n;           /* Processors found.    */
+
+	/* No MP configuration. */
+	if ((mp = mp_find()) == NULL)
+		goto uniprocessor;
+
+	/* Default configurations are not supported. */
+	if ((mp->physaddr == 0) || (mp->type != 0))
+		goto uniprocessor;
+
+	conf = mp_phys(mp->physaddr, sizeof(struct mpconf));
+
+	/* Bad configuration table. */
+	if ((conf == NULL) || (kstrncmp(conf->signature, "PCMP", 4)))
+		goto uniprocessor;
+	if (mp_phys(mp->physaddr, conf->length) == NULL)
+		goto uniprocessor;
+	if (mp_sum(conf, conf->length) != 0)
+		goto uniprocessor;
+
+	lapic_addr = conf->lapicaddr;
+
+	/* Parse configuration table entries. */
+	n = 0;
+	end = (uint8_t *)conf + conf->length;
+	for (p = (uint8_t *)(conf + 1); p < end; /* noop */)
+	{
+		switch (*p)
+		{
+			case MP_PROC:
+				proc = (struct mpproc *)p;
+				if (proc->flags & MP_PROC_BSP)
+					bsp_apicid = proc->apicid;
+				if ((proc->flags & MP_PROC_ENABLED) && (n < NR_CPUS))
+					cpu_apicids[n++] = proc->apicid;
+				p += sizeof(struct mpproc);
+				break;
+
+			case MP_IOAPIC:
+				if (ioapic_addr == 0)
+					ioapic_addr = ((struct mpioapic *)p)->addr;
+				p += sizeof(struct mpioapic);
+				break;
+
+			case MP_BUS:
+			case MP_IOINTR:
+			case MP_LINTR:
+				p += 8;
+				break;
+
+			/* Unknown entry. */
+			default:
+				goto uniprocessor;
+		}
+	}
+
+	if (n > 0)
+		ncpus = n;
+
+	kprintf("smp: %d processors found, lapic at %x, ioapic at %x",
+		ncpus, lapic_addr, ioapic_addr);
+	kprintf("smp: running on processor with apic id %d only", bsp_apicid);
+
+	return;
+
+uniprocessor:
+	ncpus = 1;
+	kprintf("smp: no multiprocessor configuration found");
+}
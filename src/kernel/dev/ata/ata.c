@@ -171,8 +171,9 @@ struct ata_info
 #define ATADEV_QUEUE_SIZE 64
 
 /* ATA device flags. */
-#define ATADEV_VALID   (1 << 0) /* Valid device?     */
-#define ATADEV_DISCARD (1 << 1) /* Discard next IRQ? */
+#define ATADEV_VALID   (1 << 0) /* Valid device?         */
+#define ATADEV_DISCARD (1 << 1) /* Discard next IRQ?     */
+#define ATADEV_START   (1 << 2) /* Start queue handling? */
 
 /* Request flags. */
 #define REQ_WRITE (1 << 0) /* Write request?         */
@@ -210,9 +211,12 @@ struct request
 PRIVATE struct atadev
 {
 	/* General information. */
-	int flags;             /* Flags (see above).                         */
-	struct ata_info info;  /* Device information.                        */
-	struct process *chain; /* Process waiting for operation to complete. */
+	int flags;               /* Flags (see above).                         */
+	struct ata_info info;    /* Device information.                        */
+	struct process *chain;   /* Process waiting for operation to complete. */
+	spinlock_t lock;         /* Device lock.                               */
+	struct tasklet tasklet;  /* Deferred interrupt handler.                */
+	unsigned nirqs;          /* IRQs not yet handled.                      */
 
 	/* Block operation queue. */
 	struct
@@ -220,6 +224,8 @@ PRIVATE struct atadev
 		int size;                                   /* Current size.         */
 		int head;                                   /* Head.                 */
 		int tail;                                   /* Tail.                 */
+		unsigned nissued;                           /* Requests so far.      */
+		unsigned ndone;                             /* Completed requests.   */
 		struct request requests[ATADEV_QUEUE_SIZE]; /* Blocks.               */
 		struct process *chain;                      /* Processes wanting for *
 		                                             * a slot in the queue.  */
@@ -236,6 +242,9 @@ PRIVATE uint16_t pio_ports[2][9] = {
 	{ 0x170, 0x171, 0x172, 0x173, 0x174, 0x175, 0x176, 0x177, 0x376 }
 };
 
+/* Forward definitions. */
+PRIVATE void ata_tasklet(void *);
+
 /*============================================================================*
  *                            Low-Level Routines                              *
  *============================================================================*/
@@ -352,6 +361,9 @@ PRIVATE int pata_setup(int atadevid)
 		devinfo->flags |= ATADEV_DMA;
 
 	dev->flags = ATADEV_VALID | ATADEV_DISCARD;
+	dev->tasklet.func = ata_tasklet;
+	dev->tasklet.arg = dev;
+	dev->nirqs = 0;
 	dev->queue.chain = NULL;
 	dev->queue.size = 0;
 	dev->queue.head = 0;
@@ -561,14 +573,20 @@ PRIVATE void ata_sched(unsigned atadevid, unsigned flags, ...)
 	struct atadev *dev;  /* ATA device.        */
 	buffer_t buf;        /* Buffer.            */
 	struct request *req; /* Request.           */
+	unsigned state;      /* Interrupt state.   */
+	unsigned ticket;     /* Request number.    */
 
 	dev = &ata_devices[atadevid];
 
-	disable_interrupts();
+	state = spin_lock_irqsave(&dev->lock);
 
 		/* Wait for a slot in the block operation queue. */
 		while (dev->queue.size == ATADEV_QUEUE_SIZE)
+		{
+			spin_unlock(&dev->lock);
 			sleep(&dev->queue.chain, PRIO_IO);
+			spin_lock(&dev->lock);
+		}
 
 		req = &dev->queue.requests[dev->queue.tail];
 
@@ -599,6 +617,7 @@ PRIVATE void ata_sched(unsigned atadevid, unsigned flags, ...)
 		/* Enqueue request. */
 		dev->queue.tail = (dev->queue.tail + 1)%ATADEV_QUEUE_SIZE;
 		dev->queue.size++;
+		ticket = ++dev->queue.nissued;
 
 		/*
 		 * The queue was empty, therefore,
@@ -606,17 +625,29 @@ PRIVATE void ata_sched(unsigned atadevid, unsigned flags, ...)
 		 */
 		if (dev->queue.size == 1)
 		{
-			if (flags & REQ_WRITE)
-				ata_write_op(atadevid, req);
-			else
-				ata_read_op(atadevid, req);
+			dev->flags |= ATADEV_START;
+			tasklet_schedule(&dev->tasklet);
 		}
 
-		/* Wait operation to complete. */
-		if (req->flags & REQ_SYNC)
+	spin_unlock_irqrestore(&dev->lock, state);
+
+	/* Issue the request with interrupts enabled. */
+	do_softirq();
+
+	/* Wait operation to complete. */
+	if (flags & REQ_SYNC)
+	{
+		state = spin_lock_irqsave(&dev->lock);
+
+		while ((int)(dev->queue.ndone - ticket) < 0)
+		{
+			spin_unlock(&dev->lock);
 			sleep(&dev->chain, PRIO_IO);
-		
-	enable_interrupts();
+			spin_lock(&dev->lock);
+		}
+
+		spin_unlock_irqrestore(&dev->lock, state);
+	}
 }
 
 /*
@@ -851,9 +882,32 @@ PRIVATE const struct bdev ata_ops = {
 };
 
 /*
- * Generic ATA interrupt handler.
+ * Issues the request at the head of the block operation queue.
  */
-PRIVATE void ata_handler(int atadevid)
+PRIVATE void ata_start(int atadevid)
+{
+	struct atadev *dev;  /* ATA device. */
+	struct request *req; /* Request.    */
+
+	dev = &ata_devices[atadevid];
+
+	/* Nothing to be done. */
+	if (dev->queue.size == 0)
+		return;
+
+	req = &dev->queue.requests[dev->queue.head];
+
+	if (req->flags & REQ_WRITE)
+		ata_write_op(atadevid, req);
+	else
+		ata_read_op(atadevid, req);
+}
+
+/*
+ * Completes the request at the head of the block operation queue, and
+ * issues the next one.
+ */
+PRIVATE void ata_done(int atadevid)
 {
 	int bus;             /* Bus number.    */
 	size_t i;            /* Loop index.    */
@@ -866,16 +920,6 @@ PRIVATE void ata_handler(int atadevid)
 	bus = ata_bus(atadevid);
 	dev = &ata_devices[atadevid];
 
-	/*
-	 * That's weird! A non valid device
-	 * is firing an IRQ. Let's just ignore it so.
-	 */
-	if (!(dev->flags & ATADEV_VALID))
-	{
-		kprintf("ATA: non valid device %d fired an IRQ", atadevid);
-		return;
-	}
-
 	/* We don't need to handle this IRQ. */
 	if (dev->flags & ATADEV_DISCARD)
 	{
@@ -937,22 +981,17 @@ PRIVATE void ata_handler(int atadevid)
 			word = inputw(pio_ports[bus][ATA_REG_DATA]);
 			buf[i] = word & 0xff;
 			buf[i + 1] = (word >> 8) & 0xff;
-			if(!(req->flags & REQ_SYNC)) {
-				buffer_valid_and_clean(req->u.buffered.buf);	
-			} 
 		}
+
+		/* Release read ahead buffer. */
+		if (!(req->flags & REQ_SYNC))
+			buffer_valid_and_clean(req->u.buffered.buf);
 	}
 
-	/* Process next operation. */
-	if (dev->queue.size > 0)
-	{
-		req = &dev->queue.requests[dev->queue.head];
+	dev->queue.ndone++;
 
-		if (req->flags & REQ_WRITE)
-			ata_write_op(atadevid, req);
-		else
-			ata_read_op(atadevid, req);
-	}
+	/* Process next operation. */
+	ata_start(atadevid);
 
 out:
 
@@ -965,12 +1004,83 @@ out:
 	wakeup(&dev->chain);
 }
 
+/*
+ * Generic ATA deferred interrupt handler.
+ *
+ * PIO transfers are done here, with interrupts enabled. Tasklets neither
+ * nest nor get preempted, and ata_sched() touches the queue only with
+ * interrupts disabled, so the queue is only shared with the interrupt
+ * handler, through nirqs.
+ */
+PRIVATE void ata_tasklet(void *arg)
+{
+	int atadevid;       /* ATA device ID.   */
+	struct atadev *dev; /* ATA device.      */
+	unsigned state;     /* Interrupt state. */
+
+	dev = arg;
+	atadevid = dev - ata_devices;
+
+	state = spin_lock_irqsave(&dev->lock);
+
+	while ((dev->nirqs > 0) || (dev->flags & ATADEV_START))
+	{
+		/* Handle IRQ. */
+		if (dev->nirqs > 0)
+		{
+			dev->nirqs--;
+			spin_unlock_irqrestore(&dev->lock, state);
+			ata_done(atadevid);
+		}
+
+		/* Start queue handling. */
+		else
+		{
+			dev->flags &= ~ATADEV_START;
+			spin_unlock_irqrestore(&dev->lock, state);
+			ata_start(atadevid);
+		}
+
+		state = spin_lock_irqsave(&dev->lock);
+	}
+
+	spin_unlock_irqrestore(&dev->lock, state);
+}
+
+/*
+ * Generic ATA interrupt handler.
+ */
+PRIVATE void ata_handler(int atadevid)
+{
+	struct atadev *dev; /* ATA device. */
+
+	dev = &ata_devices[atadevid];
+
+	/*
+	 * That's weird! A non valid device
+	 * is firing an IRQ. Let's just ignore it so.
+	 */
+	if (!(dev->flags & ATADEV_VALID))
+	{
+		kprintf("ATA: non valid device %d fired an IRQ", atadevid);
+		return;
+	}
+
+	/* Defer the actual work. */
+	dev->nirqs++;
+	tasklet_schedule(&dev->tasklet);
+}
+
 /*
  * Primary ATA interrupt handler.
  */
 PRIVATE void ata1_handler(void)
 {
+	unsigned state;
+
+	state = spin_lock_irqsave(&ata_devices[0].lock);
 	ata_handler(0);
+	spin_unlock_irqrestore(&ata_devices[0].lock, state);
 }
 
 /*
@@ -978,7 +1088,11 @@ PRIVATE void ata1_handler(void)
  */
 PRIVATE void ata2_handler(void)
 {
+	unsigned state;
+
+	state = spin_lock_irqsave(&ata_devices[1].lock);
 	ata_handler(1);
+	spin_unlock_irqrestore(&ata_devices[1].lock, state);
 }
 
 /**
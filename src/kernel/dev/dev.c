@@ -28,6 +28,7 @@
 #include <nanvix/clock.h>
 #include <nanvix/pm.h>
 #include <errno.h>
+#include <poll.h>
 
 /*============================================================================*
  *                            Character Devices                               *
@@ -181,6 +182,28 @@ PUBLIC int cdev_close(dev_t dev)
 	return (cdevsw[MAJOR(dev)]->close(MINOR(dev)));
 }
 
+/**
+ * @brief Checks whether a character device is ready for I/O.
+ *
+ * @details Checks which of the @p events are ready in the character device
+ *          @p dev. Devices that do not support polling never block, and thus
+ *          are always ready.
+ *
+ * @returns The requested events that are ready.
+ */
+PUBLIC int cdev_poll(dev_t dev, int events)
+{
+	/* Invalid device. */
+	if ((MAJOR(dev) != NULL_MAJOR) && (cdevsw[MAJOR(dev)] == NULL))
+		return (POLLNVAL);
+
+	/* Never blocks. */
+	if ((MAJOR(dev) == NULL_MAJOR) || (cdevsw[MAJOR(dev)]->poll == NULL))
+		return (events & (POLLIN | POLLRDNORM | POLLOUT | POLLWRNORM));
+
+	return (cdevsw[MAJOR(dev)]->poll(MINOR(dev), events));
+}
+
 /*============================================================================*
  *                              Block Devices                                 *
  *============================================================================*/
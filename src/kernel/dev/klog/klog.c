@@ -231,7 +231,8 @@ PRIVATE struct cdev klog_driver = {
 	&klog_read,  /* read()  */
 	NULL,        /* write() */
 	NULL,        /* ioctl() */
-	&klog_close  /* close() */
+	&klog_close, /* close() */
+	NULL         /* poll()  */
 };
 
 /**
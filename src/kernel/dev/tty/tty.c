@@ -27,6 +27,7 @@
 #include <nanvix/pm.h>
 #include <nanvix/syscall.h>
 #include <errno.h>
+#include <poll.h>
 #include <termios.h>
 #include <stropts.h>
 #include "tty.h"
@@ -51,15 +52,12 @@ PRIVATE struct tty *active = &tty;
  */
 PRIVATE void tty_signal(int sig)
 {
-	for (struct process *p = FIRST_PROC; p <= LAST_PROC; p++)
-	{
-		/* Skip invalid processes. */
-		if (!IS_VALID(p))
-			continue;
+	/* No foreground process group. */
+	if (active->pgrp == NULL)
+		return;
 
-		if (active->pgrp == p->pgrp)
-			sndsig(p, sig);
-	}
+	for (struct process *p = active->pgrp->members; p != NULL; p = p->next_member)
+		sndsig(p, sig);
 }
 
 /**
@@ -132,6 +130,7 @@ PUBLIC void tty_int(unsigned char ch)
 		{
 			active->flags &= ~TTY_STOPPED;
 			wakeup(&active->output.chain);
+			pollwakeup(&active->output.polls);
 			return;
 		}
 
@@ -154,6 +153,7 @@ out1:
 	KBUFFER_PUT(active->rinput, ch);
 out0:
 	wakeup(&active->rinput.chain);
+	pollwakeup(&active->rinput.polls);
 }
 
 /**
@@ -422,6 +422,76 @@ out:
 	return ((ssize_t)((char *)p - buf));
 }
 
+/**
+ * @brief Asserts if a TTY device can be read without blocking.
+ *
+ * @details In canonical mode, input is only delivered in whole lines, so a
+ *          line delimiter must have been typed.
+ *
+ * @param ttyp TTY device to query.
+ *
+ * @returns Non-zero if a read would not block, and zero otherwise.
+ */
+PRIVATE int tty_readable(struct tty *ttyp)
+{
+	unsigned i;       /* Buffer index.      */
+	unsigned char ch; /* Working character. */
+
+	/* Non canonical mode. */
+	if (!(ttyp->term.c_lflag & ICANON))
+		return (!KBUFFER_EMPTY(ttyp->rinput));
+
+	/* Look for a complete line. */
+	for (i = ttyp->rinput.head; i != ttyp->rinput.tail; i = (i + 1)&(KBUFFER_SIZE - 1))
+	{
+		ch = ttyp->rinput.buffer[i];
+
+		if ((ch == '\n') || (ch == EOL_CHAR(ttyp->term)) || (ch == EOF_CHAR(ttyp->term)))
+			return (1);
+	}
+
+	return (0);
+}
+
+/**
+ * @brief Checks whether a TTY device is ready for I/O.
+ *
+ * @details If the TTY device is not ready for the requested events, the
+ *          calling process is registered in the input or output buffer, so
+ *          that it gets awaken by the next keystroke or START character.
+ *
+ * @param minor  Minor device number of target TTY device.
+ * @param events Requested events.
+ *
+ * @returns The requested events that are ready.
+ */
+PRIVATE int tty_poll(unsigned minor, int events)
+{
+	int revents = 0;
+
+	UNUSED(minor);
+
+	/* Input. */
+	if (events & (POLLIN | POLLRDNORM))
+	{
+		if (tty_readable(&tty))
+			revents |= events & (POLLIN | POLLRDNORM);
+		else
+			pollrecord(&tty.rinput.polls);
+	}
+
+	/* Output. */
+	if (events & (POLLOUT | POLLWRNORM))
+	{
+		if (!(tty.flags & TTY_STOPPED) || !KBUFFER_FULL(tty.output))
+			revents |= events & (POLLOUT | POLLWRNORM);
+		else
+			pollrecord(&tty.output.polls);
+	}
+
+	return (revents);
+}
+
 /*
  * Opens a tty device.
  */
@@ -561,7 +631,8 @@ PRIVATE struct cdev tty_driver = {
 	&tty_read,  /* read().  */
 	&tty_write, /* write(). */
 	&tty_ioctl, /* ioctl(). */
-	&tty_close  /* ioctl(). */
+	&tty_close, /* close(). */
+	&tty_poll   /* poll().  */
 };
 
 /**
@@ -30,20 +30,32 @@
  * @brief Superblock module implementation.
  */
 
+/**
+ * @brief Gets the disk block that follows another one.
+ *
+ * @param num Disk block number (may be #BLOCK_NULL).
+ *
+ * @returns The disk block next to @p num, or #BLOCK_NULL if @p num is
+ *          #BLOCK_NULL.
+ */
+#define BLOCK_NEXT(num) (((num) == BLOCK_NULL) ? BLOCK_NULL : (num) + 1)
+
 /**
  * @brief Allocates a disk block.
  *
  * @details Allocates a disk block by searching in the bitmap of blocks for a
- *          free block.
+ *          free block. The block @p goal is tried first, so that consecutive
+ *          blocks of a file are laid out in contiguous runs on disk.
  *
- * @param sb Superblock in which the disk block should be allocated.
+ * @param sb   Superblock in which the disk block should be allocated.
+ * @param goal Preferred disk block (#BLOCK_NULL if none).
  *
  * @return Upon successful completion, the block number of the allocated block
  *         is returned. Upon failed, #BLOCK_NULL is returned instead.
  *
  * @note The superblock must be locked.
  */
-PRIVATE block_t block_alloc(struct superblock *sb)
+PRIVATE block_t block_alloc(struct superblock *sb, block_t goal)
 {
 	bit_t bit;          /* Bit number in the bitmap. */
 	block_t num;        /* Block number.             */
@@ -51,6 +63,16 @@ PRIVATE block_t block_alloc(struct superblock *sb)
 	block_t firstblk;   /* First block to check.     */
 	struct buffer *buf; /* Working buffer.           */
 
+	/* Try preferred block. */
+	if ((goal >= sb->first_data_block) && (goal < sb->zones))
+	{
+		bit = (goal - sb->first_data_block)%(BLOCK_SIZE << 3);
+		blk = (goal - sb->first_data_block)/(BLOCK_SIZE << 3);
+
+		if (!(((uint32_t *)sb->zmap[blk]->data)[IDX(bit)] & (1 << OFF(bit))))
+			goto found;
+	}
+
 	/* Search for a free block. */
 	firstblk = (sb->zsearch - sb->first_data_block)/(BLOCK_SIZE << 3);
 	blk = firstblk;
@@ -76,7 +98,8 @@ found:
 	 * Remember disk block number to
 	 * speedup next block allocation.
 	 */
-	sb->zsearch = num;
+	if (num != goal)
+		sb->zsearch = num;
 
 	/* Allocate block. */
 	bitmap_set(sb->zmap[blk]->data, bit);
@@ -84,7 +107,7 @@ found:
 	sb->flags |= SUPERBLOCK_DIRTY;
 
 	/* Clean block to avoid security issues. */
-	buf = bread(sb->dev, blk);
+	buf = bread(sb->dev, num);
 	kmemset(buf->data, 0, BLOCK_SIZE);
 	buf->flags |= BUFFER_DIRTY;
 	brelse(buf);
@@ -232,6 +255,56 @@ PUBLIC void block_free(struct superblock *sb, block_t num, int lvl)
 	}
 }
 
+/**
+ * @brief Maps an entry of an indirect block.
+ *
+ * @details Maps the entry @p idx of the indirect disk block @p ind to a disk
+ *          block. If @p create is not zero and such entry is not valid, a
+ *          new disk block is allocated, next to the one of the previous entry.
+ *
+ * @param ip     File to use.
+ * @param ind    Indirect disk block.
+ * @param idx    Entry index.
+ * @param create Create entry?
+ *
+ * @returns Upon successful completion, the disk block number that is stored in
+ *          the entry is returned. Upon failure, #BLOCK_NULL is returned
+ *          instead.
+ *
+ * @note @p ip must be locked.
+ */
+PRIVATE block_t block_map_indirect
+(struct inode *ip, block_t ind, unsigned idx, int create)
+{
+	block_t phys;       /* Physical block number. */
+	block_t goal;       /* Preferred block.       */
+	struct buffer *buf; /* Underlying buffer.     */
+
+	buf = bread(ip->dev, ind);
+
+	/* Create block. */
+	if ((phys = ((block_t *)buf->data)[idx]) == BLOCK_NULL && create)
+	{
+		goal = (idx > 0) ?
+			BLOCK_NEXT(((block_t *)buf->data)[idx - 1]) : ind + 1;
+
+		superblock_lock(ip->sb);
+		phys = block_alloc(ip->sb, goal);
+		superblock_unlock(ip->sb);
+
+		if (phys != BLOCK_NULL)
+		{
+			((block_t *)buf->data)[idx] = phys;
+			buf->flags |= BUFFER_DIRTY;
+			inode_touch(ip);
+		}
+	}
+
+	brelse(buf);
+
+	return (phys);
+}
+
 /**
  * @brief Maps a file byte offset in a disk block number.
  *
@@ -252,8 +325,8 @@ PUBLIC void block_free(struct superblock *sb, block_t num, int lvl)
 PUBLIC block_t block_map(struct inode *ip, off_t off, int create)
 {
 	block_t phys;       /* Physical block number. */
+	block_t goal;       /* Preferred block.       */
 	block_t logic;      /* Logical block number.  */
-	struct buffer *buf; /* Underlying buffer.     */
 
 	logic = off/BLOCK_SIZE;
 
@@ -277,8 +350,10 @@ PUBLIC block_t block_map(struct inode *ip, off_t off, int create)
 		/* Create direct block. */
 		if (ip->blocks[logic] == BLOCK_NULL && create)
 		{
+			goal = (logic > 0) ? BLOCK_NEXT(ip->blocks[logic - 1]) : BLOCK_NULL;
+
 			superblock_lock(ip->sb);
-			phys = block_alloc(ip->sb);
+			phys = block_alloc(ip->sb, goal);
 			superblock_unlock(ip->sb);
 
 			if (phys != BLOCK_NULL)
@@ -299,8 +374,10 @@ PUBLIC block_t block_map(struct inode *ip, off_t off, int create)
 		/* Create single indirect block. */
 		if (ip->blocks[ZONE_SINGLE] == BLOCK_NULL && create)
 		{
+			goal = BLOCK_NEXT(ip->blocks[NR_ZONES_DIRECT - 1]);
+
 			superblock_lock(ip->sb);
-			phys = block_alloc(ip->sb);
+			phys = block_alloc(ip->sb, goal);
 			superblock_unlock(ip->sb);
 
 			if (phys != BLOCK_NULL)
@@ -314,34 +391,36 @@ PUBLIC block_t block_map(struct inode *ip, off_t off, int create)
 		if ((phys = ip->blocks[ZONE_SINGLE]) == BLOCK_NULL)
 			return (BLOCK_NULL);
 
-		buf = bread(ip->dev, phys);
-
-		/* Create direct block. */
-		if (((block_t *)buf->data)[logic] == BLOCK_NULL && create)
-		{
-			superblock_lock(ip->sb);
-			phys = block_alloc(ip->sb);
-			superblock_unlock(ip->sb);
+		return (block_map_indirect(ip, phys, logic, create));
+	}
 
-			if (phys != BLOCK_NULL)
-			{
-				((block_t *)buf->data)[logic] = phys;
-				buf->flags |= BUFFER_DIRTY;
-				inode_touch(ip);
-			}
-		}
+	logic -= NR_SINGLE;
 
-		brelse(buf);
+	/* Create double indirect block. */
+	if (ip->blocks[ZONE_DOUBLE] == BLOCK_NULL && create)
+	{
+		superblock_lock(ip->sb);
+		phys = block_alloc(ip->sb, BLOCK_NULL);
+		superblock_unlock(ip->sb);
 
-		return (((block_t *)buf->data)[logic]);
+		if (phys != BLOCK_NULL)
+		{
+			ip->blocks[ZONE_DOUBLE] = phys;
+			inode_touch(ip);
+		}
 	}
 
-	logic -= NR_SINGLE;
+	/* We cannot go any further. */
+	if ((phys = ip->blocks[ZONE_DOUBLE]) == BLOCK_NULL)
+		return (BLOCK_NULL);
 
-	/* Double indirect zone. */
-	kpanic("double indirect zones not supported yet");
+	phys = block_map_indirect(ip, phys, logic/NR_SINGLE, create);
 
-	return (BLOCK_NULL);
+	/* We cannot go any further. */
+	if (phys == BLOCK_NULL)
+		return (BLOCK_NULL);
+
+	return (block_map_indirect(ip, phys, logic%NR_SINGLE, create));
 }
 
 /**@}*/
@@ -75,6 +75,11 @@ PRIVATE struct process *chain = NULL;
  */
 PRIVATE struct buffer hashtab[BUFFERS_HASHTAB_SIZE];
 
+/**
+ * @brief Block buffer cache lock.
+ */
+PRIVATE spinlock_t buffers_lock = SPINLOCK_UNLOCKED;
+
 // CACHE STATS
 PRIVATE long cache_hits = 0;
 PRIVATE long cache_misses = 0;
@@ -88,6 +93,39 @@ PRIVATE long cache_misses = 0;
 #define HASH(dev, block) \
 	(((dev) ^ (block)) % BUFFERS_HASHTAB_SIZE)
 
+/**
+ * @brief Locks a block buffer.
+ *
+ * @param buf Block buffer to be locked.
+ *
+ * @note The block buffer cache lock must be held.
+ */
+PRIVATE void do_blklock(struct buffer *buf)
+{
+	/* Wait for block buffer to become unlocked. */
+	while (buf->flags & BUFFER_LOCKED)
+	{
+		spin_unlock(&buffers_lock);
+		sleep(&buf->chain, PRIO_BUFFER);
+		spin_lock(&buffers_lock);
+	}
+
+	buf->flags |= BUFFER_LOCKED;
+}
+
+/**
+ * @brief Unlocks a block buffer.
+ *
+ * @param buf Block buffer to be unlocked.
+ *
+ * @note The block buffer cache lock must be held.
+ */
+PRIVATE void do_blkunlock(struct buffer *buf)
+{
+	buf->flags &= ~BUFFER_LOCKED;
+	wakeup(&buf->chain);
+}
+
 /**
  * @brief Gets a block buffer from the block buffer cache.
  *
@@ -105,18 +143,19 @@ PRIVATE long cache_misses = 0;
 PRIVATE struct buffer *getblk(dev_t dev, block_t num)
 {
 	unsigned i;			/* Hash table index. */
+	unsigned flags;     /* Interrupt state.  */
 	struct buffer *buf; /* Buffer.           */
 
 	/* Should not happen. */
 	if ((dev == 0) && (num == 0))
 		kpanic("getblk(0, 0)");
 
+	flags = spin_lock_irqsave(&buffers_lock);
+
 repeat:
 
 	i = HASH(dev, num);
 
-	disable_interrupts();
-
 	/* Search in hash table. */
 	for (buf = hashtab[i].hash_next; buf != &hashtab[i]; buf = buf->hash_next)
 	{
@@ -130,7 +169,9 @@ repeat:
 		 */
 		if (buf->flags & BUFFER_LOCKED)
 		{
+			spin_unlock(&buffers_lock);
 			sleep(&buf->chain, PRIO_BUFFER);
+			spin_lock(&buffers_lock);
 			goto repeat;
 		}
 
@@ -141,8 +182,8 @@ repeat:
 			buf->free_next->free_prev = buf->free_prev;
 		}
 
-		blklock(buf);
-		enable_interrupts();
+		do_blklock(buf);
+		spin_unlock_irqrestore(&buffers_lock, flags);
 
 		return (buf);
 	}
@@ -154,7 +195,9 @@ repeat:
 	if (&free_buffers == free_buffers.free_next)
 	{
 		kprintf("fs: no free buffers");
+		spin_unlock(&buffers_lock);
 		sleep(&chain, PRIO_BUFFER);
+		spin_lock(&buffers_lock);
 		goto repeat;
 	}
 
@@ -170,9 +213,10 @@ repeat:
 	 */
 	if (buf->flags & BUFFER_DIRTY)
 	{
-		blklock(buf);
-		enable_interrupts();
+		do_blklock(buf);
+		spin_unlock_irqrestore(&buffers_lock, flags);
 		bwrite(buf);
+		flags = spin_lock_irqsave(&buffers_lock);
 		goto repeat;
 	}
 
@@ -191,8 +235,8 @@ repeat:
 	buf->hash_next = hashtab[i].hash_next;
 	hashtab[i].hash_next = buf;
 
-	blklock(buf);
-	enable_interrupts();
+	do_blklock(buf);
+	spin_unlock_irqrestore(&buffers_lock, flags);
 
 	return (buf);
 }
@@ -208,15 +252,11 @@ repeat:
  */
 PUBLIC void blklock(struct buffer *buf)
 {
-	disable_interrupts();
+	unsigned flags;
 
-	/* Wait for block buffer to become unlocked. */
-	while (buf->flags & BUFFER_LOCKED)
-		sleep(&buf->chain, PRIO_BUFFER);
-
-	buf->flags |= BUFFER_LOCKED;
-
-	enable_interrupts();
+	flags = spin_lock_irqsave(&buffers_lock);
+	do_blklock(buf);
+	spin_unlock_irqrestore(&buffers_lock, flags);
 }
 
 /**
@@ -231,12 +271,11 @@ PUBLIC void blklock(struct buffer *buf)
  */
 PUBLIC void blkunlock(struct buffer *buf)
 {
-	disable_interrupts();
+	unsigned flags;
 
-	buf->flags &= ~BUFFER_LOCKED;
-	wakeup(&buf->chain);
-
-	enable_interrupts();
+	flags = spin_lock_irqsave(&buffers_lock);
+	do_blkunlock(buf);
+	spin_unlock_irqrestore(&buffers_lock, flags);
 }
 
 /**
@@ -251,7 +290,9 @@ PUBLIC void blkunlock(struct buffer *buf)
  */
 PUBLIC void brelse(struct buffer *buf)
 {
-	disable_interrupts();
+	unsigned flags;
+
+	flags = spin_lock_irqsave(&buffers_lock);
 
 	/* Double free. */
 	if (buf->count == 0)
@@ -285,8 +326,8 @@ PUBLIC void brelse(struct buffer *buf)
 		}
 	}
 
-	blkunlock(buf);
-	enable_interrupts();
+	do_blkunlock(buf);
+	spin_unlock_irqrestore(&buffers_lock, flags);
 }
 
 PUBLIC void buffer_valid_and_clean(struct buffer *buf)
@@ -409,6 +450,8 @@ PUBLIC void bwrite(struct buffer *buf)
  */
 PUBLIC void bsync(void)
 {
+	unsigned flags;
+
 	/* Synchronize buffers. */
 	for (struct buffer *buf = &buffers[0]; buf < &buffers[NR_BUFFERS]; buf++)
 	{
@@ -425,13 +468,13 @@ PUBLIC void bsync(void)
 		 * Prevent double free, since a call
 		 * to brelse() will follow.
 		 */
-		disable_interrupts();
+		flags = spin_lock_irqsave(&buffers_lock);
 		if (buf->count++ == 0)
 		{
 			buf->free_prev->free_next = buf->free_next;
 			buf->free_next->free_prev = buf->free_prev;
 		}
-		enable_interrupts();
+		spin_unlock_irqrestore(&buffers_lock, flags);
 
 		/*
 		 * This will cause the buffer to be
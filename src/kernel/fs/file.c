@@ -26,6 +26,11 @@
 #include <errno.h>
 #include "fs.h"
 
+/**
+ * @brief Number of directory entries in a block.
+ */
+#define DIRENTS_PER_BLOCK (BLOCK_SIZE/sizeof(struct d_dirent))
+
 /**
  * @brief Searches for a directory entry.
  *
@@ -192,6 +197,51 @@ PUBLIC ino_t dir_search(struct inode *ip, const char *filename)
 	return (d->d_ino);
 }
 
+/*
+ * Asserts if a directory has no entries other than "." and "..".
+ */
+PRIVATE int dir_empty(struct inode *ip)
+{
+	off_t off;          /* Working offset.   */
+	block_t blk;        /* Working block.    */
+	struct buffer *buf; /* Block buffer.     */
+	struct d_dirent *d; /* Directory entry.  */
+	struct d_dirent *e; /* End of entries.   */
+
+	for (off = 0; off < ip->size; off += BLOCK_SIZE)
+	{
+		/* Free block. */
+		if ((blk = block_map(ip, off, 0)) == BLOCK_NULL)
+			continue;
+
+		buf = bread(ip->dev, blk);
+		d = buf->data;
+		e = d + BLOCK_SIZE/sizeof(struct d_dirent);
+
+		/* Last block. */
+		if (ip->size - off < BLOCK_SIZE)
+			e = d + (ip->size - off)/sizeof(struct d_dirent);
+
+		for (/* noop */; d < e; d++)
+		{
+			/* Free entry. */
+			if (d->d_ino == INODE_NULL)
+				continue;
+
+			/* Self and parent entries. */
+			if ((!kstrncmp(d->d_name, ".", NAME_MAX)) || (!kstrncmp(d->d_name, "..", NAME_MAX)))
+				continue;
+
+			brelse(buf);
+			return (0);
+		}
+
+		brelse(buf);
+	}
+
+	return (1);
+}
+
 /*
  * Removes an entry from a directory.
  */
@@ -235,7 +285,7 @@ PUBLIC int dir_remove(struct inode *dinode, const char *filename)
 		}
 
 		/* Directory not empty. */
-		if (dinode->size)
+		if (!dir_empty(file))
 		{
 			inode_put(file);
 			brelse(buf);
@@ -244,6 +294,7 @@ PUBLIC int dir_remove(struct inode *dinode, const char *filename)
 	}
 
 	/* Remove directory entry. */
+	namecache_remove(file->dev, file->num);
 	d->d_ino = INODE_NULL;
 	buf->flags |= BUFFER_DIRTY;
 	inode_touch(dinode);
@@ -277,6 +328,85 @@ PUBLIC int dir_add(struct inode *dinode, struct inode *inode, const char *name)
 	return (0);
 }
 
+/**
+ * @brief Reads live entries of a directory.
+ *
+ * @details Walks the blocks of the directory pointed to by @p dinode from
+ *          entry @p pos on, and packs the entries that are in use into @p buf
+ *          until it is full. Free entries and unallocated blocks are skipped
+ *          in the kernel. The file type of an entry is filled in when its
+ *          inode is cached, and is DT_UNKNOWN otherwise.
+ *
+ * @param dinode Target directory.
+ * @param buf    Buffer where entries shall be stored.
+ * @param n      Size of @p buf.
+ * @param pos    Position in the directory, in bytes. Updated on return.
+ *
+ * @returns The number of bytes stored in @p buf, which is zero at the end of
+ *          the directory.
+ */
+PUBLIC ssize_t dir_read
+(struct inode *dinode, struct dirent *buf, size_t n, off_t *pos)
+{
+	int i;               /* Working directory entry index. */
+	int nentries;        /* Number of directory entries.   */
+	block_t blk;         /* Working block number.          */
+	mode_t mode;         /* File mode.                     */
+	struct d_dirent *d;  /* Disk directory entry.          */
+	struct buffer *bbuf; /* Working block buffer.          */
+	struct dirent *dp;   /* Working directory entry.       */
+	struct dirent *end;  /* End of buffer.                 */
+
+	dp = buf;
+	end = buf + n/sizeof(struct dirent);
+
+	inode_lock(dinode);
+
+	nentries = dinode->size/sizeof(struct d_dirent);
+	i = *pos/sizeof(struct d_dirent);
+
+	while ((i < nentries) && (dp < end))
+	{
+		blk = block_map(dinode, i*sizeof(struct d_dirent), 0);
+
+		/* Skip unallocated block. */
+		if (blk == BLOCK_NULL)
+		{
+			i = (i/DIRENTS_PER_BLOCK + 1)*DIRENTS_PER_BLOCK;
+			continue;
+		}
+
+		bbuf = bread(dinode->dev, blk);
+		d = &((struct d_dirent *)bbuf->data)[i%DIRENTS_PER_BLOCK];
+
+		/* Copy live entries in this block. */
+		do
+		{
+			if (d->d_ino != INODE_NULL)
+			{
+				mode = inode_peek(dinode->dev, d->d_ino);
+				dp->d_ino = d->d_ino;
+				dp->d_type = IFTODT(mode);
+				kstrncpy(dp->d_name, d->d_name, NAME_MAX);
+				dp++;
+			}
+
+			d++; i++;
+		} while ((i%DIRENTS_PER_BLOCK != 0) && (i < nentries) && (dp < end));
+
+		brelse(bbuf);
+	}
+
+	if (i > nentries)
+		i = nentries;
+	*pos = i*sizeof(struct d_dirent);
+
+	inode_touch(dinode);
+	inode_unlock(dinode);
+
+	return ((ssize_t)((char *)dp - (char *)buf));
+}
+
 /*
  * Reads from a regular file.
  */
@@ -360,7 +490,7 @@ PUBLIC ssize_t file_write(struct inode *i, const void *buf, size_t n, off_t off)
 		blkoff = off % BLOCK_SIZE;
 
 		chunk = (n < BLOCK_SIZE - blkoff) ? n : BLOCK_SIZE - blkoff;
-		kmemcpy((char *)bbuf->data + blkoff, buf, chunk);
+		kmemcpy((char *)bbuf->data + blkoff, p, chunk);
 		bbuf->flags |= BUFFER_DIRTY;
 		brelse(bbuf);
 
@@ -383,3 +513,79 @@ out:
 	inode_unlock(i);
 	return ((ssize_t)(p - (char *)buf));
 }
+
+/*
+ * Copies data between regular files.
+ */
+PUBLIC ssize_t file_copy
+(struct inode *in, off_t inoff, struct inode *out, off_t outoff, size_t n)
+{
+	size_t chunk;        /* Data chunk size.       */
+	size_t count;        /* Bytes copied so far.   */
+	block_t sblk;        /* Source block number.   */
+	block_t dblk;        /* Target block number.   */
+	struct buffer *sbuf; /* Source block buffer.   */
+	struct buffer *dbuf; /* Target block buffer.   */
+
+	/* Lock inodes in address order to avoid deadlocks. */
+	if (in < out)
+	{
+		inode_lock(in);
+		inode_lock(out);
+	}
+	else
+	{
+		inode_lock(out);
+		inode_lock(in);
+	}
+
+	/* Copy data, one block buffer at a time. */
+	for (count = 0; (n > 0) && (inoff < in->size); /* noop */)
+	{
+		/* Chunk must not cross a block boundary on either side. */
+		chunk = BLOCK_SIZE - inoff%BLOCK_SIZE;
+		if (chunk > (size_t)(BLOCK_SIZE - outoff%BLOCK_SIZE))
+			chunk = BLOCK_SIZE - outoff%BLOCK_SIZE;
+		if (chunk > n)
+			chunk = n;
+		if ((off_t)chunk > in->size - inoff)
+			chunk = in->size - inoff;
+
+		/* End of file reached. */
+		if ((sblk = block_map(in, inoff, 0)) == BLOCK_NULL)
+			break;
+
+		/* Failed to allocate block. */
+		if ((dblk = block_map(out, outoff, 1)) == BLOCK_NULL)
+			break;
+
+		sbuf = bread(in->dev, sblk);
+		dbuf = bread(out->dev, dblk);
+
+		kmemcpy((char *)dbuf->data + outoff%BLOCK_SIZE,
+			(char *)sbuf->data + inoff%BLOCK_SIZE, chunk);
+		dbuf->flags |= BUFFER_DIRTY;
+
+		brelse(dbuf);
+		brelse(sbuf);
+
+		n -= chunk;
+		inoff += chunk;
+		outoff += chunk;
+		count += chunk;
+
+		/* Update file size. */
+		if (outoff > out->size)
+		{
+			out->size = outoff;
+			out->flags |= INODE_DIRTY;
+		}
+	}
+
+	inode_touch(in);
+	inode_touch(out);
+	inode_unlock(out);
+	inode_unlock(in);
+
+	return ((ssize_t)count);
+}
@@ -17,19 +17,17 @@
  * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <nanvix/clock.h>
 #include <nanvix/const.h>
 #include <nanvix/fs.h>
 #include <nanvix/klib.h>
 #include <nanvix/mm.h>
 #include <nanvix/pm.h>
+#include <nanvix/syscall.h>
 #include <dirent.h>
 #include <errno.h>
 #include "fs.h"
 
-#if NR_FILES < OPEN_MAX*NR_PROCS
-	#error "file table too big"
-#endif
-
 /*
  * Root device.
  */
@@ -41,11 +39,16 @@ PUBLIC struct superblock *rootdev = NULL;
 PUBLIC struct inode *root = NULL;
 
 /*
- * File table.
+ * File table cache.
  */
-PUBLIC struct file filetab[NR_FILES];
+PRIVATE struct kcache *file_cache = NULL;
 
 PUBLIC int test_mode_enabled = 0;
+
+/*
+ * Interval between writebacks of kflushd (in clock ticks).
+ */
+#define FLUSH_INTERVAL (5*CLOCK_FREQ)
 /*
  * Gets an empty file descriptor table entry.
  */
@@ -57,7 +60,7 @@ PUBLIC int getfildes(void)
 	for (i = 0; i < OPEN_MAX; i++)
 	{
 		/* Found. */
-		if (curr_proc->ofiles[i] == NULL)
+		if (curr_proc->tg->ofiles[i] == NULL)
 			return (i);
 	}
 
@@ -69,17 +72,15 @@ PUBLIC int getfildes(void)
  */
 PUBLIC struct file *getfile(void)
 {
-	struct file *f;
-
-	/* Look for empty file table entry. */
-	for (f = &filetab[0]; f < &filetab[NR_FILES]; f++)
-	{
-		/* Found. */
-		if (f->count == 0)
-			return (f);
-	}
+	return (kcache_alloc(file_cache));
+}
 
-	return (NULL);
+/*
+ * Releases a file table entry.
+ */
+PUBLIC void putfile(struct file *f)
+{
+	kcache_free(file_cache, f);
 }
 
 /*
@@ -90,20 +91,21 @@ PUBLIC void do_close(int fd)
 	struct inode *i; /* Inode. */
 	struct file *f;  /* File.  */
 
-	f = curr_proc->ofiles[fd];
+	f = curr_proc->tg->ofiles[fd];
 
 	/* Not opened. */
 	if (f == NULL)
 		return;
 
-	curr_proc->close &= ~(1 << fd);
-	curr_proc->ofiles[fd] = NULL;
+	curr_proc->tg->close &= ~(1 << fd);
+	curr_proc->tg->ofiles[fd] = NULL;
 
 	if (--f->count)
 		return;
 
 	inode_lock(i = f->inode);
 	inode_put(i);
+	putfile(f);
 }
 
 /*
@@ -142,8 +144,8 @@ PUBLIC char *getname(const char *name)
 	const char *r; /* Read pointer.        */
 	char *w;       /* Write pointer.       */
 
-	/* Grab a kernel page. */
-	if ((kname = getkpg(0)) == NULL)
+	/* Grab a name buffer. */
+	if ((kname = kmalloc(PATH_MAX)) == NULL)
 	{
 		curr_proc->errno = -ENOMEM;
 		return (NULL);
@@ -155,16 +157,16 @@ PUBLIC char *getname(const char *name)
 		/* Bad user file name. */
 		if (ch < 0)
 		{
-			putkpg(kname);
+			kfree(kname);
 			curr_proc->errno = -EFAULT;
 			return (NULL);
 
 		}
 
 		/* File name too long. */
-		if ((w - kname) > PAGE_SIZE - 1)
+		if ((w - kname) >= PATH_MAX - 1)
 		{
-			putkpg(kname);
+			kfree(kname);
 			curr_proc->errno = -ENAMETOOLONG;
 			return (NULL);
 		}
@@ -182,7 +184,7 @@ PUBLIC char *getname(const char *name)
  */
 PUBLIC void putname(char *name)
 {
-	putkpg(name);
+	kfree(name);
 }
 
 /*
@@ -190,13 +192,13 @@ PUBLIC void putname(char *name)
  */
 PUBLIC void fs_init(void)
 {
+	if ((file_cache = kcache_create("file", sizeof(struct file))) == NULL)
+		kpanic("failed to create file table cache");
+
 	binit();
 	inode_init();
 	superblock_init();
 
-	/* Sanity check. */
-	CHKSIZE(sizeof(struct d_dirent), sizeof(struct dirent));
-
 	rootdev = superblock_read(ROOT_DEV);
 
 	/* Failed to read root super block. */
@@ -214,9 +216,23 @@ PUBLIC void fs_init(void)
 	kprintf("fs: root file system mounted");
 
 	/* Hand craft idle process. */
-	IDLE->pwd = root;
-	IDLE->root = root;
+	IDLE->tg->pwd = root;
+	IDLE->tg->root = root;
 	root->count += 2;
 
 	inode_unlock(root);
 }
+
+/*
+ * Writes back dirty file system data periodically.
+ */
+PUBLIC void kflushd(void *arg)
+{
+	((void) arg);
+
+	while (!shutting_down)
+	{
+		sleep_until(ticks + FLUSH_INTERVAL);
+		sys_sync();
+	}
+}
@@ -98,6 +98,7 @@
 
 	/* Forward definitions. */
 	EXTERN void inode_init(void);
+	EXTERN void namecache_remove(dev_t dev, ino_t num);
 
 /*============================================================================*
  *                            Super Block Library                             *
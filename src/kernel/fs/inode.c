@@ -59,6 +59,40 @@ PRIVATE struct inode *hashtab[HASHTAB_SIZE];
 #define HASH(dev, num) \
 	(((dev)^(num))%HASHTAB_SIZE)
 
+/**
+ * @brief Name cache size.
+ */
+#define NAMECACHE_SIZE 64
+
+/**
+ * @brief Name cache entry.
+ *
+ * @details Remembers under which name and in which parent directory a
+ *          directory was last looked up.
+ */
+struct name
+{
+	dev_t dev;                 /**< Device.                   */
+	ino_t num;                 /**< Inode number.             */
+	dev_t pdev;                /**< Device of parent.         */
+	ino_t pnum;                /**< Inode number of parent.   */
+	char name[NAME_MAX + 1];   /**< Name in parent directory. */
+};
+
+/**
+ * @brief Name cache.
+ *
+ * @details Direct-mapped on the directory's device and inode number. A
+ *          colliding entry simply replaces the older one.
+ */
+PRIVATE struct name namecache[NAMECACHE_SIZE];
+
+/**
+ * @brief Hash function for the name cache.
+ */
+#define NAMEHASH(dev, num) \
+	(((dev)^(num))%NAMECACHE_SIZE)
+
 /**
  * @brief Evicts an free inode from the inode cache
  *
@@ -526,47 +560,71 @@ repeat:
 	return (ip);
 }
 
+/**
+ * @brief Peeks at the mode of a cached inode.
+ *
+ * @details Looks up the inode with number @p num from the device @p dev in
+ *          the inode cache only, so that no disk I/O is done and no
+ *          reference is taken.
+ *
+ * @param dev Device where the inode is located.
+ * @param num Number of the inode.
+ *
+ * @returns The mode of the inode if it is cached, and zero otherwise.
+ */
+PUBLIC mode_t inode_peek(dev_t dev, ino_t num)
+{
+	struct inode *ip;
+
+	for (ip = hashtab[HASH(dev, num)]; ip != NULL; ip = ip->hash_next)
+	{
+		/* Found. */
+		if ((ip->dev == dev) && (ip->num == num))
+			return (ip->mode);
+	}
+
+	return (0);
+}
+
 /*
  * Gets a pipe inode.
  */
 PUBLIC struct inode *inode_pipe(void)
 {
-	void *pipe;          /* Pipe page.  */
 	struct inode *inode; /* Pipe inode. */
 
-	pipe = getkpg(0);
-
-	/* Failed to get pipe page. */
-	if (pipe == NULL)
-		goto error0;
-
 	inode = inode_cache_evict();
 
 	/* No free inode. */
 	if (inode == NULL)
-		goto error1;
+		return (NULL);
 
 	/* Initialize inode. */
 	inode->mode = MAY_READ | MAY_WRITE | S_IFIFO;
 	inode->nlinks = 0;
 	inode->uid = curr_proc->uid;
 	inode->gid = curr_proc->gid;
-	inode->size = PAGE_SIZE;
+	inode->size = 0;
 	inode->time = CURRENT_TIME;
 	inode->dev = NULL_DEV;
 	inode->num = INODE_NULL;
-	inode->count = 2;
 	inode->flags |= ~(INODE_DIRTY | INODE_MOUNT) & (INODE_VALID | INODE_PIPE);
-	inode->pipe = pipe;
+	inode->pipe = NULL;
 	inode->head = 0;
 	inode->tail = 0;
+	inode->pipelen = 0;
+	inode->polls = NULL;
 
-	return (inode);
+	/* Failed to get pipe buffer. */
+	if (pipe_resize(inode, PIPE_SIZE))
+	{
+		inode_put(inode);
+		return (NULL);
+	}
 
-error1:
-	putkpg(pipe);
-error0:
-	return (NULL);
+	inode->count = 2;
+
+	return (inode);
 }
 
 /**
@@ -608,7 +666,7 @@ PUBLIC void inode_put(struct inode *ip)
 	{
 		/* Pipe inode. */
 		if (ip->flags & INODE_PIPE)
-			putkpg(ip->pipe);
+			pipe_free(ip);
 
 		/* File inode. */
 		else
@@ -631,9 +689,137 @@ PUBLIC void inode_put(struct inode *ip)
 		ip->flags &= ~INODE_VALID;
 	}
 
+	/* Pipe end closed. */
+	else if (ip->flags & INODE_PIPE)
+		pollwakeup(&ip->polls);
+
 	inode_unlock(ip);
 }
 
+/**
+ * @brief Remembers the name of a directory.
+ *
+ * @param pdev Device of parent directory.
+ * @param pnum Inode number of parent directory.
+ * @param name Name of @p ip in the parent directory.
+ * @param ip   Target inode.
+ */
+PRIVATE void namecache_enter
+(dev_t pdev, ino_t pnum, const char *name, struct inode *ip)
+{
+	unsigned len;   /* Name length.      */
+	struct name *n; /* Name cache entry. */
+
+	/* Only directories make up working directories. */
+	if (!S_ISDIR(ip->mode))
+		return;
+
+	/* Strip trailing slashes. */
+	for (len = 0; (len < NAME_MAX) && (name[len] != '\0'); len++)
+	{
+		if (name[len] == '/')
+			break;
+	}
+
+	/* Not a real name. */
+	if ((len == 0) || (name[0] == '.' && (len == 1 ||
+		(len == 2 && name[1] == '.'))))
+		return;
+
+	n = &namecache[NAMEHASH(ip->dev, ip->num)];
+	n->dev = ip->dev;
+	n->num = ip->num;
+	n->pdev = pdev;
+	n->pnum = pnum;
+	kmemcpy(n->name, name, len);
+	n->name[len] = '\0';
+}
+
+/**
+ * @brief Forgets the name of a directory.
+ *
+ * @param dev Device of the directory.
+ * @param num Inode number of the directory.
+ */
+PUBLIC void namecache_remove(dev_t dev, ino_t num)
+{
+	struct name *n;
+
+	n = &namecache[NAMEHASH(dev, num)];
+
+	if ((n->dev == dev) && (n->num == num))
+		n->num = INODE_NULL;
+}
+
+/**
+ * @brief Gets the path name of a directory.
+ *
+ * @details Rebuilds the path name of the directory pointed to by @p ip,
+ *          relative to the root directory of the calling process, by
+ *          following name cache entries up to it. No directory is read.
+ *
+ * @param ip   Target directory.
+ * @param buf  Buffer where the path name shall be stored.
+ * @param size Size of @p buf.
+ *
+ * @returns Upon successful completion, zero is returned. If some directory
+ *          on the way up is not in the name cache, -ENOENT is returned. If
+ *          @p buf is too small, -ERANGE is returned.
+ */
+PUBLIC int inode_path(struct inode *ip, char *buf, size_t size)
+{
+	dev_t dev;            /* Working device.        */
+	ino_t num;            /* Working inode number.  */
+	char *p;              /* Write pointer.         */
+	size_t len;           /* Name length.           */
+	struct name *n;       /* Name cache entry.      */
+	char path[PATH_MAX];  /* Path, built backwards. */
+
+	p = &path[PATH_MAX - 1];
+	*p = '\0';
+
+	dev = ip->dev;
+	num = ip->num;
+
+	/* Walk up to root directory. */
+	while ((dev != curr_proc->tg->root->dev) ||
+	       (num != curr_proc->tg->root->num))
+	{
+		n = &namecache[NAMEHASH(dev, num)];
+
+		/* Not cached. */
+		if ((n->dev != dev) || (n->num != num))
+			return (-ENOENT);
+
+		len = kstrlen(n->name);
+
+		/* Path too long. */
+		if ((size_t)(p - path) < len + 1)
+			return (-ERANGE);
+
+		p -= len;
+		kmemcpy(p, n->name, len);
+		*--p = '/';
+
+		dev = n->pdev;
+		num = n->pnum;
+	}
+
+	/* Root directory. */
+	if (*p == '\0')
+		*--p = '/';
+
+	len = &path[PATH_MAX] - p;
+
+	/* Buffer too small. */
+	if (len > size)
+		return (-ERANGE);
+
+	kmemcpy(buf, p, len);
+
+	return (0);
+}
+
 /**
  * @brief Breaks a path
  *
@@ -682,6 +868,7 @@ PRIVATE const char *break_path(const char *pathname, char *filename)
 PUBLIC struct inode *inode_dname(const char *path, const char **name)
 {
 	dev_t dev;                   /* Current device.     */
+	ino_t num;                   /* Parent inode.       */
 	ino_t ent;                   /* Directory entry.    */
 	struct inode *i;             /* Working inode.      */
 	const char *p;               /* Current path.       */
@@ -692,11 +879,11 @@ PUBLIC struct inode *inode_dname(const char *path, const char **name)
 
 	/* Absolute path. */
 	if (*p == '/')
-		i = curr_proc->root;
+		i = curr_proc->tg->root;
 
 	/* Relative path. */
 	else if (*p != '\0')
-		i = curr_proc->pwd;
+		i = curr_proc->tg->pwd;
 
 	/* Empty path name. */
 	else
@@ -734,7 +921,7 @@ again:
 		}
 
 		/* Root directory reached. */
-		if ((curr_proc->root->num == i->num) && (!kstrcmp(filename, "..")))
+		if ((curr_proc->tg->root->num == i->num) && (!kstrcmp(filename, "..")))
 		{
 			do
 			{
@@ -774,6 +961,7 @@ again:
 		}
 
 		dev = i->dev;
+		num = i->num;
 		inode_put(i);
 		i = inode_get(dev, ent);
 
@@ -781,6 +969,8 @@ again:
 		if (i == NULL)
 			return (NULL);
 
+		namecache_enter(dev, num, filename, i);
+
 		p = break_path((*name) = p, filename);
 
 		/* Failed to break path. */
@@ -809,6 +999,7 @@ PUBLIC struct inode *inode_name(const char *pathname)
 {
 	dev_t dev;           /* Device number. */
 	ino_t num;           /* Inode number.  */
+	ino_t pnum;          /* Parent inode.  */
 	const char *name;    /* File name.     */
 	struct inode *inode; /* Working inode. */
 
@@ -820,7 +1011,7 @@ PUBLIC struct inode *inode_name(const char *pathname)
 
 	/* Special treatment for the root directory. */
 	if (!kstrcmp(name,"/"))
-		num = curr_proc->root->num;
+		num = curr_proc->tg->root->num;
 	else
 		num = dir_search(inode, name);
 
@@ -833,9 +1024,16 @@ PUBLIC struct inode *inode_name(const char *pathname)
 	}
 
 	dev = inode->dev;
+	pnum = inode->num;
 	inode_put(inode);
 
-	return (inode_get(dev, num));
+	/* Failed to get inode. */
+	if ((inode = inode_get(dev, num)) == NULL)
+		return (NULL);
+
+	namecache_enter(dev, pnum, name, inode);
+
+	return (inode);
 }
 
 /**
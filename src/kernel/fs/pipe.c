@@ -17,35 +17,193 @@
  * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
  */
 
+
 #include <nanvix/const.h>
 #include <nanvix/fs.h>
+#include <nanvix/klib.h>
+#include <nanvix/mm.h>
 #include <nanvix/pm.h>
 #include <errno.h>
+#include <poll.h>
+
+/**
+ * @brief Number of pages in a pipe buffer.
+ */
+#define PIPE_NR_PAGES (PIPE_SIZE_MAX/PAGE_SIZE)
+
+/**
+ * @brief Gets the address of a byte in a pipe buffer.
+ *
+ * @param pages Pipe buffer pages.
+ * @param off   Offset of the byte in the pipe buffer.
+ *
+ * @returns The address of the byte at offset @p off.
+ */
+#define PIPE_ADDR(pages, off) \
+	(&(pages)[(off) >> PAGE_SHIFT][(off) & ~PAGE_MASK])
+
+/**
+ * @brief Gets the number of bytes up to the end of a pipe buffer page.
+ *
+ * @param off Offset in the pipe buffer.
+ *
+ * @returns The number of bytes from @p off up to the end of its page.
+ */
+#define PIPE_CHUNK(off) \
+	((size_t)(PAGE_SIZE - ((off) & ~PAGE_MASK)))
+
+/**
+ * @brief Gets the number of pages that a pipe buffer holds above the default.
+ *
+ * @param size Size of the pipe buffer.
+ *
+ * @returns The number of pages in excess of PIPE_SIZE.
+ */
+#define PIPE_EXTRA(size) \
+	(((size) > PIPE_SIZE) ? ((size) - PIPE_SIZE)/PAGE_SIZE : 0)
+
+/**
+ * @brief Returns the smallest of two sizes.
+ */
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+
+/**
+ * @brief Pipe buffer pages in use above the default size.
+ */
+PRIVATE unsigned pipe_extra = 0;
+
+/**
+ * @brief Releases pipe buffer pages.
+ *
+ * @param pages  Pipe buffer pages.
+ * @param npages Number of pages.
+ */
+PRIVATE void pipe_putpgs(char **pages, unsigned npages)
+{
+	for (unsigned i = 0; i < npages; i++)
+		putkpg(pages[i]);
+	kfree(pages);
+}
 
 /*
- * Reads data from a pipe.
+ * Resizes the buffer of a pipe.
  */
-PUBLIC ssize_t pipe_read(struct inode *inode, char *buf, size_t n)
+PUBLIC int pipe_resize(struct inode *inode, size_t size)
 {
-	char *r;
+	unsigned i;     /* Loop index.           */
+	size_t off;     /* Offset in new buffer. */
+	size_t chunk;   /* Bytes to move.        */
+	char **pages;   /* New buffer pages.     */
+	unsigned extra; /* Extra pages in use.   */
 
-	r = buf;
+	size = ALIGN(size, PAGE_SIZE);
 
-	/* No writers. */
+	/* Invalid size. */
+	if ((size == 0) || (size > PIPE_SIZE_MAX))
+		return (-EINVAL);
+
+	/* Data does not fit in the new buffer. */
+	if (size < inode->pipelen)
+		return (-EBUSY);
+
+	/*
+	 * Pipe buffers come from the kernel page
+	 * pool, so unprivileged processes may only
+	 * grow them up to a system-wide budget.
+	 */
+	extra = pipe_extra - PIPE_EXTRA(inode->size) + PIPE_EXTRA(size);
+	if ((extra > pipe_extra) && (extra > PIPE_EXTRA_MAX))
+	{
+		if (!IS_SUPERUSER(curr_proc))
+			return (-EPERM);
+	}
+
+	/* Allocate new buffer. */
+	if ((pages = kmalloc(PIPE_NR_PAGES*sizeof(char *))) == NULL)
+		return (-ENOMEM);
+	for (i = 0; i < size/PAGE_SIZE; i++)
+	{
+		/* Failed to allocate page. */
+		if ((pages[i] = getkpg(0)) == NULL)
+		{
+			pipe_putpgs(pages, i);
+			return (-ENOMEM);
+		}
+	}
+
+	/* Move data to the front of the new buffer. */
+	for (off = 0; off < inode->pipelen; off += chunk)
+	{
+		chunk = MIN(inode->pipelen - off, PIPE_CHUNK(off));
+		chunk = MIN(chunk, PIPE_CHUNK(inode->tail));
+
+		kmemcpy(PIPE_ADDR(pages, off), PIPE_ADDR(inode->pipe, inode->tail),
+			chunk);
+		inode->tail = (inode->tail + chunk)%inode->size;
+	}
+
+	/* Release old buffer. */
+	if (inode->pipe != NULL)
+		pipe_putpgs(inode->pipe, inode->size/PAGE_SIZE);
+
+	pipe_extra = extra;
+	inode->pipe = pages;
+	inode->size = size;
+	inode->tail = 0;
+	inode->head = inode->pipelen%size;
+
+	/* There may be room for writers now. */
 	wakeup(&inode->chain);
-	if (inode->count != 2)
-		return (0);
+	pollwakeup(&inode->polls);
+
+	return (0);
+}
+
+/*
+ * Releases the buffer of a pipe.
+ */
+PUBLIC void pipe_free(struct inode *inode)
+{
+	if (inode->pipe == NULL)
+		return;
+
+	pipe_putpgs(inode->pipe, inode->size/PAGE_SIZE);
+	pipe_extra -= PIPE_EXTRA(inode->size);
+	inode->pipe = NULL;
+}
+
+/*
+ * Reads data from a pipe.
+ */
+PUBLIC ssize_t pipe_read
+(struct inode *inode, char *buf, size_t n, int nonblock)
+{
+	char *r;      /* Read pointer.      */
+	size_t chunk; /* Bytes to copy.     */
+	int wasfull;  /* Was the pipe full? */
+
+	r = buf;
 
 	/* Read from pipe. */
-	while (n-- > 0)
+	while (n > 0)
 	{
 		/* Sleep while pipe is empty. */
-		while (inode->head == inode->tail)
+		while (inode->pipelen == 0)
 		{
+			/* Return what we have got so far. */
+			if (r != buf)
+				return (r - buf);
+
 			/* No writers. */
-			wakeup(&inode->chain);
 			if (inode->count != 2)
-				return (r - buf);
+				return (0);
+
+			/* Would block. */
+			if (nonblock)
+			{
+				curr_proc->errno = -EAGAIN;
+				return (-1);
+			}
 
 			sleep(&inode->chain, PRIO_INODE);
 
@@ -55,48 +213,65 @@ PUBLIC ssize_t pipe_read(struct inode *inode, char *buf, size_t n)
 				curr_proc->errno = -EINTR;
 				return (-1);
 			}
-
 		}
 
-		*r++ = inode->pipe[inode->tail];
-		inode->tail = (inode->tail + 1)%inode->size;
-		wakeup(&inode->chain);
+		wasfull = (inode->pipelen == (size_t)inode->size);
+
+		/* Copy contiguous segment. */
+		chunk = MIN(n, inode->pipelen);
+		chunk = MIN(chunk, PIPE_CHUNK(inode->tail));
+		kmemcpy(r, PIPE_ADDR(inode->pipe, inode->tail), chunk);
+
+		r += chunk;
+		n -= chunk;
+		inode->tail = (inode->tail + chunk)%inode->size;
+		inode->pipelen -= chunk;
+
+		/* Pipe is no longer full. */
+		if (wasfull)
+		{
+			wakeup(&inode->chain);
+			pollwakeup(&inode->polls);
+		}
 	}
 
 	return (r - buf);
-
 }
 
 /*
  * Writes data to a pipe.
  */
-PUBLIC ssize_t pipe_write(struct inode *inode, const char *buf, size_t n)
+PUBLIC ssize_t pipe_write
+(struct inode *inode, const char *buf, size_t n, int nonblock)
 {
-	const char *w;
+	const char *w; /* Write pointer.       */
+	size_t chunk;  /* Bytes to copy.       */
+	int wasempty;  /* Was the pipe empty?  */
 
 	w = buf;
 
-	/* No readers. */
-	wakeup(&inode->chain);
-	if (inode->count != 2)
-	{
-		curr_proc->errno = -EPIPE;
-		sndsig(curr_proc, SIGPIPE);
-		return (-1);
-	}
-
 	/* Write to pipe. */
-	while (n-- > 0)
+	while (n > 0)
 	{
+		/* No readers. */
+		if (inode->count != 2)
+		{
+			curr_proc->errno = -EPIPE;
+			sndsig(curr_proc, SIGPIPE);
+			return (-1);
+		}
+
 		/* Sleep while pipe is full. */
-		while ((inode->head + 1)%inode->size == inode->tail)
+		if (inode->pipelen == (size_t)inode->size)
 		{
-			/* No readers. */
-			wakeup(&inode->chain);
-			if (inode->count != 2)
+			/* Would block. */
+			if (nonblock)
 			{
-				curr_proc->errno = -EPIPE;
-				sndsig(curr_proc, SIGPIPE);
+				/* Return what we have written so far. */
+				if (w != buf)
+					break;
+
+				curr_proc->errno = -EAGAIN;
 				return (-1);
 			}
 
@@ -108,13 +283,55 @@ PUBLIC ssize_t pipe_write(struct inode *inode, const char *buf, size_t n)
 				curr_proc->errno = -EINTR;
 				return (-1);
 			}
+
+			continue;
 		}
 
-		inode->pipe[inode->head] = *w++;
-		inode->head = (inode->head + 1)%inode->size;
-		wakeup(&inode->chain);
+		wasempty = (inode->pipelen == 0);
+
+		/* Copy contiguous segment. */
+		chunk = MIN(n, inode->size - inode->pipelen);
+		chunk = MIN(chunk, PIPE_CHUNK(inode->head));
+		kmemcpy(PIPE_ADDR(inode->pipe, inode->head), w, chunk);
+
+		w += chunk;
+		n -= chunk;
+		inode->head = (inode->head + chunk)%inode->size;
+		inode->pipelen += chunk;
+
+		/* Pipe is no longer empty. */
+		if (wasempty)
+		{
+			wakeup(&inode->chain);
+			pollwakeup(&inode->polls);
+		}
 	}
 
 	return (w - buf);
+}
+
+/*
+ * Checks whether a pipe is ready for I/O.
+ */
+PUBLIC int pipe_poll(struct inode *inode, int events)
+{
+	int revents = 0;
+
+	/* Other end closed. */
+	if (inode->count != 2)
+		return (POLLHUP | (events & (POLLIN | POLLRDNORM)));
+
+	/* Data to read. */
+	if (inode->pipelen > 0)
+		revents |= events & (POLLIN | POLLRDNORM);
+
+	/* Room to write. */
+	if (inode->pipelen < (size_t)inode->size)
+		revents |= events & (POLLOUT | POLLWRNORM);
+
+	/* Not ready. */
+	if (revents == 0)
+		pollrecord(&inode->polls);
 
+	return (revents);
 }
@@ -25,6 +25,7 @@
 #include <nanvix/dev.h>
 #include <nanvix/pm.h>
 #include <nanvix/mm.h>
+#include <nanvix/sem.h>
 #include <nanvix/syscall.h>
 #include <fcntl.h>
 
@@ -113,14 +114,17 @@ PRIVATE void init(void)
  */
 PUBLIC void kmain(void)
 {
-	pid_t pid;         /* Child process ID. */
-	struct process *p; /* Working process.  */
+	pid_t pid;            /* Child process ID. */
+	struct process *p;    /* Working process.  */
+	struct process *next; /* Next process.     */
 
 	/* Initialize system modules. */
 	dev_init();
+	smp_init();
 	mm_init();
 	pm_init();
 	fs_init();
+	sem_init();
 
 	chkout(DEVID(TTY_MAJOR, 0, CHRDEV));
 	kprintf(KERN_INFO "kout is now initialized");
@@ -135,30 +139,31 @@ PUBLIC void kmain(void)
 		_exit(-1);
 	}
 
+	/* Spawn kernel threads. */
+	if (kthread_create("kflushd", kflushd, NULL) < 0)
+		kpanic("failed to create kflushd");
+
 	/* idle process. */
 	while (1)
 	{
-		/* Shutting down.*/
-		if (shutting_down)
+		/* Bury zombie threads and, when shutting down, processes. */
+		for (p = curr_proc->children; p != NULL; p = next)
+		{
+			next = p->next_sibling;
+			if (p->state == PROC_ZOMBIE)
+				bury(p);
+		}
+
+		/* Halt system. */
+		if ((shutting_down) && (nprocs == 1))
 		{
-			/* Bury zombie processes. */
-			for (p = FIRST_PROC; p <= LAST_PROC; p++)
-			{
-				if ((p->state == PROC_ZOMBIE) && (p->father == curr_proc))
-					bury(p);
-			}
-
-			/* Halt system. */
-			if (nprocs == 1)
-			{
-				kprintf("you may now turn off your computer");
-				disable_interrupts();
-				while (1)
-					halt();
-			}
+			kprintf("you may now turn off your computer");
+			disable_interrupts();
+			while (1)
+				halt();
 		}
 
-		halt();
+		idle();
 		yield();
 	}
 }
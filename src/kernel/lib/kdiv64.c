@@ -0,0 +1,58 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <stdint.h>
+
+/**
+ * @brief Divides a 64-bit integer by a 32-bit one.
+ *
+ * @details The kernel is not linked against libgcc, so 64-bit divisions
+ *          have to be carried out by hand.
+ *
+ * @param n   Dividend.
+ * @param d   Divisor.
+ * @param rem Store location for the remainder (may be NULL).
+ *
+ * @returns The quotient of @p n by @p d.
+ */
+PUBLIC uint64_t kdiv64(uint64_t n, uint32_t d, uint32_t *rem)
+{
+	uint64_t q; /* Quotient.  */
+	uint64_t r; /* Remainder. */
+
+	q = 0;
+	r = 0;
+
+	for (int i = 63; i >= 0; i--)
+	{
+		r = (r << 1) | ((n >> i) & 1);
+
+		if (r >= d)
+		{
+			r -= d;
+			q |= (uint64_t)1 << i;
+		}
+	}
+
+	if (rem != NULL)
+		*rem = (uint32_t)r;
+
+	return (q);
+}
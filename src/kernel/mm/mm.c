@@ -22,6 +22,7 @@
 #include <nanvix/region.h>
 #include <nanvix/klib.h>
 #include <nanvix/mm.h>
+#include <nanvix/vdso.h>
 
 /*
  * Bad KPOOL_PHYS ?
@@ -71,7 +72,9 @@
  */
 PUBLIC void mm_init(void)
 {
+	kmalloc_init();
 	initreg();
+	vdso_init();
 }
 
 /**
@@ -102,6 +105,13 @@ PUBLIC int chkmem(const void *addr, size_t size, mode_t mask)
 		return (-1);
 	}
 
+	/* Attached read-only. */
+	if ((mask & MAY_WRITE) && (preg->flags & PREGION_RDONLY))
+	{
+		unlockreg(reg);
+		return (-1);
+	}
+
 	ret = withinreg(preg, ADDR(addr));
 	ret &= withinreg(preg, ADDR(addr) + size);
 
@@ -25,10 +25,14 @@
 	#define PAGE_ZERO 1 /* Demand zero. */
 
 	/* Forward definitions. */
+	EXTERN int kpgcount(const void *);
+	EXTERN int privpgtab(struct process *, struct region *, unsigned);
 	EXTERN void freeupg(struct pte *);
+	EXTERN void linkkpg(void *);
 	EXTERN void linkupg(struct pte *, struct pte *);
 	EXTERN void mappgtab(struct process *, addr_t, void *);
 	EXTERN void markpg(struct pte *, int);
+	EXTERN void protpgtab(struct process *, addr_t);
 	EXTERN void umappgtab(struct process *, addr_t);
 
 #endif /* _MM_H_ */
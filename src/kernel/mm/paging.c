@@ -26,6 +26,7 @@
 #include <nanvix/klib.h>
 #include <nanvix/mm.h>
 #include <nanvix/region.h>
+#include <nanvix/vdso.h>
 #include <signal.h>
 #include "mm.h"
 
@@ -58,6 +59,47 @@
 #define getpte(p, a) \
 	(&((struct pte *)((getpde(p, a)->frame << PAGE_SHIFT) + KBASE_VIRT))[PG(a)])
 
+/**
+ * @brief Lets the kernel fill in a user page.
+ *
+ * @details The kernel honors write protection, so the page and its page
+ *          table are temporarily mapped writable in the current running
+ *          process. The caller must not sleep until upgclose() is called.
+ *
+ * @param addr Address of the page.
+ *
+ * @returns The previous protection of the page, to be passed to upgclose().
+ */
+PRIVATE unsigned upgopen(addr_t addr)
+{
+	unsigned prot;   /* Previous protection.  */
+	struct pde *pde; /* Page directory entry. */
+	struct pte *pg;  /* Page table entry.     */
+
+	pde = getpde(curr_proc, addr);
+	pg = getpte(curr_proc, addr);
+
+	prot = (pde->writable << 1) | pg->writable;
+	pde->writable = 1;
+	pg->writable = 1;
+	tlb_flush();
+
+	return (prot);
+}
+
+/**
+ * @brief Restores the protection of a user page.
+ *
+ * @param addr Address of the page.
+ * @param prot Protection returned by upgopen().
+ */
+PRIVATE void upgclose(addr_t addr, unsigned prot)
+{
+	getpde(curr_proc, addr)->writable = (prot >> 1) & 1;
+	getpte(curr_proc, addr)->writable = prot & 1;
+	tlb_flush();
+}
+
 /*============================================================================*
  *                             Swapping System                                *
  *============================================================================*/
@@ -163,6 +205,7 @@ PRIVATE int swap_in(unsigned frame, addr_t addr)
 	off_t off;      /* Offset in swap device.        */
 	ssize_t n;      /* # bytes read.                 */
 	void *kpg;      /* Kernel page used for copying. */
+	unsigned prot;  /* Protection of the page.       */
 
 	addr &= PAGE_MASK;
 	pg = getpte(curr_proc, addr);
@@ -187,9 +230,12 @@ PRIVATE int swap_in(unsigned frame, addr_t addr)
 	tlb_flush();
 
 	/* Copy page. */
+	prot = upgopen(addr);
 	kmemcpy((void *)addr, kpg, PAGE_SIZE);
+	upgclose(addr, prot);
 	pg->accessed = 0;
 	pg->dirty = 0;
+	tlb_flush();
 
 	putkpg(kpg);
 	return (0);
@@ -205,8 +251,7 @@ error0:
  *============================================================================*/
 
 /* Kernel pages. */
-#define NR_KPAGES (KPOOL_SIZE/PAGE_SIZE) /* Number of kernel pages.  */
-PRIVATE int kpages[NR_KPAGES] = { 0,  }; /* Reference count.         */
+PRIVATE int kpages[NR_KPAGES] = { 0,  }; /* Reference count. */
 
 /**
  * @brief Allocates a kernel page.
@@ -246,6 +291,28 @@ found:
 	return (kpg);
 }
 
+/**
+ * @brief Adds a reference to a kernel page.
+ *
+ * @param kpg Kernel page to be linked.
+ */
+PUBLIC void linkkpg(void *kpg)
+{
+	kpages[((addr_t)kpg - KPOOL_VIRT) >> PAGE_SHIFT]++;
+}
+
+/**
+ * @brief Gets the reference count of a kernel page.
+ *
+ * @param kpg Kernel page to be queried.
+ *
+ * @returns The number of references to @p kpg.
+ */
+PUBLIC int kpgcount(const void *kpg)
+{
+	return (kpages[((addr_t)kpg - KPOOL_VIRT) >> PAGE_SHIFT]);
+}
+
 /**
  * @brief Releases kernel page.
  *
@@ -399,30 +466,36 @@ PRIVATE int allocupg(addr_t addr, int writable)
 /**
  * @brief Reads a page from a file.
  *
- * @param reg  Region where the page resides.
+ * @param preg Process region where the page resides.
  * @param addr Address where the page should be loaded.
  *
  * @returns Zero upon successful completion, and non-zero upon failure.
  */
-PRIVATE int readpg(struct region *reg, addr_t addr)
+PRIVATE int readpg(struct pregion *preg, addr_t addr)
 {
 	char *p;             /* Read pointer.             */
 	off_t off;           /* Block offset.             */
 	ssize_t count;       /* Bytes read.               */
 	struct inode *inode; /* File inode.               */
 	struct pte *pg;      /* Working page table entry. */
+	struct region *reg;  /* Working memory region.    */
 
+	reg = preg->reg;
 	addr &= PAGE_MASK;
 
-	/* Assign a user page. */
-	if (allocupg(addr, reg->mode & MAY_WRITE))
+	/*
+	 * Assign a user page. It is writable
+	 * until filled in, since the kernel
+	 * honors write protection.
+	 */
+	if (allocupg(addr, 1))
 		return (-1);
 
 	/* Find page table entry. */
 	pg = getpte(curr_proc, addr);
 
 	/* Read page. */
-	off = reg->file.off + (PG(addr) << PAGE_SHIFT);
+	off = reg->file.off + (addr - preg->start);
 	inode = reg->file.inode;
 	p = (char *)(addr & PAGE_MASK);
 	count = file_read(inode, p, PAGE_SIZE, off);
@@ -438,6 +511,11 @@ PRIVATE int readpg(struct region *reg, addr_t addr)
 	else if (count < PAGE_SIZE)
 		kmemset(p + count, 0, PAGE_SIZE - count);
 
+	/* Page is in sync with the file. */
+	pg->dirty = 0;
+	pg->writable = (reg->mode & MAY_WRITE) ? 1 : 0;
+	tlb_flush();
+
 	return (0);
 }
 
@@ -458,9 +536,13 @@ PUBLIC void mappgtab(struct process *proc, addr_t addr, void *pgtab)
 	if (pde->present)
 		kpanic("busy page table entry");
 
-	/* Map kernel page. */
+	/*
+	 * Map kernel page. Page tables that are shared
+	 * with other regions are mapped read-only, so
+	 * that they are copied on the first write.
+	 */
 	pde->present = 1;
-	pde->writable = 1;
+	pde->writable = (kpgcount(pgtab) == 1);
 	pde->user = 1;
 	pde->frame = (ADDR(pgtab) - KBASE_VIRT) >> PAGE_SHIFT;
 
@@ -469,6 +551,29 @@ PUBLIC void mappgtab(struct process *proc, addr_t addr, void *pgtab)
 		tlb_flush();
 }
 
+/**
+ * @brief Write-protects a page table in user address space.
+ *
+ * @param proc Process in which the page table is mapped.
+ * @param addr Address where the page table is mapped.
+ */
+PUBLIC void protpgtab(struct process *proc, addr_t addr)
+{
+	struct pde *pde;
+
+	pde = &proc->pgdir[PGTAB(addr)];
+
+	/* Bad page table. */
+	if (!(pde->present))
+		kpanic("write-protect non-present page table");
+
+	pde->writable = 0;
+
+	/* Flush changes. */
+	if (proc == curr_proc)
+		tlb_flush();
+}
+
 /**
  * @brief Unmaps a page table from user address space.
  *
@@ -589,34 +694,22 @@ PUBLIC void linkupg(struct pte *upg1, struct pte *upg2)
 }
 
 /**
- * @brief Creates a page directory for a process.
+ * @brief Clones the kernel stack of the current running process.
  *
  * @param proc Target process.
  *
  * @returns Upon successful completion, zero is returned. Upon failure, non-zero
  *          is returned instead.
  */
-PUBLIC int crtpgdir(struct process *proc)
+PRIVATE int cpykstack(struct process *proc)
 {
 	void *kstack;             /* Kernel stack.     */
-	struct pde *pgdir;        /* Page directory.   */
 	struct intstack *s1, *s2; /* Interrupt stacks. */
 
-	/* Get kernel page for page directory. */
-	pgdir = getkpg(1);
-	if (pgdir == NULL)
-		goto err0;
-
 	/* Get kernel page for kernel stack. */
 	kstack = getkpg(0);
 	if (kstack == NULL)
-		goto err1;
-
-	/* Build page directory. */
-	pgdir[0] = curr_proc->pgdir[0];
-	pgdir[PGTAB(KBASE_VIRT)] = curr_proc->pgdir[PGTAB(KBASE_VIRT)];
-	pgdir[PGTAB(KPOOL_VIRT)] = curr_proc->pgdir[PGTAB(KPOOL_VIRT)];
-	pgdir[PGTAB(INITRD_VIRT)] = curr_proc->pgdir[PGTAB(INITRD_VIRT)];
+		return (-1);
 
 	/* Clone kernel stack. */
 	kmemcpy(kstack, curr_proc->kstack, KSTACK_SIZE);
@@ -629,10 +722,60 @@ PUBLIC int crtpgdir(struct process *proc)
 		s2 = (struct intstack *) proc->kesp;
 		s2->ebp = (s1->ebp - (dword_t)curr_proc->kstack) + (dword_t)kstack;
 	}
+	proc->kstack = kstack;
+
+	return (0);
+}
+
+/**
+ * @brief Builds a page directory that maps only the kernel.
+ *
+ * @returns Upon successful completion, a pointer to the new page directory is
+ *          returned. Upon failure, a NULL pointer is returned instead.
+ */
+PRIVATE struct pde *kpgdir(void)
+{
+	struct pde *pgdir;
+
+	/* Get kernel page for page directory. */
+	pgdir = getkpg(1);
+	if (pgdir == NULL)
+		return (NULL);
+
+	/* Build page directory. */
+	pgdir[0] = curr_proc->pgdir[0];
+	pgdir[PGTAB(KBASE_VIRT)] = curr_proc->pgdir[PGTAB(KBASE_VIRT)];
+	pgdir[PGTAB(KPOOL_VIRT)] = curr_proc->pgdir[PGTAB(KPOOL_VIRT)];
+	pgdir[PGTAB(INITRD_VIRT)] = curr_proc->pgdir[PGTAB(INITRD_VIRT)];
+	pgdir[PGTAB(VDSO_ADDR)] = curr_proc->pgdir[PGTAB(VDSO_ADDR)];
+
+	return (pgdir);
+}
+
+/**
+ * @brief Creates a page directory for a process.
+ *
+ * @param proc Target process.
+ *
+ * @returns Upon successful completion, zero is returned. Upon failure, non-zero
+ *          is returned instead.
+ */
+PUBLIC int crtpgdir(struct process *proc)
+{
+	struct pde *pgdir; /* Page directory. */
+
+	/* Get kernel page for page directory. */
+	pgdir = kpgdir();
+	if (pgdir == NULL)
+		goto err0;
+
+	/* Get kernel page for kernel stack. */
+	if (cpykstack(proc))
+		goto err1;
+
 	/* Assign page directory. */
 	proc->cr3 = ADDR(pgdir) - KBASE_VIRT;
 	proc->pgdir = pgdir;
-	proc->kstack = kstack;
 
 	return (0);
 
@@ -642,6 +785,68 @@ err0:
 	return (-1);
 }
 
+/**
+ * @brief Shares the page directory of the current running process.
+ *
+ * @details The target process borrows the whole address space of the current
+ *          running process, until it calls unshrpgdir().
+ *
+ * @param proc Target process.
+ *
+ * @returns Upon successful completion, zero is returned. Upon failure, non-zero
+ *          is returned instead.
+ */
+PUBLIC int shrpgdir(struct process *proc)
+{
+	/* Get kernel page for kernel stack. */
+	if (cpykstack(proc))
+		return (-1);
+
+	/* Borrow page directory. */
+	proc->cr3 = curr_proc->cr3;
+	proc->pgdir = curr_proc->pgdir;
+
+	return (0);
+}
+
+/**
+ * @brief Gives back a borrowed page directory.
+ *
+ * @details The current running process gets a fresh page directory, where
+ *          only the kernel is mapped. If @p force is not zero and no memory is
+ *          left, the page directory of the idle process is used instead, so
+ *          this function cannot fail.
+ *
+ * @param force Use the idle page directory as fallback?
+ *
+ * @returns Upon successful completion, zero is returned. Upon failure, non-zero
+ *          is returned instead.
+ */
+PUBLIC int unshrpgdir(int force)
+{
+	struct pde *pgdir; /* Page directory. */
+
+	pgdir = kpgdir();
+
+	/* Switch page directory. */
+	if (pgdir != NULL)
+	{
+		curr_proc->cr3 = ADDR(pgdir) - KBASE_VIRT;
+		curr_proc->pgdir = pgdir;
+	}
+	else if (force)
+	{
+		curr_proc->cr3 = IDLE->cr3;
+		curr_proc->pgdir = IDLE->pgdir;
+	}
+	else
+		return (-1);
+
+	pgdir_flush(curr_proc->cr3);
+
+	return (0);
+}
+
 /**
  * @brief Destroys the page directory of a process.
  *
@@ -652,7 +857,10 @@ err0:
 PUBLIC void dstrypgdir(struct process *proc)
 {
 	putkpg(proc->kstack);
-	putkpg(proc->pgdir);
+
+	/* Idle page directory is not ours. */
+	if (proc->pgdir != IDLE->pgdir)
+		putkpg(proc->pgdir);
 }
 
 /**
@@ -665,6 +873,8 @@ PUBLIC void dstrypgdir(struct process *proc)
  */
 PUBLIC int vfault(addr_t addr)
 {
+	unsigned i;           /* Page table index.                     */
+	unsigned prot;        /* Protection of the page.               */
 	int frame;            /* Frame index of page to be swapped in. */
 	struct pte *pg;       /* Working page.                         */
 	struct region *reg;   /* Working region.                       */
@@ -691,23 +901,45 @@ PUBLIC int vfault(addr_t addr)
 			goto error1;
 	}
 
-	pg = (reg->flags & REGION_DOWNWARDS) ?
-		&reg->pgtab[REGION_PGTABS-(PGTAB(preg->start)-PGTAB(addr))-1][PG(addr)]:
-		&reg->pgtab[PGTAB(addr) - PGTAB(preg->start)][PG(addr)];
+	i = (reg->flags & REGION_DOWNWARDS) ?
+		REGION_PGTABS - (PGTAB(preg->start) - PGTAB(addr)) - 1 :
+		PGTAB(addr) - PGTAB(preg->start);
+
+	/*
+	 * Page table is shared. Make it private before
+	 * touching it, otherwise the page would show up
+	 * in the other processes that share it.
+	 */
+	if ((!getpde(curr_proc, addr)->writable) && !(preg->flags & PREGION_RDONLY))
+	{
+		if (privpgtab(curr_proc, reg, i))
+			goto error1;
+	}
+
+	pg = &reg->pgtab[i][PG(addr)];
+
+	/* Page was brought in while we slept. */
+	if (pg->present)
+	{
+		unlockreg(reg);
+		return (0);
+	}
 
 	/* Clear page. */
 	if (pg->zero)
 	{
 		if (allocupg(addr, reg->mode & MAY_WRITE))
 			goto error1;
+		prot = upgopen(addr);
 		kmemset((void *)(addr & PAGE_MASK), 0, PAGE_SIZE);
+		upgclose(addr, prot);
 	}
 
 	/* Load page from executable file. */
 	else if (pg->fill)
 	{
 		/* Read page. */
-		if (readpg(reg, addr))
+		if (readpg(preg, addr))
 			goto error1;
 	}
 
@@ -753,11 +985,31 @@ PUBLIC int pfault(addr_t addr)
 	if ((preg == NULL) || (!withinreg(preg, addr)))
 		goto error0;
 
+	/* Attached read-only. */
+	if (preg->flags & PREGION_RDONLY)
+		goto error0;
+
 	lockreg(reg = preg->reg);
 
-	pg = (reg->flags & REGION_DOWNWARDS) ?
-		&reg->pgtab[REGION_PGTABS-(PGTAB(preg->start)-PGTAB(addr))-1][PG(addr)]:
-		&reg->pgtab[PGTAB(addr) - PGTAB(preg->start)][PG(addr)];
+	i = (reg->flags & REGION_DOWNWARDS) ?
+		REGION_PGTABS - (PGTAB(preg->start) - PGTAB(addr)) - 1 :
+		PGTAB(addr) - PGTAB(preg->start);
+
+	/* Page table is shared. */
+	if (!getpde(curr_proc, addr)->writable)
+	{
+		if (privpgtab(curr_proc, reg, i))
+			goto error1;
+
+		/* Page was already writable. */
+		if (reg->pgtab[i][PG(addr)].writable)
+		{
+			unlockreg(reg);
+			return (0);
+		}
+	}
+
+	pg = &reg->pgtab[i][PG(addr)];
 
 	/* Copy on write not enabled. */
 	if (!pg->cow)
@@ -35,6 +35,66 @@
  */
 PRIVATE struct region regtab[NR_REGIONS];
 
+/**
+ * @brief Gets the address where a page table of a memory region is mapped.
+ *
+ * @param reg Memory region.
+ * @param i   Index of the page table.
+ *
+ * @returns The address where the @p i th page table of @p reg is mapped.
+ */
+#define pgtabaddr(reg, i)                                           \
+	(((reg)->flags & REGION_DOWNWARDS) ?                            \
+		(reg)->preg->start - (REGION_PGTABS - 1 - (i))*PGTAB_SIZE : \
+		(reg)->preg->start + (i)*PGTAB_SIZE)
+
+/**
+ * @brief Makes a page table of a memory region private.
+ *
+ * @details If the @p i th page table of the memory region pointed to by @p reg
+ *          is shared with other memory regions, a private copy of it is
+ *          created, and underlying pages are linked as copy on write. The
+ *          page table is then remapped as writable in @p proc.
+ *
+ * @param proc Process where the memory region is attached (may be NULL).
+ * @param reg  Memory region.
+ * @param i    Index of the page table.
+ *
+ * @returns Zero upon success, and non-zero otherwise.
+ */
+PUBLIC int privpgtab(struct process *proc, struct region *reg, unsigned i)
+{
+	unsigned j;        /* Loop index.         */
+	struct pte *pgtab; /* Private page table. */
+
+	/* Nothing to be done. */
+	if (reg->pgtab[i] == NULL)
+		return (0);
+
+	/* Copy page table. */
+	if (kpgcount(reg->pgtab[i]) > 1)
+	{
+		if ((pgtab = getkpg(1)) == NULL)
+			return (-1);
+
+		/* Link underlying pages. */
+		for (j = 0; j < PAGE_SIZE/PTE_SIZE; j++)
+			linkupg(&reg->pgtab[i][j], &pgtab[j]);
+
+		putkpg(reg->pgtab[i]);
+		reg->pgtab[i] = pgtab;
+	}
+
+	/* Remap page table. */
+	if (proc != NULL)
+	{
+		umappgtab(proc, pgtabaddr(reg, i));
+		mappgtab(proc, pgtabaddr(reg, i), reg->pgtab[i]);
+	}
+
+	return (0);
+}
+
 /**
  * @brief Expands a memory region.
  *
@@ -57,6 +117,17 @@ PRIVATE int expand(struct process *proc, struct region *reg, size_t size)
 	preg = reg->preg;
 	npages = size >> PAGE_SHIFT;
 
+	/* Last page table may be shared. */
+	if (reg->size != 0)
+	{
+		i = (reg->flags & REGION_DOWNWARDS) ?
+			REGION_PGTABS - (reg->size >> PGTAB_SHIFT) - 1 :
+			reg->size >> PGTAB_SHIFT;
+
+		if (privpgtab(proc, reg, i))
+			return (-1);
+	}
+
 	/* Expand downwards. */
 	if (reg->flags & REGION_DOWNWARDS)
 	{
@@ -188,6 +259,13 @@ PRIVATE int contract(struct process *proc, struct region *reg, size_t size)
 	if (size > reg->size)
 		return (-1);
 
+	/* Page tables may be shared. */
+	for (i = 0; i < REGION_PGTABS; i++)
+	{
+		if (privpgtab(proc, reg, i))
+			return (-1);
+	}
+
 	preg = reg->preg;
 	npages = reg->size >> PAGE_SHIFT;
 
@@ -367,8 +445,11 @@ PUBLIC void freereg(struct region *reg)
 			continue;
 
 		/* Free underlying pages. */
-		for (j = 0; j < PAGE_SIZE/PTE_SIZE; j++)
-			freeupg(&reg->pgtab[i][j]);
+		if (kpgcount(reg->pgtab[i]) == 1)
+		{
+			for (j = 0; j < PAGE_SIZE/PTE_SIZE; j++)
+				freeupg(&reg->pgtab[i][j]);
+		}
 		putkpg(reg->pgtab[i]);
 	}
 
@@ -397,6 +478,10 @@ PUBLIC int editreg(struct region *reg, uid_t uid, gid_t gid, mode_t mode)
 /**
  * @brief Attaches a memory region to a process.
  *
+ * @details If @p preg is flagged as PREGION_RDONLY, page tables are mapped
+ *          write-protected, so that the process may only read the memory
+ *          region, no matter the access permissions of it.
+ *
  * @param proc  Process where the memory region shall be attached.
  * @param preg  Process memory region where the memory shall be attached.
  * @param start Address where the memory region shall be attached.
@@ -438,7 +523,7 @@ PUBLIC int attachreg
 	}
 
 	/* Process cannot grow more. */
-	if (proc->size + reg->size > PROC_SIZE_MAX)
+	if (proc->tg->size + reg->size > PROC_SIZE_MAX)
 		return (-1);
 
 	/* Attaching shared region. */
@@ -465,7 +550,11 @@ PUBLIC int attachreg
 		{
 			/* Map only valid page tables. */
 			if (reg->pgtab[i - 1] != NULL)
+			{
 				mappgtab(proc, addr, reg->pgtab[i - 1]);
+				if (preg->flags & PREGION_RDONLY)
+					protpgtab(proc, addr);
+			}
 			addr -= PGTAB_SIZE;
 		}
 	}
@@ -475,7 +564,11 @@ PUBLIC int attachreg
 		{
 			/* Map only valid page tables. */
 			if (reg->pgtab[i] != NULL)
+			{
 				mappgtab(proc, addr, reg->pgtab[i]);
+				if (preg->flags & PREGION_RDONLY)
+					protpgtab(proc, addr);
+			}
 			addr += PGTAB_SIZE;
 		}
 	}
@@ -485,7 +578,7 @@ PUBLIC int attachreg
 	preg->reg = reg;
 	reg->count++;
 	reg->preg = preg;
-	proc->size += reg->size;
+	proc->tg->size += reg->size;
 
 	return (0);
 }
@@ -508,6 +601,10 @@ PUBLIC void detachreg(struct process *proc, struct pregion *preg)
 
 	lockreg(reg);
 
+	/* Write back shared file mapping. */
+	if (proc == curr_proc)
+		syncreg(preg);
+
 	/* Detach region. */
 	addr = preg->start;
 	if (reg->flags & REGION_DOWNWARDS)
@@ -531,7 +628,8 @@ PUBLIC void detachreg(struct process *proc, struct pregion *preg)
 		}
 	}
 	preg->reg = NULL;
-	proc->size -= reg->size;
+	preg->flags = 0;
+	proc->tg->size -= reg->size;
 	if (--reg->count < 0)
 		kpanic("mm: detaching memory region twice");
 
@@ -549,10 +647,12 @@ PUBLIC void detachreg(struct process *proc, struct pregion *preg)
  *
  * @returns Upon success a pointer to the (duplicated) memory region is
  *          returned. Upon failure, a NULL pointer is returned instead.
+ *
+ * @note @p reg must be attached to the current running process.
  */
 PUBLIC struct region *dupreg(struct region *reg)
 {
-	unsigned i, j;          /* Loop index.        */
+	unsigned i;             /* Loop index.        */
 	struct region *new_reg; /* New memory region. */
 
 	/* Shared region. */
@@ -560,20 +660,29 @@ PUBLIC struct region *dupreg(struct region *reg)
 		return (reg);
 
 	/* Failed to allocate new region. */
-	if ((new_reg = allocreg(reg->mode, reg->size, reg->flags)) == NULL)
+	if ((new_reg = allocreg(reg->mode, 0, reg->flags)) == NULL)
 		return (NULL);
 
-	/* Link underlying page tables. */
+	/*
+	 * Share underlying page tables. These are write-protected
+	 * in the current process and copied on the first write,
+	 * see privpgtab().
+	 */
 	for (i = 0; i < REGION_PGTABS; i++)
 	{
+		if (new_reg->pgtab[i] != NULL)
+			putkpg(new_reg->pgtab[i]);
+
+		new_reg->pgtab[i] = reg->pgtab[i];
+
 		/* Skip invalid page tables. */
 		if (reg->pgtab[i] == NULL)
 			continue;
 
-		/* Link underlying pages. */
-		for (j = 0; j < PAGE_SIZE/PTE_SIZE; j++)
-			linkupg(&reg->pgtab[i][j], &new_reg->pgtab[i][j]);
+		linkkpg(reg->pgtab[i]);
+		protpgtab(curr_proc, pgtabaddr(reg, i));
 	}
+	new_reg->size = reg->size;
 
 	/* Copy region fields. */
 	if (reg->file.inode != NULL)
@@ -616,7 +725,7 @@ PUBLIC int growreg(struct process *proc, struct pregion *preg, ssize_t size)
 	else
 	{
 		/* Process cannot grow more. */
-		if (proc->size + size > PROC_SIZE_MAX)
+		if (proc->tg->size + size > PROC_SIZE_MAX)
 			return (-ENOMEM);
 
 		/* Failed to expand region.  */
@@ -625,7 +734,7 @@ PUBLIC int growreg(struct process *proc, struct pregion *preg, ssize_t size)
 	}
 
 	/* Change process and region sizse. */
-	proc->size += size;
+	proc->tg->size += size;
 
 	return (0);
 }
@@ -644,8 +753,19 @@ PUBLIC struct pregion *findreg(struct process *proc, addr_t addr)
 	struct region *reg;   /* Working memory region.  */
 	struct pregion *preg; /* Working process region. */
 
+	/*
+	 * Memory maps are laid out in address order, one
+	 * per slot, so they may be looked up straight away.
+	 */
+	if ((addr >= UMMAP_ADDR) && (addr - UMMAP_ADDR < NR_MMAPS*REGION_SIZE))
+	{
+		preg = MMAP(proc, (addr - UMMAP_ADDR)/REGION_SIZE);
+
+		return ((preg->reg != NULL) ? preg : NULL);
+	}
+
 	/* Find associated region. */
-	for (preg = &proc->pregs[0]; preg < &proc->pregs[NR_PREGIONS]; preg++)
+	for (preg = &proc->tg->pregs[0]; preg < MMAP(proc, 0); preg++)
 	{
 		/* Skip invalid regions. */
 		if ((reg = preg->reg) == NULL)
@@ -675,6 +795,116 @@ PUBLIC struct pregion *findreg(struct process *proc, addr_t addr)
 	return (NULL);
 }
 
+/**
+ * @brief Looks up a shared memory region that maps a file.
+ *
+ * @details Only memory regions that have exactly the access permissions
+ *          @p mode, and that the current running process may access, are
+ *          considered. Otherwise, a mapping could gain (or lose) write access
+ *          by attaching a memory region that someone else has created.
+ *
+ * @param inode Inode associated to the file.
+ * @param off   File offset.
+ * @param size  Minimum size of the memory region.
+ * @param mode  Access permissions of the memory region.
+ *
+ * @returns Upon success, a pointer to the locked memory region is returned.
+ *          Upon failure, a NULL pointer is returned instead.
+ */
+PUBLIC struct region *lookupreg
+(struct inode *inode, off_t off, size_t size, mode_t mode)
+{
+	struct region *reg; /* Working memory region. */
+
+again:
+
+	for (reg = &regtab[0]; reg < &regtab[NR_REGIONS]; reg++)
+	{
+		/* Skip free and private regions. */
+		if ((reg->flags & REGION_FREE) || !(reg->flags & REGION_SHARED))
+			continue;
+
+		/* Skip regions that map something else. */
+		if ((reg->file.inode != inode) || (reg->file.off != off))
+			continue;
+
+		/* Region is too small. */
+		if (reg->size < size)
+			continue;
+
+		/* Access permissions do not match. */
+		if ((reg->mode != mode) || (!accessreg(curr_proc, reg)))
+			continue;
+
+		lockreg(reg);
+
+		/* Region has changed while we slept. */
+		if ((reg->flags & REGION_FREE) || (reg->file.inode != inode))
+		{
+			unlockreg(reg);
+			goto again;
+		}
+
+		return (reg);
+	}
+
+	return (NULL);
+}
+
+/**
+ * @brief Writes back dirty pages of a shared file mapping.
+ *
+ * @param preg Process memory region to be synchronized.
+ *
+ * @returns Zero upon success, and non-zero otherwise.
+ *
+ * @note @p preg must be attached to the current running process.
+ */
+PUBLIC int syncreg(struct pregion *preg)
+{
+	unsigned i;          /* Loop index.            */
+	addr_t addr;         /* Page address.          */
+	off_t off;           /* File offset.           */
+	size_t n;            /* Bytes to write.        */
+	struct pte *pg;      /* Working page.          */
+	struct inode *inode; /* File inode.            */
+	struct region *reg;  /* Working memory region. */
+
+	reg = preg->reg;
+	inode = reg->file.inode;
+
+	/* Not a shared file mapping. */
+	if (!(reg->flags & REGION_SHARED) || (inode == NULL))
+		return (0);
+
+	for (i = 0; i < (reg->size >> PAGE_SHIFT); i++)
+	{
+		pg = &reg->pgtab[i/(PAGE_SIZE/PTE_SIZE)][i%(PAGE_SIZE/PTE_SIZE)];
+
+		/* Page is clean. */
+		if (!pg->present || !pg->dirty)
+			continue;
+
+		off = reg->file.off + (i << PAGE_SHIFT);
+
+		/* Mapped files do not grow. */
+		if (off >= inode->size)
+			break;
+
+		n = (inode->size - off < PAGE_SIZE) ? inode->size - off : PAGE_SIZE;
+
+		/* Clear dirty bit before writing, so that we catch new writes. */
+		pg->dirty = 0;
+		tlb_flush();
+
+		addr = preg->start + (i << PAGE_SHIFT);
+		if (file_write(inode, (void *)addr, n, off) < 0)
+			return (-1);
+	}
+
+	return (0);
+}
+
 /**
  * @brief Loads a portion of a file into a memory region.
  *
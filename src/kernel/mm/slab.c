@@ -0,0 +1,367 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/klib.h>
+#include <nanvix/mm.h>
+#include <sys/types.h>
+
+/**
+ * @brief Maximum number of object caches.
+ */
+#define NR_KCACHES 16
+
+/**
+ * @brief Smallest object size handled by kmalloc().
+ */
+#define KMALLOC_MIN 16
+
+/**
+ * @brief Largest object size handled by a kmalloc() cache.
+ *
+ * @details Requests larger than this are served with whole kernel pages.
+ */
+#define KMALLOC_MAX (PAGE_SIZE/2)
+
+/**
+ * @brief Slab descriptor.
+ *
+ * @details Descriptors are kept off-slab, one per kernel page, so that objects
+ *          can use up the whole page.
+ */
+struct slab
+{
+	struct kcache *cache; /**< Owner cache (NULL if not a slab). */
+	struct slab *next;    /**< Next slab with free objects.      */
+	void *free;           /**< Free objects list.                */
+	unsigned nfree;       /**< Number of free objects.           */
+};
+
+/**
+ * @brief Object cache.
+ */
+struct kcache
+{
+	const char *name;     /**< Cache name.                    */
+	size_t size;          /**< Object size.                   */
+	unsigned nobjs;       /**< Number of objects per slab.    */
+	struct slab *partial; /**< Slabs with free objects.       */
+	unsigned nslabs;      /**< Number of slabs.               */
+	unsigned nused;       /**< Number of objects in use.      */
+	unsigned nallocs;     /**< Number of successful allocs.   */
+	unsigned nfrees;      /**< Number of frees.               */
+	unsigned nfails;      /**< Number of failed allocations.  */
+};
+
+/**
+ * @brief Slab descriptors.
+ */
+PRIVATE struct slab slabs[NR_KPAGES];
+
+/**
+ * @brief Object caches.
+ */
+PRIVATE struct kcache kcaches[NR_KCACHES];
+
+/**
+ * @brief Number of object caches in use.
+ */
+PRIVATE unsigned nr_kcaches = 0;
+
+/**
+ * @brief General purpose caches used by kmalloc().
+ */
+PRIVATE struct kcache *kmalloc_caches[8];
+
+/**
+ * @brief Number of whole pages handed out by kmalloc().
+ */
+PRIVATE unsigned kmalloc_npages = 0;
+
+/**
+ * @brief Names of kmalloc() caches.
+ */
+PRIVATE const char *kmalloc_names[8] = {
+	"kmalloc-16",  "kmalloc-32",  "kmalloc-64",   "kmalloc-128",
+	"kmalloc-256", "kmalloc-512", "kmalloc-1024", "kmalloc-2048"
+};
+
+/**
+ * @brief Gets the slab descriptor of a kernel address.
+ *
+ * @param addr Target kernel address.
+ *
+ * @returns The slab descriptor associated to @p addr.
+ */
+#define SLAB(addr) \
+	(&slabs[((addr_t)(addr) - KPOOL_VIRT) >> PAGE_SHIFT])
+
+/**
+ * @brief Gets the base address of a slab.
+ *
+ * @param s Target slab descriptor.
+ *
+ * @returns The base address of the kernel page held by @p s.
+ */
+#define SLAB_ADDR(s) \
+	((void *)(KPOOL_VIRT + (((s) - slabs) << PAGE_SHIFT)))
+
+/**
+ * @brief Grows an object cache by one slab.
+ *
+ * @param cache Target cache.
+ *
+ * @returns Upon successful completion, the new slab is returned. Upon failure,
+ *          a NULL pointer is returned instead.
+ */
+PRIVATE struct slab *kcache_grow(struct kcache *cache)
+{
+	char *p;        /* Working object. */
+	void *kpg;      /* Slab page.      */
+	struct slab *s; /* Slab.           */
+
+	if ((kpg = getkpg(0)) == NULL)
+		return (NULL);
+
+	s = SLAB(kpg);
+	s->cache = cache;
+	s->nfree = cache->nobjs;
+	s->free = kpg;
+
+	/* Build free list. */
+	p = kpg;
+	for (unsigned i = 1; i < cache->nobjs; i++, p += cache->size)
+		*((void **)p) = p + cache->size;
+	*((void **)p) = NULL;
+
+	s->next = cache->partial;
+	cache->partial = s;
+	cache->nslabs++;
+
+	return (s);
+}
+
+/**
+ * @brief Creates an object cache.
+ *
+ * @param name Cache name.
+ * @param size Object size.
+ *
+ * @returns Upon successful completion, a pointer to the new cache is returned.
+ *          Upon failure, a NULL pointer is returned instead.
+ */
+PUBLIC struct kcache *kcache_create(const char *name, size_t size)
+{
+	struct kcache *cache;
+
+	/* Invalid object size. */
+	if ((size == 0) || (size > KMALLOC_MAX))
+		return (NULL);
+
+	/* Too many caches. */
+	if (nr_kcaches == NR_KCACHES)
+	{
+		kprintf("mm: object cache table overflow");
+		return (NULL);
+	}
+
+	cache = &kcaches[nr_kcaches++];
+	cache->name = name;
+	cache->size = ALIGN(size, sizeof(void *));
+	cache->nobjs = PAGE_SIZE/cache->size;
+	cache->partial = NULL;
+	cache->nslabs = 0;
+	cache->nused = 0;
+	cache->nallocs = 0;
+	cache->nfrees = 0;
+	cache->nfails = 0;
+
+	return (cache);
+}
+
+/**
+ * @brief Allocates an object from a cache.
+ *
+ * @param cache Target cache.
+ *
+ * @returns Upon successful completion, a pointer to a zeroed object is
+ *          returned. Upon failure, a NULL pointer is returned instead.
+ */
+PUBLIC void *kcache_alloc(struct kcache *cache)
+{
+	void *obj;      /* Object. */
+	struct slab *s; /* Slab.   */
+
+	/* Grow cache. */
+	if ((s = cache->partial) == NULL)
+	{
+		if ((s = kcache_grow(cache)) == NULL)
+		{
+			cache->nfails++;
+			return (NULL);
+		}
+	}
+
+	obj = s->free;
+	s->free = *((void **)obj);
+
+	/* Slab is now full. */
+	if (--s->nfree == 0)
+		cache->partial = s->next;
+
+	cache->nused++;
+	cache->nallocs++;
+
+	kmemset(obj, 0, cache->size);
+
+	return (obj);
+}
+
+/**
+ * @brief Releases an object to a cache.
+ *
+ * @param cache Target cache.
+ * @param obj   Object to be released.
+ */
+PUBLIC void kcache_free(struct kcache *cache, void *obj)
+{
+	struct slab *s;   /* Slab.          */
+	struct slab **pp; /* Previous link. */
+
+	s = SLAB(obj);
+
+	/* Bad object. */
+	if (s->cache != cache)
+		kpanic("mm: freeing object to wrong cache");
+
+	*((void **)obj) = s->free;
+	s->free = obj;
+
+	cache->nused--;
+	cache->nfrees++;
+
+	/* Slab was full. */
+	if (s->nfree++ == 0)
+	{
+		s->next = cache->partial;
+		cache->partial = s;
+	}
+
+	/* Slab still in use. */
+	if (s->nfree < cache->nobjs)
+		return;
+
+	/* Release empty slab. */
+	for (pp = &cache->partial; *pp != s; pp = &(*pp)->next)
+		/* noop */ ;
+	*pp = s->next;
+	s->cache = NULL;
+	s->next = NULL;
+	cache->nslabs--;
+	putkpg(SLAB_ADDR(s));
+}
+
+/**
+ * @brief Allocates kernel memory.
+ *
+ * @param size Number of bytes to allocate.
+ *
+ * @returns Upon successful completion, a pointer to a zeroed memory area of at
+ *          least @p size bytes is returned. Upon failure, a NULL pointer is
+ *          returned instead.
+ */
+PUBLIC void *kmalloc(size_t size)
+{
+	void *p;
+	unsigned i;
+	size_t csize;
+
+	/* Whole page. */
+	if (size > KMALLOC_MAX)
+	{
+		if (size > PAGE_SIZE)
+			return (NULL);
+
+		if ((p = getkpg(1)) != NULL)
+			kmalloc_npages++;
+
+		return (p);
+	}
+
+	/* Find best fit cache. */
+	for (i = 0, csize = KMALLOC_MIN; csize < size; i++, csize <<= 1)
+		/* noop */ ;
+
+	return (kcache_alloc(kmalloc_caches[i]));
+}
+
+/**
+ * @brief Releases kernel memory.
+ *
+ * @param ptr Memory area that was allocated with kmalloc().
+ */
+PUBLIC void kfree(void *ptr)
+{
+	struct slab *s;
+
+	if (ptr == NULL)
+		return;
+
+	s = SLAB(ptr);
+
+	/* Whole page. */
+	if (s->cache == NULL)
+	{
+		kmalloc_npages--;
+		putkpg(ptr);
+		return;
+	}
+
+	kcache_free(s->cache, ptr);
+}
+
+/**
+ * @brief Prints object cache statistics.
+ */
+PUBLIC void kcache_stats(void)
+{
+	struct kcache *c;
+
+	kprintf("CACHE          SIZE  SLABS   USED  ALLOCS   FREES  FAILS");
+
+	for (c = &kcaches[0]; c < &kcaches[nr_kcaches]; c++)
+	{
+		kprintf("%s %d %d %d %d %d %d", c->name, c->size, c->nslabs,
+			c->nused, c->nallocs, c->nfrees, c->nfails);
+	}
+
+	kprintf("kmalloc pages: %d", kmalloc_npages);
+}
+
+/**
+ * @brief Initializes the kernel memory allocator.
+ */
+PUBLIC void kmalloc_init(void)
+{
+	unsigned i;
+	size_t size;
+
+	for (i = 0, size = KMALLOC_MIN; size <= KMALLOC_MAX; i++, size <<= 1)
+		kmalloc_caches[i] = kcache_create(kmalloc_names[i], size);
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna   <pedrohenriquepenna@gmail.com>
+ *              2015-2016 Davidson Francis <davidsondfgl@hotmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/clock.h>
+#include <nanvix/const.h>
+#include <nanvix/klib.h>
+#include <nanvix/mm.h>
+#include <nanvix/pm.h>
+#include <nanvix/vdso.h>
+
+/**
+ * @brief Bad VDSO_ADDR?
+ */
+#if ((VDSO_ADDR < KMEM_SIZE) || (VDSO_ADDR + PGTAB_SIZE > UBASE_VIRT))
+	#error "bad VDSO_ADDR"
+#endif
+
+/**
+ * @brief Page directory of the idle process.
+ */
+EXTERN struct pde idle_pgdir[];
+
+/**
+ * @brief vDSO data page (NULL if not initialized yet).
+ */
+PRIVATE struct vdso *vdso = NULL;
+
+/**
+ * @brief Starts an update of the vDSO data page.
+ */
+#define vdso_begin() (vdso->seq++)
+
+/**
+ * @brief Ends an update of the vDSO data page.
+ */
+#define vdso_end() (vdso->seq++)
+
+/**
+ * @brief Publishes the state of a process in the vDSO data page.
+ *
+ * @details This is called whenever @p proc is about to run, and whenever
+ *          the clock or the times of the running process @p proc change.
+ *
+ * @param proc Process that is (about to be) running.
+ */
+PUBLIC void vdso_update(struct process *proc)
+{
+	if (vdso == NULL)
+		return;
+
+	vdso_begin();
+
+	vdso->ticks = ticks;
+	vdso->time = CURRENT_TIME;
+	vdso->pid = proc->pid;
+	vdso->tp = proc->tp;
+	vdso->times.tms_utime = proc->utime*CLOCK_FREQ;
+	vdso->times.tms_stime = proc->ktime*CLOCK_FREQ;
+	vdso->times.tms_cutime = proc->cutime*CLOCK_FREQ;
+	vdso->times.tms_cstime = proc->cktime*CLOCK_FREQ;
+
+	vdso_end();
+}
+
+/**
+ * @brief Publishes the monotonic clock calibration in the vDSO data page.
+ *
+ * @param mult  TSC to nanoseconds multiplier.
+ * @param shift Fraction bits of @p mult.
+ * @param base  TSC at the last clock interrupt.
+ * @param mono  Monotonic time at @p base (in nanoseconds).
+ */
+PUBLIC void vdso_clock(uint32_t mult, unsigned shift, uint64_t base, uint64_t mono)
+{
+	if (vdso == NULL)
+		return;
+
+	vdso_begin();
+
+	vdso->tsc_mult = mult;
+	vdso->tsc_shift = shift;
+	vdso->tsc_base = base;
+	vdso->mono_base = mono;
+
+	vdso_end();
+}
+
+/**
+ * @brief Initializes the vDSO data page.
+ *
+ * @details The page is mapped through a page table of its own, in the page
+ *          directory of the idle process. Page directories are built out of
+ *          the one of the current running process, so every process inherits
+ *          the mapping.
+ */
+PUBLIC void vdso_init(void)
+{
+	struct pte *pgtab; /* Page table.           */
+	struct pde *pde;   /* Page directory entry. */
+	struct pte *pte;   /* Page table entry.     */
+
+	if ((vdso = getkpg(1)) == NULL)
+		kpanic("mm: cannot allocate vdso page");
+	if ((pgtab = getkpg(1)) == NULL)
+		kpanic("mm: cannot allocate vdso page table");
+
+	vdso->hz = CLOCK_FREQ;
+	vdso->startup_time = startup_time;
+	vdso_update(curr_proc);
+
+	/* Map vDSO page read-only. */
+	pte = &pgtab[PG(VDSO_ADDR)];
+	pte->present = 1;
+	pte->writable = 0;
+	pte->user = 1;
+	pte->frame = (ADDR(vdso) - KBASE_VIRT) >> PAGE_SHIFT;
+
+	pde = &idle_pgdir[PGTAB(VDSO_ADDR)];
+	pde->present = 1;
+	pde->writable = 0;
+	pde->user = 1;
+	pde->frame = (ADDR(pgtab) - KBASE_VIRT) >> PAGE_SHIFT;
+
+	tlb_flush();
+
+	kprintf("mm: vdso page at %x", VDSO_ADDR);
+}
@@ -23,6 +23,10 @@
 #include <nanvix/klib.h>
 #include <nanvix/mm.h>
 #include <nanvix/pm.h>
+#include <nanvix/sem.h>
+#include <nanvix/syscall.h>
+#include <sys/futex.h>
+#include <limits.h>
 #include <signal.h>
 
 /**
@@ -37,7 +41,9 @@ PUBLIC int shutting_down = 0;
  */
 PUBLIC void die(int status)
 {
-	struct process *p;
+	struct process *p;      /* Working process. */
+	struct process *father; /* New father.      */
+	int last;               /* Last thread?     */
 
 	/* Shall not occour. */
 	if (curr_proc == IDLE)
@@ -52,57 +58,95 @@ PUBLIC void die(int status)
 	for (unsigned i = 0; i < NR_SIGNALS; i++)
 		curr_proc->handlers[i] = SIG_IGN;
 
+	/* Tell joiners that this thread is gone. */
+	if (curr_proc->cleartid != NULL)
+	{
+		if (chkmem(curr_proc->cleartid, sizeof(int), MAY_WRITE))
+		{
+			*curr_proc->cleartid = 0;
+			sys_futex(curr_proc->cleartid, FUTEX_WAKE, INT_MAX);
+		}
+		curr_proc->cleartid = NULL;
+	}
+
+	/* Last thread of the group releases shared resources. */
+	last = (--curr_proc->tg->count == 0);
+
 	/* Close file descriptors. */
-	for (unsigned i = 0; i < OPEN_MAX; i++)
-		do_close(i);
+	if (last)
+	{
+		for (unsigned i = 0; i < OPEN_MAX; i++)
+			do_close(i);
+	}
 
 	/* Hangup terminal. */
 	if (IS_LEADER(curr_proc) && (curr_proc->tty != NULL_DEV))
 		cdev_close(curr_proc->tty);
 
 	/* init adopts orphan processes. */
-	for (p = FIRST_PROC; p <= LAST_PROC; p++)
+	if (curr_proc->children != NULL)
 	{
-		/* Skip invalid processes. */
-		if (!IS_VALID(p))
-			continue;
+		father = (shutting_down) ? IDLE : INIT;
 
-		if (shutting_down)
-			p->father = IDLE;
-		else if (p->father == curr_proc)
+		while ((p = curr_proc->children) != NULL)
 		{
-			p->father = INIT;
-			p->father->nchildren++;
-			sndsig(INIT, SIGCHLD);
+			proc_orphan(p);
+			proc_adopt(father, p);
+			father->nchildren++;
 		}
+
+		sndsig(father, SIGCHLD);
 	}
 
-	/* init adotps process in the same group. */
-	if (curr_proc->pgrp == curr_proc)
+	/* Hangup process group. */
+	if (IS_LEADER(curr_proc))
 	{
-		for (p = FIRST_PROC; p <= LAST_PROC; p++)
+		while ((p = curr_proc->members) != NULL)
 		{
-			/* Skip invalid processes. */
-			if (!IS_VALID(p))
-				continue;
+			pgrp_leave(p);
 
-			if (p->pgrp == curr_proc)
+			if (p != curr_proc)
 			{
-				p->pgrp = NULL;
 				sndsig(p, SIGHUP);
 				sndsig(p, SIGCONT);
 			}
 		}
 	}
+	else
+		pgrp_leave(curr_proc);
+
+	/* Adjust semaphores. */
+	sem_exit(curr_proc);
 
-	/* Detach process memory regions. */
-	for (unsigned i = 0; i < NR_PREGIONS; i++)
-		detachreg(curr_proc, &curr_proc->pregs[i]);
+	/* Give back address space borrowed with vfork(). */
+	vfrelease(1);
 
-	/* Release root and pwd. */
-	inode_put(curr_proc->root);
-	inode_put(curr_proc->pwd);
+	if (last)
+	{
+		/* Detach process memory regions. */
+		for (unsigned i = 0; i < NR_PREGIONS; i++)
+			detachreg(curr_proc, &curr_proc->tg->pregs[i]);
+
+		/* Release root and pwd. */
+		inode_put(curr_proc->tg->root);
+		inode_put(curr_proc->tg->pwd);
+
+		kfree(curr_proc->tg);
+	}
+
+	/*
+	 * Move onto the page directory of the idle process, so that
+	 * the one still shared with other threads is not released
+	 * when this thread is buried.
+	 */
+	else if (curr_proc->pgdir != IDLE->pgdir)
+	{
+		curr_proc->cr3 = IDLE->cr3;
+		curr_proc->pgdir = IDLE->pgdir;
+		pgdir_flush(curr_proc->cr3);
+	}
 
+	curr_proc->tg = NULL;
 	curr_proc->state = PROC_ZOMBIE;
 	curr_proc->alarm = 0;
 
@@ -119,7 +163,9 @@ PUBLIC void die(int status)
 PUBLIC void bury(struct process *proc)
 {
 	dstrypgdir(proc);
-	proc->state = PROC_DEAD;
+	proc_orphan(proc);
+	proc_unhash(proc);
 	proc->father->nchildren--;
+	proc_free(proc);
 	nprocs--;
 }
@@ -41,6 +41,11 @@ EXTERN struct pde idle_pgdir[];
  */
 PUBLIC char idle_kstack[KSTACK_SIZE];
 
+/**
+ * @brief Thread group of the idle process and kernel threads.
+ */
+PRIVATE struct tgroup idle_tg;
+
 /**
  * @brief Process table.
  */
@@ -66,6 +71,194 @@ PUBLIC pid_t next_pid = 0;
  */
 PUBLIC unsigned nprocs = 0;
 
+/**
+ * @brief Number of buckets in the process ID hash table.
+ */
+#define PID_HASH_SIZE PROC_MAX
+
+/**
+ * @brief Hashes a process ID.
+ *
+ * @param pid Target process ID.
+ *
+ * @returns The hash bucket of @p pid.
+ */
+#define PID_HASH(pid) ((unsigned)(pid) & (PID_HASH_SIZE - 1))
+
+/**
+ * @brief Process ID hash table.
+ */
+PRIVATE struct process *pidtab[PID_HASH_SIZE];
+
+/**
+ * @brief Free process table entries.
+ */
+PRIVATE struct process *free_procs = NULL;
+
+/**
+ * @brief Gets a free process table entry.
+ *
+ * @returns Upon successful completion, a free process table entry is returned.
+ *          If the process table is full, a NULL pointer is returned instead.
+ */
+PUBLIC struct process *proc_alloc(void)
+{
+	struct process *proc;
+
+	/* Process table overflow. */
+	if ((proc = free_procs) == NULL)
+		return (NULL);
+
+	free_procs = proc->next;
+	proc->next = NULL;
+
+	return (proc);
+}
+
+/**
+ * @brief Releases a process table entry.
+ *
+ * @param proc Process table entry to be released.
+ */
+PUBLIC void proc_free(struct process *proc)
+{
+	proc->flags = 0;
+	proc->state = PROC_DEAD;
+	proc->next = free_procs;
+	free_procs = proc;
+}
+
+/**
+ * @brief Inserts a process in the process ID hash table.
+ *
+ * @param proc Process to be inserted.
+ */
+PUBLIC void proc_hash(struct process *proc)
+{
+	unsigned i = PID_HASH(proc->pid);
+
+	proc->next_hash = pidtab[i];
+	pidtab[i] = proc;
+}
+
+/**
+ * @brief Removes a process from the process ID hash table.
+ *
+ * @param proc Process to be removed.
+ */
+PUBLIC void proc_unhash(struct process *proc)
+{
+	struct process **pp;
+
+	for (pp = &pidtab[PID_HASH(proc->pid)]; *pp != NULL; pp = &(*pp)->next_hash)
+	{
+		/* Found. */
+		if (*pp == proc)
+		{
+			*pp = proc->next_hash;
+			proc->next_hash = NULL;
+			return;
+		}
+	}
+}
+
+/**
+ * @brief Searches for a process.
+ *
+ * @param pid ID of the target process.
+ *
+ * @returns If a valid process with ID @p pid exists, a pointer to it is
+ *          returned. Otherwise, a NULL pointer is returned instead.
+ */
+PUBLIC struct process *proc_lookup(pid_t pid)
+{
+	struct process *p;
+
+	/* Invalid process ID. */
+	if (pid < 0)
+		return (NULL);
+
+	for (p = pidtab[PID_HASH(pid)]; p != NULL; p = p->next_hash)
+	{
+		/* Found. */
+		if (p->pid == pid)
+			return (p);
+	}
+
+	return (NULL);
+}
+
+/**
+ * @brief Makes a process child of another one.
+ *
+ * @param father New father process.
+ * @param proc   Process to be adopted.
+ */
+PUBLIC void proc_adopt(struct process *father, struct process *proc)
+{
+	proc->father = father;
+	proc->prev_sibling = NULL;
+	proc->next_sibling = father->children;
+	if (father->children != NULL)
+		father->children->prev_sibling = proc;
+	father->children = proc;
+}
+
+/**
+ * @brief Removes a process from the children list of its father.
+ *
+ * @param proc Process to be removed.
+ */
+PUBLIC void proc_orphan(struct process *proc)
+{
+	if (proc->prev_sibling != NULL)
+		proc->prev_sibling->next_sibling = proc->next_sibling;
+	else
+		proc->father->children = proc->next_sibling;
+	if (proc->next_sibling != NULL)
+		proc->next_sibling->prev_sibling = proc->prev_sibling;
+	proc->next_sibling = NULL;
+	proc->prev_sibling = NULL;
+}
+
+/**
+ * @brief Makes a process join a process group.
+ *
+ * @param proc   Process that shall join the group.
+ * @param leader Process group leader.
+ */
+PUBLIC void pgrp_join(struct process *proc, struct process *leader)
+{
+	proc->pgrp = leader;
+	proc->prev_member = NULL;
+	proc->next_member = leader->members;
+	if (leader->members != NULL)
+		leader->members->prev_member = proc;
+	leader->members = proc;
+}
+
+/**
+ * @brief Makes a process leave its process group.
+ *
+ * @param proc Process that shall leave its group.
+ */
+PUBLIC void pgrp_leave(struct process *proc)
+{
+	/* Not in a process group. */
+	if (proc->pgrp == NULL)
+		return;
+
+	if (proc->prev_member != NULL)
+		proc->prev_member->next_member = proc->next_member;
+	else
+		proc->pgrp->members = proc->next_member;
+	if (proc->next_member != NULL)
+		proc->next_member->prev_member = proc->prev_member;
+	proc->next_member = NULL;
+	proc->prev_member = NULL;
+	proc->pgrp = NULL;
+}
+
 /**
  * @brief Initializes the process management system.
  */
@@ -75,8 +268,10 @@ PUBLIC void pm_init(void)
 	struct process *p; /* Working process. */
 
 	/* Initialize the process table. */
-	for (p = FIRST_PROC; p <= LAST_PROC; p++)
-		p->flags = 0, p->state = PROC_DEAD;
+	for (p = LAST_PROC; p >= FIRST_PROC; p--)
+		proc_free(p);
+	for (i = 0; i < PID_HASH_SIZE; i++)
+		pidtab[i] = NULL;
 
 	/* Handcraft init process. */
 	IDLE->cr3 = (dword_t)idle_pgdir;
@@ -89,13 +284,18 @@ PUBLIC void pm_init(void)
 		IDLE->handlers[i] = SIG_DFL;
 	IDLE->irqlvl = INT_LVL_5;
 	IDLE->pgdir = idle_pgdir;
+	IDLE->tg = &idle_tg;
+	IDLE->tg->count = 1;
 	for (i = 0; i < NR_PREGIONS; i++)
-		IDLE->pregs[i].reg = NULL;
-	IDLE->size = 0;
+	{
+		IDLE->tg->pregs[i].reg = NULL;
+		IDLE->tg->pregs[i].flags = 0;
+	}
+	IDLE->tg->size = 0;
 	for (i = 0; i < OPEN_MAX; i++)
-		IDLE->ofiles[i] = NULL;
-	IDLE->close = 0;
-	IDLE->umask = S_IXUSR | S_IWGRP | S_IXGRP | S_IWOTH | S_IXOTH;
+		IDLE->tg->ofiles[i] = NULL;
+	IDLE->tg->close = 0;
+	IDLE->tg->umask = S_IXUSR | S_IWGRP | S_IXGRP | S_IWOTH | S_IXOTH;
 	IDLE->tty = NULL_DEV;
 	IDLE->status = 0;
 	IDLE->nchildren = 0;
@@ -106,13 +306,14 @@ PUBLIC void pm_init(void)
 	IDLE->egid = SUPERGROUP;
 	IDLE->sgid = SUPERGROUP;
 	IDLE->pid = next_pid++;
-	IDLE->pgrp = IDLE;
+	IDLE->pgrp = NULL;
 	IDLE->father = NULL;
 	kstrncpy(IDLE->name, "idle", NAME_MAX);
 	IDLE->utime = 0;
 	IDLE->ktime = 0;
 	IDLE->cutime = 0;
 	IDLE->cktime = 0;
+	IDLE->cputime = 0;
 	IDLE->state = PROC_RUNNING;
 	IDLE->counter = PROC_QUANTUM;
 	IDLE->priority = PRIO_USER;
@@ -120,6 +321,20 @@ PUBLIC void pm_init(void)
 	IDLE->alarm = 0;
 	IDLE->next = NULL;
 	IDLE->chain = NULL;
+	IDLE->timeout = 0;
+	IDLE->futex = NULL;
+	IDLE->futex_off = 0;
+	IDLE->semundo = NULL;
+	IDLE->cleartid = NULL;
+	IDLE->tp = NULL;
+	IDLE->children = NULL;
+	IDLE->next_sibling = NULL;
+	IDLE->prev_sibling = NULL;
+	IDLE->members = NULL;
+	IDLE->next_hash = NULL;
+	IDLE->wchain = NULL;
+	pgrp_join(IDLE, IDLE);
+	proc_hash(IDLE);
 
 	nprocs++;
 
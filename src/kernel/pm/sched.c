@@ -22,8 +22,26 @@
 #include <nanvix/const.h>
 #include <nanvix/hal.h>
 #include <nanvix/pm.h>
+#include <nanvix/vdso.h>
 #include <signal.h>
 #include <nanvix/klib.h> // For random number generator (krand)
+#include <errno.h>
+
+/**
+ * @brief Processes sleeping until a timeout.
+ */
+PRIVATE struct process *timeout_chain = NULL;
+
+/**
+ * @brief Earliest pending sleep timeout (zero if none).
+ */
+PUBLIC unsigned next_timeout = 0;
+
+/**
+ * @brief Monotonic time at which the current process was last charged.
+ */
+PRIVATE uint64_t charged = 0;
+
 /**
  * @brief Schedules a process to execution.
  *
@@ -59,6 +77,94 @@ PUBLIC void resume(struct process *proc)
 		sched(proc);
 }
 
+/**
+ * @brief Charges the current process for the processor time it has used.
+ */
+PUBLIC void charge(void)
+{
+	uint64_t now;
+
+	now = clock_ns();
+	curr_proc->cputime += now - charged;
+	charged = now;
+}
+
+/**
+ * @brief Puts the current process to sleep until a given clock tick.
+ *
+ * @param timeout Clock tick at which the process shall be woken up.
+ *
+ * @returns Zero if the timeout has expired, and -EINTR if the process was
+ *          interrupted by a signal.
+ */
+PUBLIC int sleep_until(unsigned timeout)
+{
+	curr_proc->timeout = timeout;
+
+	while (ticks < timeout)
+	{
+		sleep(&timeout_chain, PRIO_USER);
+
+		/* Interrupted. */
+		if (issig() != SIGNULL)
+			break;
+	}
+
+	curr_proc->timeout = 0;
+
+	return ((ticks < timeout) ? -EINTR : 0);
+}
+
+/**
+ * @brief Idles the processor.
+ *
+ * @details Halts the processor until the next interrupt if no process is
+ *          ready to run. The periodic clock interrupt is stopped until the
+ *          earliest pending alarm or sleep timeout, so that an idle system
+ *          is not woken up at every tick.
+ *
+ * @note This function shall be called by the idle process only.
+ */
+PUBLIC void idle(void)
+{
+	struct process *p; /* Working process.  */
+	unsigned deadline; /* Next timer event. */
+
+	deadline = 0;
+
+	disable_interrupts();
+
+	for (p = FIRST_PROC; p <= LAST_PROC; p++)
+	{
+		/* Skip invalid processes. */
+		if (!IS_VALID(p))
+			continue;
+
+		/* There is something to run. */
+		if (p->state == PROC_READY)
+			goto out;
+
+		/* Alarms expire one tick after their deadline. */
+		if ((p->alarm) && ((deadline == 0) || (p->alarm + 1 < deadline)))
+			deadline = p->alarm + 1;
+
+		if ((p->timeout) && ((deadline == 0) || (p->timeout < deadline)))
+			deadline = p->timeout;
+	}
+
+	/* Timer event has already expired. */
+	if ((deadline) && (deadline <= ticks))
+		goto out;
+
+	clock_sleep((deadline) ? deadline - ticks : 0);
+	processor_idle();
+	disable_interrupts();
+	clock_wakeup();
+
+out:
+	enable_interrupts();
+}
+
 /**
  * @brief Yields the processor.
  */
@@ -66,6 +172,8 @@ PUBLIC void yield(void)
 {
 	struct process *p;		  /* Working process.     */
 	struct process *candidat; /* candidat process to run. */
+	struct process *woken;    /* Timed out process.       */
+	int expired = 0;          /* Sleep timeout expired?   */
 
 
 
@@ -81,6 +189,8 @@ PUBLIC void yield(void)
 
 
 	/* Check alarm. */
+	woken = NULL;
+	next_timeout = 0;
 	for (p = FIRST_PROC; p <= LAST_PROC; p++)
 	{
 		/* Skip invalid processes. */
@@ -89,9 +199,26 @@ PUBLIC void yield(void)
 		/* Alarm has expired. */
 		if ((p->alarm) && (p->alarm < ticks))
 			p->alarm = 0, sndsig(p, SIGALRM);
+		/* Sleep timeout has expired. */
+		if ((p->timeout) && (p->timeout <= ticks))
+		{
+			if ((p->state == PROC_WAITING) && (woken == NULL))
+				woken = p;
+			if (p->chain == &timeout_chain)
+				expired = 1;
+			else if (p->state == PROC_WAITING)
+				unsleep(p);
+		}
+		/* Sleep timeout is pending. */
+		else if ((p->timeout) && ((next_timeout == 0) || (p->timeout < next_timeout)))
+			next_timeout = p->timeout;
 		tot_ticket += 41 - (p->nice) + p->utime+p->ktime + p->counter;
 	}
- 
+
+	/* Wakeup processes whose sleep timeout has expired. */
+	if (expired)
+		wakeup(&timeout_chain);
+
     candidat = IDLE;
     int plage = 0;
     int ticket_gagnant = ticks % tot_ticket;
@@ -107,11 +234,19 @@ PUBLIC void yield(void)
 		}
     }
 
+	/* Timed out processes run straight away. */
+	if ((woken != NULL) && (woken->state == PROC_READY))
+		candidat = woken;
+
 	/* Switch to candidat process. */
 	candidat->priority = PRIO_USER;
 	candidat->state = PROC_RUNNING;
 	candidat->counter = PROC_QUANTUM;
 
 	if (curr_proc != candidat)
+	{
+		charge();
+		vdso_update(candidat);
 		switch_to(candidat);
+	}
 }
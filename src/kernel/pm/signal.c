@@ -183,9 +183,10 @@ PUBLIC int issig(void)
 				curr_proc->received &= ~(1 << i);
 
 				/* Bury zombie child processes. */
-				for (struct process *p = FIRST_PROC; p <= LAST_PROC; p++)
+				for (struct process *p = curr_proc->children, *next; p != NULL; p = next)
 				{
-					if ((p->father == curr_proc) && (p->state==PROC_ZOMBIE))
+					next = p->next_sibling;
+					if (p->state == PROC_ZOMBIE)
 						bury(p);
 				}
 
@@ -27,6 +27,11 @@
  */
 PRIVATE struct process **idle_chain = NULL;
 
+/**
+ * @brief Sleeping chains lock.
+ */
+PRIVATE spinlock_t sleep_lock = SPINLOCK_UNLOCKED;
+
 /**
  * @brief Puts the current process to sleep in a chain of sleeping processes.
  *
@@ -42,6 +47,8 @@ PRIVATE struct process **idle_chain = NULL;
  */
 PUBLIC void sleep(struct process **chain, int priority)
 {
+	unsigned flags;
+
 	/*
 	 * Idle process trying to sleep. Although that may
 	 * sound weird, it happens at system startup. So,
@@ -51,9 +58,13 @@ PUBLIC void sleep(struct process **chain, int priority)
 	if (curr_proc == IDLE)
 	{
 		idle_chain = chain;
-		enable_interrupts();
+		disable_interrupts();
 		while (idle_chain == chain)
-			noop();
+		{
+			processor_idle();
+			disable_interrupts();
+		}
+		enable_interrupts();
 		return;
 	}
 
@@ -65,6 +76,8 @@ PUBLIC void sleep(struct process **chain, int priority)
 	if ((priority >= 0) && (curr_proc->received))
 		return;
 
+	flags = spin_lock_irqsave(&sleep_lock);
+
 	/* Insert process in the sleeping chain. */
 	curr_proc->next = *chain;
 	*chain = curr_proc;
@@ -74,6 +87,8 @@ PUBLIC void sleep(struct process **chain, int priority)
 	curr_proc->priority = priority;
 	curr_proc->chain = chain;
 
+	spin_unlock_irqrestore(&sleep_lock, flags);
+
 	yield();
 }
 
@@ -84,6 +99,8 @@ PUBLIC void sleep(struct process **chain, int priority)
  */
 PUBLIC void wakeup(struct process **chain)
 {
+	unsigned flags;
+
 	/*
 	 * Wakeup idle process. Note that here we don't
 	 * schedule the idle process for execution, once
@@ -96,15 +113,50 @@ PUBLIC void wakeup(struct process **chain)
 		return;
 	}
 
+	flags = spin_lock_irqsave(&sleep_lock);
+
 	/* Wakeup sleeping processes. */
 	while (*chain != NULL)
 	{
 		sched(*chain);
 		*chain = (*chain)->next;
 	}
+
+	spin_unlock_irqrestore(&sleep_lock, flags);
+}
+
+/**
+ * @brief Wakes up a process that is sleeping in a chain.
+ *
+ * @details This is used to end a sleep with a timeout on a chain other than
+ *          the chain of sleep_until().
+ *
+ * @param proc Process to be awaken.
+ */
+PUBLIC void unsleep(struct process *proc)
+{
+	unsigned flags;
+	struct process **pp;
+
+	flags = spin_lock_irqsave(&sleep_lock);
+
+	/* Remove process from sleeping chain. */
+	for (pp = proc->chain; *pp != NULL; pp = &(*pp)->next)
+	{
+		if (*pp == proc)
+		{
+			*pp = proc->next;
+			sched(proc);
+			break;
+		}
+	}
+
+	spin_unlock_irqrestore(&sleep_lock, flags);
 }
 
 PUBLIC void wakeup_one(struct process **chain){
+	unsigned flags;
+
 	/*
 	 * Wakeup idle process. Note that here we don't
 	 * schedule the idle process for execution, once
@@ -116,10 +168,171 @@ PUBLIC void wakeup_one(struct process **chain){
 		return;
 	}
 
+	flags = spin_lock_irqsave(&sleep_lock);
+
 	/* Wakeup ONE sleeping processes. */
 	if (*chain != NULL)
 	{
 		sched(*chain);
 		*chain = (*chain)->next;
 	}
-}
\ No newline at end of file
+
+	spin_unlock_irqrestore(&sleep_lock, flags);
+}
+
+/**
+ * @brief Processes sleeping in poll().
+ */
+PRIVATE struct process *poll_chain = NULL;
+
+/**
+ * @brief Poll chains lock.
+ */
+PRIVATE spinlock_t poll_lock = SPINLOCK_UNLOCKED;
+
+/**
+ * @brief Poll table being filled in.
+ */
+PRIVATE struct polltable *poll_table = NULL;
+
+/**
+ * @brief Removes the entries of a poll table from the chains of the polled
+ *        objects.
+ *
+ * @param table Target poll table.
+ *
+ * @note The poll lock must be held.
+ */
+PRIVATE void polldrop(struct polltable *table)
+{
+	struct pollwait *w;   /* Working entry. */
+	struct pollwait **pp; /* Previous link. */
+
+	for (w = &table->waits[0]; w < &table->waits[table->nwaits]; w++)
+	{
+		for (pp = w->chain; (*pp != NULL) && (*pp != w); pp = &(*pp)->next)
+			/* noop */ ;
+
+		/* The object may have been released meanwhile. */
+		if (*pp != NULL)
+			*pp = w->next;
+	}
+
+	table->nwaits = 0;
+}
+
+/**
+ * @brief Starts polling objects.
+ *
+ * @details Locks the poll chains, so that no event can be lost between
+ *          checking objects and going to sleep, and records objects that
+ *          are not ready in the poll table @p table from now on.
+ *
+ * @param table Poll table of the calling process.
+ *
+ * @returns The interrupt flag that shall be passed to pollstop().
+ */
+PUBLIC unsigned pollstart(struct polltable *table)
+{
+	unsigned flags;
+
+	flags = spin_lock_irqsave(&poll_lock);
+
+	table->nwaits = 0;
+	poll_table = table;
+
+	return (flags);
+}
+
+/**
+ * @brief Registers the current process in the poll chain of an object.
+ *
+ * @details This does nothing if the current process is not polling, so
+ *          drivers can check readiness on behalf of plain reads and writes.
+ *
+ * @param chain Poll chain of the target object.
+ *
+ * @note The poll lock must be held.
+ */
+PUBLIC void pollrecord(struct pollwait **chain)
+{
+	struct pollwait *w;
+
+	/* Not polling. */
+	if (poll_table == NULL)
+		return;
+
+	/* Too many objects. */
+	if (poll_table->nwaits == NR_POLLWAITS)
+		kpanic("poll: table overflow");
+
+	w = &poll_table->waits[poll_table->nwaits++];
+	w->proc = curr_proc;
+	w->chain = chain;
+	w->next = *chain;
+	*chain = w;
+}
+
+/**
+ * @brief Puts the current process to sleep until a polled object is ready.
+ *
+ * @details The poll lock is dropped while sleeping. On return, the process
+ *          is no longer in any poll chain, and objects can be checked again.
+ *
+ * @param table   Poll table of the calling process.
+ * @param timeout Clock tick at which to give up waiting (zero for none).
+ *
+ * @note The poll lock must be held.
+ */
+PUBLIC void pollsleep(struct polltable *table, unsigned timeout)
+{
+	poll_table = NULL;
+	spin_unlock(&poll_lock);
+
+	curr_proc->timeout = timeout;
+	sleep(&poll_chain, PRIO_USER);
+	curr_proc->timeout = 0;
+
+	spin_lock(&poll_lock);
+	polldrop(table);
+	poll_table = table;
+}
+
+/**
+ * @brief Stops polling objects.
+ *
+ * @param table Poll table of the calling process.
+ * @param flags Interrupt flag returned by pollstart().
+ */
+PUBLIC void pollstop(struct polltable *table, unsigned flags)
+{
+	polldrop(table);
+	poll_table = NULL;
+
+	spin_unlock_irqrestore(&poll_lock, flags);
+}
+
+/**
+ * @brief Wakes up processes polling an object.
+ *
+ * @param chain Poll chain of the target object.
+ */
+PUBLIC void pollwakeup(struct pollwait **chain)
+{
+	unsigned flags;
+	struct pollwait *w;
+
+	/* Nobody is polling this object. */
+	if (*chain == NULL)
+		return;
+
+	flags = spin_lock_irqsave(&poll_lock);
+
+	for (w = *chain; w != NULL; w = w->next)
+	{
+		if ((w->proc->chain == &poll_chain) && (w->proc->state == PROC_WAITING))
+			unsleep(w->proc);
+	}
+
+	spin_unlock_irqrestore(&poll_lock, flags);
+}
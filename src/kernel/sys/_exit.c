@@ -19,11 +19,24 @@
 
 #include <nanvix/const.h>
 #include <nanvix/pm.h>
+#include <signal.h>
 
 /*
  * Terminates the calling process.
  */
 PUBLIC void sys__exit(int status)
 {
+	struct process *p;
+
+	/* Take down other threads. */
+	if (curr_proc->tg->count > 1)
+	{
+		for (p = FIRST_PROC; p <= LAST_PROC; p++)
+		{
+			if ((p != curr_proc) && (p->tg == curr_proc->tg))
+				sndsig(p, SIGKILL);
+		}
+	}
+
 	die((1 << 8) | (status & 0xff));
 }
@@ -42,9 +42,9 @@ PUBLIC int sys_chdir(const char *path)
 		return (-ENOTDIR);
 	}
 
-	inode_put(curr_proc->pwd);
+	inode_put(curr_proc->tg->pwd);
 
-	curr_proc->pwd = inode;
+	curr_proc->tg->pwd = inode;
 	inode_unlock(inode);
 
 	return (0);
@@ -42,9 +42,9 @@ PUBLIC int sys_chroot(const char *path)
 		return (-ENOTDIR);
 	}
 
-	inode_put(curr_proc->root);
+	inode_put(curr_proc->tg->root);
 
-	curr_proc->root = inode;
+	curr_proc->tg->root = inode;
 	inode_unlock(inode);
 
 	return (0);
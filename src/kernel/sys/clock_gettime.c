@@ -0,0 +1,64 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/clock.h>
+#include <nanvix/const.h>
+#include <nanvix/klib.h>
+#include <nanvix/mm.h>
+#include <nanvix/pm.h>
+#include <errno.h>
+#include <time.h>
+
+/*
+ * Gets the time of a clock.
+ */
+PUBLIC int sys_clock_gettime(clockid_t clock_id, struct timespec *tp)
+{
+	uint64_t ns;   /* Time in nanoseconds. */
+	uint32_t nsec; /* Nanoseconds part.    */
+
+	/* Invalid buffer. */
+	if (!chkmem(tp, sizeof(struct timespec), MAY_WRITE))
+		return (-EINVAL);
+
+	switch (clock_id)
+	{
+		case CLOCK_REALTIME:
+		case CLOCK_MONOTONIC:
+			ns = clock_ns();
+			break;
+
+		case CLOCK_PROCESS_CPUTIME_ID:
+			charge();
+			ns = curr_proc->cputime;
+			break;
+
+		/* Unknown clock. */
+		default:
+			return (-EINVAL);
+	}
+
+	tp->tv_sec = (time_t)kdiv64(ns, 1000000000, &nsec);
+	tp->tv_nsec = nsec;
+
+	if (clock_id == CLOCK_REALTIME)
+		tp->tv_sec += startup_time;
+
+	return (0);
+}
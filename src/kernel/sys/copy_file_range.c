@@ -0,0 +1,120 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/fs.h>
+#include <nanvix/klib.h>
+#include <nanvix/mm.h>
+#include <nanvix/syscall.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <errno.h>
+
+/*
+ * Copies a range of data from one file to another.
+ */
+PUBLIC ssize_t sys_copy_file_range(const struct copy_file_range_args *uargs)
+{
+	off_t inoff;                      /* Source offset.        */
+	off_t outoff;                     /* Target offset.        */
+	struct file *fin;                 /* Source file.          */
+	struct file *fout;                /* Target file.          */
+	ssize_t count;                    /* Bytes copied.         */
+	struct copy_file_range_args args; /* Copy arguments.       */
+
+	/* Bad arguments. */
+	if (!chkmem(uargs, sizeof(struct copy_file_range_args), MAY_READ))
+		return (-EFAULT);
+
+	kmemcpy(&args, uargs, sizeof(struct copy_file_range_args));
+
+	/* Invalid file descriptors. */
+	if ((args.fd_in < 0) || (args.fd_in >= OPEN_MAX))
+		return (-EBADF);
+	if ((fin = curr_proc->tg->ofiles[args.fd_in]) == NULL)
+		return (-EBADF);
+	if ((args.fd_out < 0) || (args.fd_out >= OPEN_MAX))
+		return (-EBADF);
+	if ((fout = curr_proc->tg->ofiles[args.fd_out]) == NULL)
+		return (-EBADF);
+
+	/* Files not opened for reading or writing. */
+	if (ACCMODE(fin->oflag) == O_WRONLY)
+		return (-EBADF);
+	if (ACCMODE(fout->oflag) == O_RDONLY)
+		return (-EBADF);
+
+	/* Only regular files can be copied in kernel. */
+	if (!S_ISREG(fin->inode->mode) || !S_ISREG(fout->inode->mode))
+		return (-EINVAL);
+
+	/* Overlapping copies are not supported. */
+	if (fin->inode == fout->inode)
+		return (-EINVAL);
+
+	/* No flags are defined. */
+	if (args.flags != 0)
+		return (-EINVAL);
+
+	/* Bad offsets. */
+	if (args.off_in != NULL)
+	{
+		if (!chkmem(args.off_in, sizeof(off_t), MAY_WRITE))
+			return (-EFAULT);
+	}
+	if (args.off_out != NULL)
+	{
+		if (!chkmem(args.off_out, sizeof(off_t), MAY_WRITE))
+			return (-EFAULT);
+	}
+
+	inoff = (args.off_in != NULL) ? *args.off_in : fin->pos;
+	outoff = (args.off_out != NULL) ? *args.off_out : fout->pos;
+
+	/* Append mode. */
+	if ((args.off_out == NULL) && (fout->oflag & O_APPEND))
+		outoff = fout->inode->size;
+
+	/* Invalid offsets. */
+	if ((inoff < 0) || (outoff < 0))
+		return (-EINVAL);
+
+	/* Nothing to do. */
+	if (args.len == 0)
+		return (0);
+
+	curr_proc->errno = 0;
+	count = file_copy(fin->inode, inoff, fout->inode, outoff, args.len);
+
+	/* Failed to copy. */
+	if ((count == 0) && (curr_proc->errno != 0))
+		return (curr_proc->errno);
+
+	/* Update offsets. */
+	if (args.off_in != NULL)
+		*args.off_in = inoff + count;
+	else
+		fin->pos = inoff + count;
+	if (args.off_out != NULL)
+		*args.off_out = outoff + count;
+	else
+		fout->pos = outoff + count;
+
+	return (count);
+}
@@ -338,6 +338,10 @@ PUBLIC int sys_execve(const char *filename, const char **argv, const char **envp
 	char *pathname;       /* Path name.           */
 	char stack[ARG_MAX];  /* Stack size.          */
 
+	/* Other threads still use the address space. */
+	if (curr_proc->tg->count > 1)
+		return (-EBUSY);
+
 	/* Get path name. */
 	if ((pathname = getname(filename)) == NULL)
 		return (curr_proc->errno);
@@ -373,16 +377,27 @@ PUBLIC int sys_execve(const char *filename, const char **argv, const char **envp
 		return (-EACCES);
 	}
 
+	/* Give back address space borrowed with vfork(). */
+	if (vfrelease(0))
+	{
+		putname(pathname);
+		inode_put(inode);
+		return (-ENOMEM);
+	}
+
 	/* Close file descriptors. */
 	for (i = 0; i < OPEN_MAX; i++)
 	{
-		if (curr_proc->close & (1 << i))
+		if (curr_proc->tg->close & (1 << i))
 			do_close(i);
 	}
 
 	/* Detach process memory regions. */
 	for (i = 0; i < NR_PREGIONS; i++)
-		detachreg(curr_proc, &curr_proc->pregs[i]);
+		detachreg(curr_proc, &curr_proc->tg->pregs[i]);
+
+	/* New image has no threads yet. */
+	curr_proc->tp = NULL;
 
 	/* Reset signal handlers. */
 	curr_proc->restorer = NULL;
@@ -21,6 +21,7 @@
 #include <nanvix/fs.h>
 #include <nanvix/pm.h>
 #include <nanvix/syscall.h>
+#include <sys/stat.h>
 #include <errno.h>
 #include <fcntl.h>
 
@@ -36,7 +37,7 @@ PRIVATE int do_dup(int oldfd, int newfd)
 	/* Look for first available file descriptor. */
 	while (newfd < OPEN_MAX)
 	{
-		if (curr_proc->ofiles[newfd] == NULL)
+		if (curr_proc->tg->ofiles[newfd] == NULL)
 			goto found;
 
 		newfd++;
@@ -46,8 +47,8 @@ PRIVATE int do_dup(int oldfd, int newfd)
 
 found:
 
-	curr_proc->close &= ~(1 << newfd);
-	(curr_proc->ofiles[newfd] = curr_proc->ofiles[oldfd])->count++;
+	curr_proc->tg->close &= ~(1 << newfd);
+	(curr_proc->tg->ofiles[newfd] = curr_proc->tg->ofiles[oldfd])->count++;
 
 	return (newfd);
 }
@@ -58,7 +59,7 @@ found:
 EXTERN int sys_dup2(int oldfd, int newfd)
 {
 	/* Invalid file descriptor. */
-	if ((newfd < 0)||(newfd >= OPEN_MAX)||((curr_proc->ofiles[newfd]) == NULL))
+	if ((newfd < 0)||(newfd >= OPEN_MAX)||((curr_proc->tg->ofiles[newfd]) == NULL))
 		return (-EBADF);
 
 	sys_close(newfd);
@@ -70,10 +71,11 @@ EXTERN int sys_dup2(int oldfd, int newfd)
  */
 PUBLIC int sys_fcntl(int fd, int cmd, int arg)
 {
-	struct file *f;
+	int ret;        /* Return value. */
+	struct file *f; /* File.         */
 
 	/* Invalid file descriptor. */
-	if ((fd < 0) || (fd >= OPEN_MAX) || ((f = curr_proc->ofiles[fd]) == NULL))
+	if ((fd < 0) || (fd >= OPEN_MAX) || ((f = curr_proc->tg->ofiles[fd]) == NULL))
 		return (-EBADF);
 
 	/* Parse commad. */
@@ -83,13 +85,13 @@ PUBLIC int sys_fcntl(int fd, int cmd, int arg)
 			return (do_dup(fd, arg));
 
 		case F_GETFD :
-			return ((curr_proc->close >> fd) & 1);
+			return ((curr_proc->tg->close >> fd) & 1);
 
 		case F_SETFD :
 			if (arg & FD_CLOEXEC)
-				curr_proc->close |= 1 << fd;
+				curr_proc->tg->close |= 1 << fd;
 			else
-				curr_proc->close &= ~(1 << fd);
+				curr_proc->tg->close &= ~(1 << fd);
 			return (0);
 
 		case F_GETFL :
@@ -100,6 +102,26 @@ PUBLIC int sys_fcntl(int fd, int cmd, int arg)
 			f->oflag |= arg & (O_APPEND | O_NONBLOCK);
 			return (0);
 
+		case F_SETPIPE_SZ :
+			/* Not a pipe. */
+			if (!S_ISFIFO(f->inode->mode))
+				return (-EBADF);
+
+			/* Invalid size. */
+			if (arg <= 0)
+				return (-EINVAL);
+
+			if ((ret = pipe_resize(f->inode, arg)) < 0)
+				return (ret);
+			return (f->inode->size);
+
+		case F_GETPIPE_SZ :
+			/* Not a pipe. */
+			if (!S_ISFIFO(f->inode->mode))
+				return (-EBADF);
+
+			return (f->inode->size);
+
 		default :
 			return (-EINVAL);
 	};
@@ -26,16 +26,17 @@
 #include <sys/types.h>
 #include <errno.h>
 
+/**
+ * @brief Parents waiting for vfork() children.
+ */
+PRIVATE struct process *vfork_chain = NULL;
+
 /*
- * Creates a new process.
+ * Gets a free process table entry.
  */
-PUBLIC pid_t sys_fork(void)
+PRIVATE struct process *getproc(void)
 {
-	int i;                /* Loop index.     */
-	int err;              /* Error?          */
-	struct process *proc; /* Process.        */
-	struct region *reg;   /* Memory region.  */
-	struct pregion *preg; /* Process region. */
+	struct process *proc;
 
 #if (EDUCATIONAL_KERNEL == 0)
 
@@ -45,32 +46,143 @@ PUBLIC pid_t sys_fork(void)
 	 * user can invoke kill() if something goes wrong.
 	 */
 	if ((nprocs + 1 >= PROC_MAX) && (!IS_SUPERUSER(curr_proc)))
-		return (-EAGAIN);
+		return (NULL);
 
 #endif
 
-	/* Search for a free process. */
-	for (proc = FIRST_PROC; proc <= LAST_PROC; proc++)
+	if ((proc = proc_alloc()) == NULL)
+		kprintf("process table overflow");
+
+	return (proc);
+}
+
+/*
+ * Allocates an empty thread group.
+ */
+PRIVATE struct tgroup *tgalloc(void)
+{
+	int i;
+	struct tgroup *tg;
+
+	if ((tg = kmalloc(sizeof(struct tgroup))) == NULL)
+		return (NULL);
+
+	tg->count = 1;
+	for (i = 0; i < NR_PREGIONS; i++)
 	{
-		/* Found. */
-		if (!IS_VALID(proc))
-			goto found;
+		tg->pregs[i].reg = NULL;
+		tg->pregs[i].flags = 0;
 	}
+	tg->size = 0;
+
+	return (tg);
+}
+
+/*
+ * Initializes a child of the current running process and schedules it.
+ *
+ * Threads share the thread group of the caller and are adopted by the
+ * idle process, so that they do not show up in the caller's wait().
+ */
+PRIVATE void initproc(struct process *proc)
+{
+	int i;
+	struct process *father;
+
+	proc->intlvl = 1;
+	proc->received = 0;
+	proc->restorer = curr_proc->restorer;
+	kmemcpy(&proc->fss, &curr_proc->fss, sizeof(struct fpu));
+	for (i = 0; i < NR_SIGNALS; i++)
+		proc->handlers[i] = curr_proc->handlers[i];
+	proc->irqlvl = curr_proc->irqlvl;
+	if (proc->tg != curr_proc->tg)
+	{
+		proc->tg->size = curr_proc->tg->size;
+		proc->tg->pwd = curr_proc->tg->pwd;
+		proc->tg->pwd->count++;
+		proc->tg->root = curr_proc->tg->root;
+		proc->tg->root->count++;
+		for (i = 0; i < OPEN_MAX; i++)
+		{
+			proc->tg->ofiles[i] = curr_proc->tg->ofiles[i];
+
+			/* Increment file reference count. */
+			if (proc->tg->ofiles[i] != NULL)
+				proc->tg->ofiles[i]->count++;
+		}
+		proc->tg->close = curr_proc->tg->close;
+		proc->tg->umask = curr_proc->tg->umask;
+	}
+	proc->tty = curr_proc->tty;
+	proc->status = 0;
+	proc->nchildren = 0;
+	proc->uid = curr_proc->uid;
+	proc->euid = curr_proc->euid;
+	proc->suid = curr_proc->suid;
+	proc->gid = curr_proc->gid;
+	proc->egid = curr_proc->egid;
+	proc->sgid = curr_proc->sgid;
+	proc->pid = next_pid++;
+	kstrncpy(proc->name, curr_proc->name, NAME_MAX);
+	proc->utime = 0;
+	proc->ktime = 0;
+	proc->cutime = 0;
+	proc->cktime = 0;
+	proc->cputime = 0;
+	proc->priority = curr_proc->priority;
+	proc->nice = curr_proc->nice;
+	proc->alarm = 0;
+	proc->next = NULL;
+	proc->chain = NULL;
+	proc->timeout = 0;
+	proc->futex = NULL;
+	proc->futex_off = 0;
+	proc->semundo = NULL;
+	proc->cleartid = NULL;
+	proc->tp = curr_proc->tp;
+	proc->children = NULL;
+	proc->members = NULL;
+	proc->wchain = NULL;
+	proc->pgrp = NULL;
+	if (curr_proc->pgrp != NULL)
+		pgrp_join(proc, curr_proc->pgrp);
+	father = (proc->tg == curr_proc->tg) ? IDLE : curr_proc;
+	proc_adopt(father, proc);
+	proc_hash(proc);
+	sched(proc);
 
-	kprintf("process table overflow");
+	father->nchildren++;
 
-	return (-EAGAIN);
+	nprocs++;
+}
 
-found:
+/*
+ * Creates a new process.
+ */
+PUBLIC pid_t sys_fork(void)
+{
+	int i;                /* Loop index.     */
+	int err;              /* Error?          */
+	struct process *proc; /* Process.        */
+	struct region *reg;   /* Memory region.  */
+	struct pregion *preg; /* Process region. */
+
+	if ((proc = getproc()) == NULL)
+		return (-EAGAIN);
 
 	/* Mark process as beeing created. */
 	proc->flags = 1 << PROC_NEW;
 
+	/* Failed to allocate thread group. */
+	if ((proc->tg = tgalloc()) == NULL)
+		goto error0;
+
 	err = crtpgdir(proc);
 
 	/* Failed to create process page directory. */
 	if (err)
-		goto error0;
+		goto error1;
 
 	/*
 	 * Duplicate attached regions.
@@ -79,7 +191,7 @@ found:
 	 */
 	for (i = 0; i < NR_PREGIONS; i++)
 	{
-		preg = &curr_proc->pregs[i];
+		preg = &curr_proc->tg->pregs[i];
 
 		/* Process region not in use. */
 		if (preg->reg == NULL)
@@ -91,9 +203,10 @@ found:
 
 		/* Failed to duplicate region. */
 		if (reg == NULL)
-			goto error1;
+			goto error2;
 
-		err = attachreg(proc, &proc->pregs[i], preg->start, reg);
+		proc->tg->pregs[i].flags = preg->flags;
+		err = attachreg(proc, &proc->tg->pregs[i], preg->start, reg);
 
 		/* Failed to attach region. */
 		if (err)
@@ -103,80 +216,222 @@ found:
 			 */
 			kpanic("failed to attach region");
 			freereg(reg);
-			goto error1;
+			goto error2;
 		}
 
 		unlockreg(reg);
 	}
 
-	/* Initialize process. */
-	proc->intlvl = 1;
-	proc->received = 0;
-	proc->restorer = curr_proc->restorer;
-	kmemcpy(&proc->fss, &curr_proc->fss, sizeof(struct fpu));
-	for (i = 0; i < NR_SIGNALS; i++)
-		proc->handlers[i] = curr_proc->handlers[i];
-	proc->irqlvl = curr_proc->irqlvl;
-	proc->size = curr_proc->size;
-	proc->pwd = curr_proc->pwd;
-	proc->pwd->count++;
-	proc->root = curr_proc->root;
-	proc->root->count++;
-	for (i = 0; i < OPEN_MAX; i++)
-	{
-		proc->ofiles[i] = curr_proc->ofiles[i];
-
-		/* Increment file reference count. */
-		if (proc->ofiles[i] != NULL)
-			proc->ofiles[i]->count++;
-	}
-	proc->close = curr_proc->close;
-	proc->umask = curr_proc->umask;
-	proc->tty = curr_proc->tty;
-	proc->status = 0;
-	proc->nchildren = 0;
-	proc->uid = curr_proc->uid;
-	proc->euid = curr_proc->euid;
-	proc->suid = curr_proc->suid;
-	proc->gid = curr_proc->gid;
-	proc->egid = curr_proc->egid;
-	proc->sgid = curr_proc->sgid;
-	proc->pid = next_pid++;
-	proc->pgrp = curr_proc->pgrp;
-	proc->father = curr_proc;
-	kstrncpy(proc->name, curr_proc->name, NAME_MAX);
-	proc->utime = 0;
-	proc->ktime = 0;
-	proc->cutime = 0;
-	proc->cktime = 0;
-	proc->priority = curr_proc->priority;
-	proc->nice = curr_proc->nice;
-	proc->alarm = 0;
-	proc->next = NULL;
-	proc->chain = NULL;
-	sched(proc);
-
-	curr_proc->nchildren++;
-
-	nprocs++;
+	initproc(proc);
 
 	return (proc->pid);
 
-error1:
+error2:
 	/* Detach attached regions. */
 	while (--i >= 0)
 	{
 		/* Region not attached. */
-		if (proc->pregs[i].reg == NULL)
+		if (proc->tg->pregs[i].reg == NULL)
 			continue;
 
 		/* Detach. */
-		preg = &proc->pregs[i];
+		preg = &proc->tg->pregs[i];
 		lockreg(preg->reg);
 		detachreg(proc, preg);
 	}
-error0:
 	dstrypgdir(proc);
-	proc->flags = 0;
+error1:
+	kfree(proc->tg);
+error0:
+	proc_free(proc);
 	return (-ENOMEM);
 }
+
+/*
+ * Creates a new process that borrows the address space of the caller.
+ */
+PUBLIC pid_t sys_vfork(void)
+{
+	int i;                /* Loop index.  */
+	pid_t pid;            /* Child's PID. */
+	struct process *proc; /* Process.     */
+
+	if ((proc = getproc()) == NULL)
+		return (-EAGAIN);
+
+	/* Mark process as beeing created. */
+	proc->flags = (1 << PROC_NEW) | (1 << PROC_VFORK);
+
+	/* Failed to allocate thread group. */
+	if ((proc->tg = tgalloc()) == NULL)
+	{
+		proc_free(proc);
+		return (-ENOMEM);
+	}
+
+	/* Failed to share process page directory. */
+	if (shrpgdir(proc))
+	{
+		kfree(proc->tg);
+		proc_free(proc);
+		return (-ENOMEM);
+	}
+
+	/* Borrow memory regions. */
+	for (i = 0; i < NR_PREGIONS; i++)
+		proc->tg->pregs[i] = curr_proc->tg->pregs[i];
+
+	initproc(proc);
+
+	/* Wait until the child gives back our address space. */
+	pid = proc->pid;
+	while ((proc->pid == pid) && (proc->flags & (1 << PROC_VFORK)))
+		sleep(&vfork_chain, PRIO_REGION);
+
+	return (pid);
+}
+
+/*
+ * Gives back the address space borrowed with vfork().
+ */
+PUBLIC int vfrelease(int force)
+{
+	int i;
+
+	/* Nothing to be done. */
+	if (!(curr_proc->flags & (1 << PROC_VFORK)))
+		return (0);
+
+	/* Failed to get a page directory. */
+	if (unshrpgdir(force))
+		return (-ENOMEM);
+
+	/* Regions may have grown on behalf of the father. */
+	curr_proc->father->tg->size = curr_proc->tg->size;
+
+	for (i = 0; i < NR_PREGIONS; i++)
+		curr_proc->tg->pregs[i].reg = NULL;
+	curr_proc->tg->size = 0;
+	curr_proc->flags &= ~(1 << PROC_VFORK);
+
+	wakeup(&vfork_chain);
+
+	return (0);
+}
+
+/*
+ * Creates a thread that shares the address space of the caller. The
+ * thread pointer is published in the vDSO data page whenever the thread
+ * runs, so that the thread can find its own descriptor.
+ */
+PUBLIC pid_t sys_clone(void *stack, int *ctid, void *tp)
+{
+	struct process *proc; /* Thread. */
+
+	/* Invalid stack. */
+	if (stack == NULL)
+		return (-EINVAL);
+
+	/* Invalid thread ID location. */
+	if (ctid != NULL)
+	{
+		if (!chkmem(ctid, sizeof(int), MAY_WRITE))
+			return (-EFAULT);
+	}
+
+	/* Threads cannot share a borrowed address space. */
+	if (curr_proc->flags & (1 << PROC_VFORK))
+		return (-EBUSY);
+
+	if ((proc = getproc()) == NULL)
+		return (-EAGAIN);
+
+	/* Mark process as beeing created. */
+	proc->flags = 1 << PROC_NEW;
+
+	/* Failed to share process page directory. */
+	if (shrpgdir(proc))
+	{
+		proc_free(proc);
+		return (-ENOMEM);
+	}
+
+	proc->tg = curr_proc->tg;
+	proc->tg->count++;
+
+	/* Switch to the new user stack. */
+	((struct intstack *)proc->kesp)->useresp = ADDR(stack);
+
+	initproc(proc);
+	proc->tp = tp;
+
+	/* Thread ID location is set now and cleared on exit. */
+	if (ctid != NULL)
+	{
+		*ctid = proc->pid;
+		proc->cleartid = ctid;
+	}
+
+	return (proc->pid);
+}
+
+/**
+ * @brief Creates a kernel thread.
+ *
+ * @details Kernel threads run on the address space and thread group of the
+ *          idle process, so they have no user memory at all. The kernel
+ *          stack is laid out as switch_to() expects to find it, so that the
+ *          thread starts off in kthread_start(), which calls @p fn and then
+ *          dies.
+ *
+ * @param name Thread name.
+ * @param fn   Thread function.
+ * @param arg  Argument to @p fn.
+ *
+ * @returns Upon successful completion, the process ID of the kernel thread is
+ *          returned. Upon failure, a negative error code is returned instead.
+ */
+PUBLIC pid_t kthread_create(const char *name, void (*fn)(void *), void *arg)
+{
+	int i;                /* Loop index.    */
+	dword_t *sp;          /* Stack pointer. */
+	struct process *proc; /* Thread.        */
+
+	/* Shall not occour. */
+	if (curr_proc != IDLE)
+		kpanic("kernel thread not created by idle process");
+
+	if ((proc = getproc()) == NULL)
+		return (-EAGAIN);
+
+	if ((proc->kstack = getkpg(0)) == NULL)
+	{
+		proc_free(proc);
+		return (-ENOMEM);
+	}
+
+	/* Build context for switch_to(). */
+	sp = (dword_t *)((addr_t)proc->kstack + KSTACK_SIZE);
+	*--sp = (dword_t)kthread_start;
+	*--sp = EFLAGS_IF;
+	*--sp = (dword_t)fn;
+	*--sp = (dword_t)arg;
+	*--sp = 0;
+	*--sp = 0;
+	*--sp = 0;
+	proc->kesp = (dword_t)sp;
+
+	proc->flags = 0;
+	proc->cr3 = IDLE->cr3;
+	proc->pgdir = IDLE->pgdir;
+	proc->tg = IDLE->tg;
+	proc->tg->count++;
+
+	initproc(proc);
+
+	kstrncpy(proc->name, name, NAME_MAX);
+	for (i = 0; i < NR_SIGNALS; i++)
+		proc->handlers[i] = SIG_IGN;
+
+	return (proc->pid);
+}
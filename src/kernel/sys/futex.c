@@ -0,0 +1,213 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna   <pedrohenriquepenna@gmail.com>
+ *              2015-2016 Davidson Francis <davidsondfgl@hotmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/hal.h>
+#include <nanvix/mm.h>
+#include <nanvix/pm.h>
+#include <nanvix/region.h>
+#include <sys/futex.h>
+#include <errno.h>
+
+/**
+ * @brief Number of futex wait queues (must be a power of two).
+ */
+#define FUTEX_HASH_SIZE 64
+
+/**
+ * @brief Hashes a futex.
+ *
+ * @param reg Memory region where the futex lives.
+ * @param off Offset of the futex in @p reg.
+ *
+ * @returns The index of the wait queue of the futex.
+ */
+#define FUTEX_HASH(reg, off) \
+	(((ADDR(reg) >> 4) ^ ((off) >> 2)) & (FUTEX_HASH_SIZE - 1))
+
+/**
+ * @brief Futex wait queues.
+ */
+PRIVATE struct process *futex_chains[FUTEX_HASH_SIZE] = { NULL, };
+
+/**
+ * @brief Futex wait queues lock.
+ */
+PRIVATE spinlock_t futex_lock = SPINLOCK_UNLOCKED;
+
+/**
+ * @brief Identifies a futex.
+ *
+ * @details A futex is named after the memory region where it lives and its
+ *          offset therein, rather than after its virtual address, so that
+ *          processes sharing a region agree on the name. Unlike a physical
+ *          address, that name does not change when the underlying page is
+ *          swapped or copied on write.
+ *
+ * @param uaddr Futex.
+ * @param reg   Store location for the memory region.
+ * @param off   Store location for the offset.
+ *
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ */
+PRIVATE int futex_key(int *uaddr, struct region **reg, addr_t *off)
+{
+	struct pregion *preg;
+
+	/* Misaligned futex. */
+	if (ADDR(uaddr) & (sizeof(int) - 1))
+		return (-EINVAL);
+
+	/* Bad futex. */
+	if ((preg = findreg(curr_proc, ADDR(uaddr))) == NULL)
+		return (-EFAULT);
+	if (!(accessreg(curr_proc, preg->reg) & MAY_READ))
+		return (-EFAULT);
+
+	*reg = preg->reg;
+	*off = ADDR(uaddr) - preg->start;
+
+	return (0);
+}
+
+/**
+ * @brief Waits on a futex.
+ *
+ * @param uaddr Futex.
+ * @param val   Expected value of the futex.
+ *
+ * @returns Zero if the calling process was woken up by futex_wake(). If the
+ *          futex did not hold @p val, -EAGAIN is returned. If a signal was
+ *          caught meanwhile, -EINTR is returned.
+ */
+PRIVATE int futex_wait(int *uaddr, int val)
+{
+	int err;                /* Error code.      */
+	int woken;              /* Woken up?        */
+	addr_t off;             /* Futex offset.    */
+	unsigned flags;         /* Interrupt flags. */
+	struct region *reg;     /* Futex region.    */
+	struct process **chain; /* Wait queue.      */
+
+	if ((err = futex_key(uaddr, &reg, &off)) < 0)
+		return (err);
+
+	/*
+	 * Read the futex before grabbing the lock, as it may
+	 * page fault. We cannot be preempted from here on, so
+	 * no wake up can be missed until we get to sleep.
+	 */
+	if (*((volatile int *)uaddr) != val)
+		return (-EAGAIN);
+
+	chain = &futex_chains[FUTEX_HASH(reg, off)];
+
+	flags = spin_lock_irqsave(&futex_lock);
+
+	curr_proc->futex = reg;
+	curr_proc->futex_off = off;
+
+	spin_unlock(&futex_lock);
+	sleep(chain, PRIO_USER);
+	spin_lock(&futex_lock);
+
+	/* Woken up processes are dequeued by futex_wake(). */
+	woken = (curr_proc->futex == NULL);
+	curr_proc->futex = NULL;
+
+	spin_unlock_irqrestore(&futex_lock, flags);
+
+	return ((woken) ? 0 : -EINTR);
+}
+
+/**
+ * @brief Wakes up processes waiting on a futex.
+ *
+ * @param uaddr Futex.
+ * @param n     Maximum number of processes to wake up.
+ *
+ * @returns The number of processes that were woken up, or a negative error
+ *          code upon failure.
+ */
+PRIVATE int futex_wake(int *uaddr, int n)
+{
+	int err;             /* Error code.        */
+	int nwoken;          /* Processes woken.   */
+	addr_t off;          /* Futex offset.      */
+	unsigned flags;      /* Interrupt flags.   */
+	struct region *reg;  /* Futex region.      */
+	struct process *p;   /* Working process.   */
+	struct process **pp; /* Link to process.   */
+
+	if ((err = futex_key(uaddr, &reg, &off)) < 0)
+		return (err);
+
+	nwoken = 0;
+
+	flags = spin_lock_irqsave(&futex_lock);
+
+	pp = &futex_chains[FUTEX_HASH(reg, off)];
+	while (((p = *pp) != NULL) && (nwoken < n))
+	{
+		/* Waiting on some other futex. */
+		if ((p->futex != reg) || (p->futex_off != off))
+		{
+			pp = &p->next;
+			continue;
+		}
+
+		*pp = p->next;
+		p->futex = NULL;
+		sched(p);
+		nwoken++;
+	}
+
+	spin_unlock_irqrestore(&futex_lock, flags);
+
+	return (nwoken);
+}
+
+/**
+ * @brief Fast user-space locking.
+ *
+ * @param uaddr Futex.
+ * @param op    Operation (FUTEX_WAIT or FUTEX_WAKE).
+ * @param val   Expected futex value (FUTEX_WAIT) or maximum number of
+ *              processes to wake up (FUTEX_WAKE).
+ *
+ * @returns See futex_wait() and futex_wake().
+ */
+PUBLIC int sys_futex(int *uaddr, int op, int val)
+{
+	switch (op)
+	{
+		case FUTEX_WAIT:
+			return (futex_wait(uaddr, val));
+
+		case FUTEX_WAKE:
+			return ((val > 0) ? futex_wake(uaddr, val) : 0);
+
+		default:
+			break;
+	}
+
+	return (-EINVAL);
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/fs.h>
+#include <nanvix/mm.h>
+#include <nanvix/pm.h>
+#include <errno.h>
+
+/*
+ * Gets the path name of the current working directory.
+ */
+PUBLIC int sys_getcwd(char *buf, size_t size)
+{
+	/* Invalid size. */
+	if (size == 0)
+		return (-EINVAL);
+
+#if (EDUCATIONAL_KERNEL == 0)
+	/* Invalid buffer. */
+	if (!chkmem(buf, size, MAY_WRITE))
+		return (-EFAULT);
+
+#endif
+
+	return (inode_path(curr_proc->tg->pwd, buf, size));
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/fs.h>
+#include <nanvix/mm.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <errno.h>
+
+/*
+ * Reads directory entries.
+ */
+PUBLIC ssize_t sys_getdents(int fd, struct dirent *buf, size_t n)
+{
+	struct file *f;  /* File.                 */
+	struct inode *i; /* Inode.                */
+	ssize_t count;   /* Bytes actually read.  */
+
+	/* Invalid file descriptor. */
+	if ((fd < 0) || (fd >= OPEN_MAX) || ((f = curr_proc->tg->ofiles[fd]) == NULL))
+		return (-EBADF);
+
+	/* File not opened for reading. */
+	if (ACCMODE(f->oflag) == O_WRONLY)
+		return (-EBADF);
+
+	i = f->inode;
+
+	/* Not a directory. */
+	if (!S_ISDIR(i->mode))
+		return (-ENOTDIR);
+
+	/* Buffer too small. */
+	if (n < sizeof(struct dirent))
+		return (-EINVAL);
+
+#if (EDUCATIONAL_KERNEL == 0)
+	/* Invalid buffer. */
+	if (!chkmem(buf, n, MAY_WRITE))
+		return (-EINVAL);
+
+#endif
+
+	count = dir_read(i, buf, n, &f->pos);
+
+	return (count);
+}
@@ -35,7 +35,7 @@ PUBLIC int sys_ioctl(unsigned fd, unsigned cmd, unsigned arg)
 	struct inode *ip; /* Underlying inode.  */
 
 	/* Invalid file. */
-	if ((fd >= OPEN_MAX) || ((fp = curr_proc->ofiles[fd]) == NULL))
+	if ((fd >= OPEN_MAX) || ((fp = curr_proc->tg->ofiles[fd]) == NULL))
 		return (-EBADF);
 
 	/* Not a character device. */
@@ -33,6 +33,35 @@
 	 (p1->uid == p2->uid)  || (p1->euid == p2->uid) || \
 	 (p1->uid == p2->suid) || (p1->euid == p2->suid))) \
 
+/*
+ * Sends a signal to all members of a process group.
+ */
+PRIVATE int pgrp_kill(struct process *leader, int sig)
+{
+	int err;
+	struct process *p;
+
+	/* No such process group. */
+	if (leader == NULL)
+		return (-ESRCH);
+
+	err = -ESRCH;
+
+	for (p = leader->members; p != NULL; p = p->next_member)
+	{
+		if (err != 0)
+			err = -EPERM;
+
+		if (AUTHORIZED(curr_proc, p, sig))
+		{
+			err = 0;
+			sndsig(p, sig);
+		}
+	}
+
+	return (err);
+}
+
 /*
  * Sends a signal to a process or a process group.
  */
@@ -50,50 +79,22 @@ PUBLIC int sys_kill(pid_t pid, int sig)
 	/* Send signal to process. */
 	if (pid > 0)
 	{
-		/* Search for process. */
-		for (p = FIRST_PROC; p <= LAST_PROC; p++)
+		/* Found. */
+		if ((p = proc_lookup(pid)) != NULL)
 		{
-			/* Skip invalid processes. */
-			if (!IS_VALID(p))
-				continue;
+			err = -EPERM;
 
-			/* Found. */
-			if (pid == p->pid)
+			if (AUTHORIZED(curr_proc, p, sig))
 			{
-				err = -EPERM;
-
-				if (AUTHORIZED(curr_proc, p, sig))
-				{
-					err = 0;
-					sndsig(p, sig);
-				}
+				err = 0;
+				sndsig(p, sig);
 			}
 		}
 	}
 
 	/* Send signal to process group. */
 	else if (pid == 0)
-	{
-		/* Search for processes. */
-		for (p = FIRST_PROC; p <= LAST_PROC; p++)
-		{
-			/* Skip invalid processes. */
-			if (!IS_VALID(p))
-				continue;
-
-			/* Found. */
-			if (curr_proc->pgrp == p->pgrp)
-			{
-				err = -EPERM;
-
-				if (AUTHORIZED(curr_proc, p, sig))
-				{
-					err = 0;
-					sndsig(p, sig);
-				}
-			}
-		}
-	}
+		err = pgrp_kill(curr_proc->pgrp, sig);
 
 	/* Send signal to all processes. */
 	else if (pid == -1)
@@ -118,25 +119,11 @@ PUBLIC int sys_kill(pid_t pid, int sig)
 	/* Send signal to absolute proces group. */
 	else
 	{
-		/* Search for processes. */
-		for (p = FIRST_PROC; p <= LAST_PROC; p++)
-		{
-			/* Skip invalid processes. */
-			if (!IS_VALID(p))
-				continue;
-
-			/* Found. */
-			if (p->pgrp->pid == -pid)
-			{
-				err = -EPERM;
+		p = proc_lookup(-pid);
 
-				if (AUTHORIZED(curr_proc, p, sig))
-				{
-					err = 0;
-					sndsig(p, sig);
-				}
-			}
-		}
+		/* Found. */
+		if ((p != NULL) && (IS_LEADER(p)))
+			err = pgrp_kill(p, sig);
 	}
 
 	return (err);
@@ -68,6 +68,17 @@ PRIVATE void do_link(const char *source, const char *target)
 		return;
 	}
 
+	/* Cross-device link. */
+	if (iparent->dev != isource->dev)
+	{
+		curr_proc->errno = EXDEV;
+		inode_put(iparent);
+		inode_lock(isource);
+		isource->nlinks--;
+		inode_put(isource);
+		return;
+	}
+
 	/* Link target file to source file. */
 	if (dir_add(iparent, isource, name) < 0)
 	{
@@ -0,0 +1,184 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/fs.h>
+#include <nanvix/klib.h>
+#include <nanvix/mm.h>
+#include <nanvix/pm.h>
+#include <nanvix/region.h>
+#include <nanvix/syscall.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include <fcntl.h>
+
+/**
+ * @brief Gets a free memory map slot.
+ *
+ * @param args Mapping arguments.
+ *
+ * @returns Upon successful completion, the index of a free memory map slot is
+ *          returned. Upon failure, a negative error code is returned instead.
+ */
+PRIVATE int getmmap(const struct mmap_args *args)
+{
+	int i;       /* Slot index.      */
+	addr_t addr; /* Requested start. */
+
+	/* Search for free slot. */
+	if (!(args->flags & MAP_FIXED))
+	{
+		for (i = 0; i < NR_MMAPS; i++)
+		{
+			/* Found. */
+			if (MMAP(curr_proc, i)->reg == NULL)
+				return (i);
+		}
+
+		return (-ENOMEM);
+	}
+
+	addr = (addr_t)args->addr;
+
+	/* Mappings must start at a slot boundary. */
+	if ((addr < UMMAP_ADDR) || (addr - UMMAP_ADDR >= NR_MMAPS*REGION_SIZE))
+		return (-EINVAL);
+	if ((addr - UMMAP_ADDR) % REGION_SIZE)
+		return (-EINVAL);
+
+	i = (addr - UMMAP_ADDR)/REGION_SIZE;
+
+	/* Replace existing mapping. */
+	detachreg(curr_proc, MMAP(curr_proc, i));
+
+	return (i);
+}
+
+/*
+ * Maps pages of memory.
+ */
+PUBLIC void *sys_mmap(const struct mmap_args *uargs)
+{
+	int i;                      /* Memory map slot.       */
+	int type;                   /* Mapping type.          */
+	mode_t mode;                /* Access permissions.    */
+	addr_t addr;                /* Mapping address.       */
+	struct file *f;             /* Mapped file.           */
+	struct inode *inode;        /* Mapped inode.          */
+	struct region *reg;         /* Working memory region. */
+	struct pregion *preg;       /* Process region.        */
+	struct mmap_args args;      /* Mapping arguments.     */
+
+	/* Bad arguments. */
+	if (!chkmem(uargs, sizeof(struct mmap_args), MAY_READ))
+		return ((void *)-EFAULT);
+
+	kmemcpy(&args, uargs, sizeof(struct mmap_args));
+
+	/* Invalid length or offset. */
+	if ((args.len == 0) || (args.off < 0) || (args.off & ~PAGE_MASK))
+		return ((void *)-EINVAL);
+
+	/* Mapping does not fit in a memory region. */
+	if (args.len > REGION_SIZE)
+		return ((void *)-ENOMEM);
+
+	/* Mapping must be either shared or private. */
+	type = args.flags & (MAP_SHARED | MAP_PRIVATE);
+	if ((type != MAP_SHARED) && (type != MAP_PRIVATE))
+		return ((void *)-EINVAL);
+
+	/* Get mapped file. */
+	inode = NULL;
+	if (!(args.flags & MAP_ANONYMOUS))
+	{
+		/* Invalid file descriptor. */
+		if ((args.fd < 0) || (args.fd >= OPEN_MAX))
+			return ((void *)-EBADF);
+		if ((f = curr_proc->tg->ofiles[args.fd]) == NULL)
+			return ((void *)-EBADF);
+
+		inode = f->inode;
+
+		/* Only regular files may be mapped. */
+		if (!S_ISREG(inode->mode))
+			return ((void *)-ENODEV);
+
+		/* File not opened for reading. */
+		if (ACCMODE(f->oflag) == O_WRONLY)
+			return ((void *)-EACCES);
+
+		/* Shared writes need write access to the file. */
+		if ((type == MAP_SHARED) && (args.prot & PROT_WRITE))
+		{
+			if (ACCMODE(f->oflag) != O_RDWR)
+				return ((void *)-EACCES);
+		}
+	}
+
+	mode = 0;
+	if (args.prot & PROT_READ)
+		mode |= S_IRUSR;
+	if (args.prot & PROT_WRITE)
+		mode |= S_IWUSR;
+	if (args.prot & PROT_EXEC)
+		mode |= S_IXUSR;
+
+	if ((i = getmmap(&args)) < 0)
+		return ((void *)i);
+
+	preg = MMAP(curr_proc, i);
+	addr = UMMAP_ADDR + i*REGION_SIZE;
+
+	/* Share an existing mapping of the file. */
+	if ((inode != NULL) && (type == MAP_SHARED))
+	{
+		reg = lookupreg(inode, args.off, ALIGN(args.len, PAGE_SIZE), mode);
+
+		if (reg != NULL)
+			goto attach;
+	}
+
+	reg = allocreg(mode, args.len, (type == MAP_SHARED) ? REGION_SHARED : 0);
+
+	/* Failed to allocate region. */
+	if (reg == NULL)
+		return ((void *)-ENOMEM);
+
+	/* Pages are filled in on demand. */
+	if (inode != NULL)
+		loadreg(inode, reg, args.off, args.len);
+
+attach:
+
+	/* Failed to attach region. */
+	if (attachreg(curr_proc, preg, addr, reg))
+	{
+		if (reg->count == 0)
+			freereg(reg);
+		else
+			unlockreg(reg);
+		return ((void *)-ENOMEM);
+	}
+
+	unlockreg(reg);
+
+	return ((void *)addr);
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/mm.h>
+#include <nanvix/pm.h>
+#include <nanvix/region.h>
+#include <sys/mman.h>
+#include <errno.h>
+
+/*
+ * Synchronizes memory with physical storage.
+ */
+PUBLIC int sys_msync(void *addr, size_t len, int flags)
+{
+	int ret;              /* Return value.    */
+	struct pregion *preg; /* Process region.  */
+
+	/* Invalid flags. */
+	if ((flags & MS_ASYNC) && (flags & MS_SYNC))
+		return (-EINVAL);
+
+	/* Address not page aligned. */
+	if ((addr_t)addr & ~PAGE_MASK)
+		return (-EINVAL);
+
+	preg = findreg(curr_proc, (addr_t)addr);
+
+	/* Not a memory map. */
+	if ((preg == NULL) || (preg < MMAP(curr_proc, 0)))
+		return (-ENOMEM);
+
+	/* Range is not mapped. */
+	if ((addr_t)addr + len > preg->start + preg->reg->size)
+		return (-ENOMEM);
+
+	/*
+	 * Write back the whole mapping. Writes go
+	 * to the buffer cache, which is flushed on
+	 * sync() and on eviction, so MS_ASYNC and
+	 * MS_SYNC do the same.
+	 */
+	lockreg(preg->reg);
+	ret = syncreg(preg);
+	unlockreg(preg->reg);
+
+	return ((ret) ? -EIO : 0);
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/mm.h>
+#include <nanvix/pm.h>
+#include <nanvix/region.h>
+#include <errno.h>
+
+/*
+ * Unmaps pages of memory.
+ */
+PUBLIC int sys_munmap(void *addr, size_t len)
+{
+	struct pregion *preg; /* Process region. */
+
+	/* Invalid length. */
+	if (len == 0)
+		return (-EINVAL);
+
+	preg = findreg(curr_proc, (addr_t)addr);
+
+	/* Not a memory map. */
+	if ((preg == NULL) || (preg < MMAP(curr_proc, 0)))
+		return (-EINVAL);
+
+	/* Only whole mappings may be unmapped. */
+	if ((addr_t)addr != preg->start)
+		return (-EINVAL);
+
+	detachreg(curr_proc, preg);
+
+	return (0);
+}
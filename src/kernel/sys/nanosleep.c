@@ -0,0 +1,68 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/clock.h>
+#include <nanvix/const.h>
+#include <nanvix/mm.h>
+#include <nanvix/pm.h>
+#include <errno.h>
+#include <time.h>
+
+/*
+ * Suspends execution for an interval of time.
+ */
+PUBLIC int sys_nanosleep(const struct timespec *rqtp, struct timespec *rmtp)
+{
+	int ret;          /* Return value.   */
+	unsigned nticks;  /* Sleep interval. */
+	unsigned timeout; /* Wakeup tick.    */
+
+	/* Invalid buffers. */
+	if (!chkmem(rqtp, sizeof(struct timespec), MAY_READ))
+		return (-EINVAL);
+	if ((rmtp != NULL) && (!chkmem(rmtp, sizeof(struct timespec), MAY_WRITE)))
+		return (-EINVAL);
+
+	/* Invalid interval. */
+	if ((rqtp->tv_sec < 0) || (rqtp->tv_nsec < 0) || (rqtp->tv_nsec >= 1000000000))
+		return (-EINVAL);
+
+	/*
+	 * Round the interval up to whole clock
+	 * ticks and add one, since the current
+	 * tick is already partially gone.
+	 */
+	if ((unsigned)rqtp->tv_sec > (~0U - ticks)/CLOCK_FREQ - 2)
+		return (-EINVAL);
+	nticks = rqtp->tv_sec*CLOCK_FREQ;
+	nticks += (rqtp->tv_nsec + NSEC_PER_TICK - 1)/NSEC_PER_TICK;
+	timeout = ticks + nticks + 1;
+
+	ret = sleep_until(timeout);
+
+	/* Report remaining time. */
+	if ((ret < 0) && (rmtp != NULL))
+	{
+		nticks = timeout - ticks;
+		rmtp->tv_sec = nticks/CLOCK_FREQ;
+		rmtp->tv_nsec = (nticks%CLOCK_FREQ)*NSEC_PER_TICK;
+	}
+
+	return (ret);
+}
@@ -60,7 +60,7 @@ PRIVATE struct inode *do_creat(struct inode *d, const char *name, mode_t mode, i
 	if (i == NULL)
 		return (NULL);
 
-	i->mode = (mode & MAY_ALL & ~curr_proc->umask) | S_IFREG;
+	i->mode = (mode & MAY_ALL & ~curr_proc->tg->umask) | S_IFREG;
 
 	/* Failed to add directory entry. */
 	if (dir_add(d, i, name))
@@ -220,16 +220,13 @@ PUBLIC int sys_open(const char *path, int oflag, mode_t mode)
 		return (-ENFILE);
 	}
 
-	/* Increment reference count before actually opening
-	 * the file because we can sleep below and another process
-	 * may want to use this file table entry also.  */
 	f->count = 1;
 
 	/* Open file. */
 	if ((i = do_open(name, oflag, mode)) == NULL)
 	{
 		putname(name);
-		f->count = 0;
+		putfile(f);
 		return (curr_proc->errno);
 	}
 
@@ -238,8 +235,8 @@ PUBLIC int sys_open(const char *path, int oflag, mode_t mode)
 	f->pos = 0;
 	f->inode = i;
 
-	curr_proc->ofiles[fd] = f;
-	curr_proc->close &= ~(1 << fd);
+	curr_proc->tg->ofiles[fd] = f;
+	curr_proc->tg->close &= ~(1 << fd);
 
 	putname(name);
 
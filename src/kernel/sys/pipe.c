@@ -35,34 +35,51 @@ PUBLIC int sys_pipe(int fildes[2])
 	if (!chkmem(fildes, 2*sizeof(int), MAY_WRITE))
 		return (-EINVAL);
 
-	/* Get empty file descriptors. */
-	if ((fd[0] = getfildes()) < 0)
-		return (-EMFILE);
-	if ((fd[1] = getfildes()) < 0)
-		return (-EMFILE);
-
 	/* Get empty files. */
 	if ((f[0] = getfile()) == NULL)
-		return (-ENFILE);
+		goto error0;
 	if ((f[1] = getfile()) == NULL)
-		return (-ENFILE);
+		goto error1;
 
 	inode = inode_pipe();
 
 	/* Failed to get pipe inode. */
 	if (inode == NULL)
-		return (-EAGAIN);
+		goto error2;
+
+	/* Get empty file descriptors. */
+	if ((fd[0] = getfildes()) < 0)
+		goto error3;
+	curr_proc->tg->ofiles[fd[0]] = f[0];
+	if ((fd[1] = getfildes()) < 0)
+	{
+		curr_proc->tg->ofiles[fd[0]] = NULL;
+		goto error3;
+	}
+	curr_proc->tg->ofiles[fd[1]] = f[1];
 
 	/* Initialize files. */
 	f[0]->oflag = O_RDONLY;
 	f[1]->oflag = O_WRONLY;
 	f[0]->count = f[1]->count = 1;
 	f[0]->inode = f[1]->inode = inode;
-	curr_proc->ofiles[fd[0]] = f[0];
-	curr_proc->ofiles[fd[1]] = f[1];
+	inode_unlock(inode);
 
 	fildes[0] = fd[0];
 	fildes[1] = fd[1];
 
 	return (0);
+
+error3:
+	inode->count = 1;
+	inode_put(inode);
+	putfile(f[1]);
+	putfile(f[0]);
+	return (-EMFILE);
+error2:
+	putfile(f[1]);
+error1:
+	putfile(f[0]);
+error0:
+	return (-ENFILE);
 }
@@ -0,0 +1,143 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/clock.h>
+#include <nanvix/const.h>
+#include <nanvix/dev.h>
+#include <nanvix/fs.h>
+#include <nanvix/klib.h>
+#include <nanvix/mm.h>
+#include <nanvix/pm.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include <limits.h>
+#include <poll.h>
+
+/*
+ * Milliseconds per clock tick.
+ */
+#define MSEC_PER_TICK (1000/CLOCK_FREQ)
+
+/*
+ * Checks which file descriptors are ready.
+ */
+PRIVATE int poll_scan(struct pollfd *fds, nfds_t nfds)
+{
+	int n;           /* Ready file descriptors. */
+	struct file *f;  /* Working file.           */
+	struct inode *i; /* Working inode.          */
+
+	n = 0;
+	for (nfds_t j = 0; j < nfds; j++)
+	{
+		fds[j].revents = 0;
+
+		/* Ignored entry. */
+		if (fds[j].fd < 0)
+			continue;
+
+		/* Invalid file descriptor. */
+		if ((fds[j].fd >= OPEN_MAX) || ((f = curr_proc->tg->ofiles[fds[j].fd]) == NULL))
+			fds[j].revents = POLLNVAL;
+
+		else
+		{
+			i = f->inode;
+
+			/* Pipe. */
+			if (S_ISFIFO(i->mode))
+				fds[j].revents = pipe_poll(i, fds[j].events);
+
+			/* Character device. */
+			else if (S_ISCHR(i->mode))
+				fds[j].revents = cdev_poll(i->blocks[0], fds[j].events);
+
+			/* Regular files and block devices never block. */
+			else
+				fds[j].revents = fds[j].events;
+
+			fds[j].revents &= fds[j].events | POLLERR | POLLHUP | POLLNVAL;
+		}
+
+		if (fds[j].revents)
+			n++;
+	}
+
+	return (n);
+}
+
+/*
+ * Waits for some event on a set of file descriptors.
+ */
+PUBLIC int sys_poll(struct pollfd *fds, nfds_t nfds, int timeout)
+{
+	int n;                        /* Ready file descriptors. */
+	unsigned flags;               /* Interrupt flag.         */
+	unsigned deadline;            /* Wakeup tick.            */
+	struct polltable table;       /* Polled objects.         */
+	struct pollfd kfds[OPEN_MAX]; /* File descriptors.       */
+
+	/* Too many file descriptors. */
+	if (nfds > OPEN_MAX)
+		return (-EINVAL);
+
+	/* Invalid buffer. */
+	if ((nfds > 0) && (!chkmem(fds, nfds*sizeof(struct pollfd), MAY_WRITE)))
+		return (-EFAULT);
+
+	kmemcpy(kfds, fds, nfds*sizeof(struct pollfd));
+
+	/*
+	 * Round the timeout up to whole clock
+	 * ticks and add one, since the current
+	 * tick is already partially gone.
+	 */
+	deadline = 0;
+	if (timeout > 0)
+		deadline = ticks + ((unsigned)timeout + MSEC_PER_TICK - 1)/MSEC_PER_TICK + 1;
+
+	flags = pollstart(&table);
+
+	while ((n = poll_scan(kfds, nfds)) == 0)
+	{
+		/* Do not wait. */
+		if (timeout == 0)
+			break;
+
+		/* Timeout expired. */
+		if ((deadline) && (ticks >= deadline))
+			break;
+
+		pollsleep(&table, deadline);
+
+		/* Awaken by a signal. */
+		if (issig())
+		{
+			pollstop(&table, flags);
+			return (-EINTR);
+		}
+	}
+
+	pollstop(&table, flags);
+
+	for (nfds_t j = 0; j < nfds; j++)
+		fds[j].revents = kfds[j].revents;
+
+	return (n);
+}
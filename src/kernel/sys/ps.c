@@ -17,7 +17,9 @@
  * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <nanvix/hal.h>
 #include <nanvix/klib.h>
+#include <nanvix/mm.h>
 #include <nanvix/pm.h>
 
 void reverse(char* s)
@@ -140,5 +142,12 @@ PUBLIC int sys_ps()
 	}
 
 	kprintf("\nLast process: %s, pid: %d\n",last_proc->name, last_proc->pid);
+
+	/* Kernel memory allocator statistics. */
+	kcache_stats();
+
+	/* Interrupt handling statistics. */
+	hwint_stats();
+
 	return 0;
 }
@@ -23,67 +23,69 @@
 #include <nanvix/fs.h>
 #include <nanvix/klib.h>
 #include <nanvix/mm.h>
+#include <nanvix/syscall.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <limits.h>
+#include <poll.h>
 
 /*
- * Reads from a file.
+ * Gets a file that is opened for reading.
  */
-PUBLIC ssize_t sys_read(int fd, void *buf, size_t n)
+PRIVATE struct file *rdfile(int fd)
 {
-	dev_t dev;       /* Device number.       */
-	struct file *f;  /* File.                */
-	struct inode *i; /* Inode.               */
-	ssize_t count;   /* Bytes actually read. */
+	struct file *f;
 
 	/* Invalid file descriptor. */
-	if ((fd < 0) || (fd >= OPEN_MAX) || ((f = curr_proc->ofiles[fd]) == NULL))
-		return (-EBADF);
+	if ((fd < 0) || (fd >= OPEN_MAX) || ((f = curr_proc->tg->ofiles[fd]) == NULL))
+		return (NULL);
 
 	/* File not opened for reading. */
 	if (ACCMODE(f->oflag) == O_WRONLY)
-		return (-EBADF);
-
-#if (EDUCATIONAL_KERNEL == 0)
-	/* Invalid buffer. */
-	if (!chkmem(buf, n, MAY_WRITE))
-		return (-EINVAL);
-
-#endif
+		return (NULL);
 
-	/* Nothing to do. */
-	if (n == 0)
-		return (0);
+	return (f);
+}
 
-	 i = f->inode;
+/*
+ * Reads from a file at a given offset.
+ */
+PRIVATE ssize_t do_read
+(struct inode *i, void *buf, size_t n, off_t off, int nonblock)
+{
+	dev_t dev;     /* Device number.       */
+	ssize_t count; /* Bytes actually read. */
 
 	/* Character special file. */
 	if (S_ISCHR(i->mode))
 	{
 		dev = i->blocks[0];
-		count = cdev_read(dev, buf, n);
-		return (count);
+
+		/* Would block. */
+		if ((nonblock) && (!(cdev_poll(dev, POLLIN) & POLLIN)))
+			return (-EAGAIN);
+
+		return (cdev_read(dev, buf, n));
 	}
 
 	/* Block special file. */
 	else if (S_ISBLK(i->mode))
 	{
 		dev = i->blocks[0];
-		count = bdev_read(dev, buf, n, f->pos);
+		count = bdev_read(dev, buf, n, off);
 	}
 
 	/* Pipe file. */
 	else if (S_ISFIFO(i->mode))
 	{
-		count = pipe_read(i, buf, n);
+		count = pipe_read(i, buf, n, nonblock);
 	}
 
 	/* Regular file/directory. */
-	else if ((S_ISDIR(i->mode)) || (S_ISREG(i->mode))){
-		kprintf("file_read\n");
-		count = file_read(i, buf, n, f->pos);
-	}
+	else if ((S_ISDIR(i->mode)) || (S_ISREG(i->mode)))
+		count = file_read(i, buf, n, off);
 
 	/* Unknown file type. */
 	else
@@ -94,7 +96,153 @@ PUBLIC ssize_t sys_read(int fd, void *buf, size_t n)
 		return (curr_proc->errno);
 
 	inode_touch(i);
-	f->pos += count;
+
+	return (count);
+}
+
+/*
+ * Reads from a file.
+ */
+PUBLIC ssize_t sys_read(int fd, void *buf, size_t n)
+{
+	struct file *f;  /* File.                */
+	ssize_t count;   /* Bytes actually read. */
+
+	/* Invalid file descriptor. */
+	if ((f = rdfile(fd)) == NULL)
+		return (-EBADF);
+
+#if (EDUCATIONAL_KERNEL == 0)
+	/* Invalid buffer. */
+	if (!chkmem(buf, n, MAY_WRITE))
+		return (-EINVAL);
+
+#endif
+
+	/* Nothing to do. */
+	if (n == 0)
+		return (0);
+
+	count = do_read(f->inode, buf, n, f->pos, f->oflag & O_NONBLOCK);
+
+	/* Character devices have no file position. */
+	if ((count > 0) && (!S_ISCHR(f->inode->mode)))
+		f->pos += count;
+
+	return (count);
+}
+
+/*
+ * Reads from a file at a given offset.
+ */
+PUBLIC ssize_t sys_pread(const struct pio_args *uargs)
+{
+	struct file *f;       /* File.                */
+	struct pio_args args; /* Read arguments.      */
+
+	/* Bad arguments. */
+	if (!chkmem(uargs, sizeof(struct pio_args), MAY_READ))
+		return (-EFAULT);
+
+	kmemcpy(&args, uargs, sizeof(struct pio_args));
+
+	/* Invalid file descriptor. */
+	if ((f = rdfile(args.fd)) == NULL)
+		return (-EBADF);
+
+	/* Pipes cannot seek. */
+	if (S_ISFIFO(f->inode->mode))
+		return (-ESPIPE);
+
+	/* Invalid offset. */
+	if (args.off < 0)
+		return (-EINVAL);
+
+#if (EDUCATIONAL_KERNEL == 0)
+	/* Invalid buffer. */
+	if (!chkmem(args.buf, args.n, MAY_WRITE))
+		return (-EINVAL);
+
+#endif
+
+	/* Nothing to do. */
+	if (args.n == 0)
+		return (0);
+
+	return (do_read(f->inode, args.buf, args.n, args.off, f->oflag & O_NONBLOCK));
+}
+
+/*
+ * Reads from a file into multiple buffers.
+ */
+PUBLIC ssize_t sys_readv(int fd, const struct iovec *iov, int iovcnt)
+{
+	struct file *f;                 /* File.                */
+	struct inode *i;                /* Inode.               */
+	size_t total;                   /* Bytes requested.     */
+	ssize_t count;                  /* Bytes actually read. */
+	ssize_t n;                      /* Bytes read now.      */
+	struct iovec kiov[IOV_MAX];     /* Buffers.             */
+
+	/* Invalid file descriptor. */
+	if ((f = rdfile(fd)) == NULL)
+		return (-EBADF);
+
+	/* Invalid number of buffers. */
+	if ((iovcnt <= 0) || (iovcnt > IOV_MAX))
+		return (-EINVAL);
+
+	/* Bad buffer list. */
+	if (!chkmem(iov, iovcnt*sizeof(struct iovec), MAY_READ))
+		return (-EFAULT);
+
+	kmemcpy(kiov, iov, iovcnt*sizeof(struct iovec));
+
+	/* Invalid buffers. */
+	total = 0;
+	for (int j = 0; j < iovcnt; j++)
+	{
+		if (kiov[j].iov_len > SSIZE_MAX - total)
+			return (-EINVAL);
+		total += kiov[j].iov_len;
+
+#if (EDUCATIONAL_KERNEL == 0)
+		if (!chkmem(kiov[j].iov_base, kiov[j].iov_len, MAY_WRITE))
+			return (-EINVAL);
+#endif
+	}
+
+	i = f->inode;
+
+	/* Fill buffers in order, in a single kernel entry. */
+	count = 0;
+	for (int j = 0; j < iovcnt; j++)
+	{
+		/* Skip empty buffers. */
+		if (kiov[j].iov_len == 0)
+			continue;
+
+		/* Do not block once some data has been read. */
+		if ((count > 0) && (S_ISCHR(i->mode)))
+			break;
+		if ((count > 0) && (S_ISFIFO(i->mode)) && (i->pipelen == 0))
+			break;
+
+		n = do_read(i, kiov[j].iov_base, kiov[j].iov_len, f->pos,
+			f->oflag & O_NONBLOCK);
+
+		/* Failed to read. */
+		if (n < 0)
+			return ((count > 0) ? count : n);
+
+		if (!S_ISCHR(i->mode))
+			f->pos += n;
+		count += n;
+
+		/* Short read. */
+		if ((size_t)n < kiov[j].iov_len)
+			break;
+	}
 
 	return (count);
 }
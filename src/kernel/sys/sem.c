@@ -1,10 +1,243 @@
+
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
 #include <nanvix/config.h>
 #include <nanvix/const.h>
-#include <sys/sem.h>
+#include <nanvix/mm.h>
+#include <nanvix/pm.h>
+#include <nanvix/sem.h>
+
+/**
+ * @brief Hashes a semaphore set key.
+ *
+ * @param key Key to be hashed.
+ *
+ * @returns The index of the hash chain of @p key.
+ */
+#define SEM_HASH(key) (((unsigned)(key)) & (SEM_HASHSIZE - 1))
+
+/**
+ * @brief Semaphore set table.
+ */
+PUBLIC struct semset semtab[SEM_MAX];
+
+/**
+ * @brief Key hash table of semaphore sets.
+ */
+PRIVATE struct semset *semhash[SEM_HASHSIZE] = { NULL, };
+
+/**
+ * @brief Adjust on exit entries.
+ */
+PRIVATE struct semundo semundos[NR_SEMUNDO];
+
+/**
+ * @brief Free adjust on exit entries.
+ */
+PRIVATE struct semundo *free_semundos = NULL;
+
+/**
+ * @brief Inserts a semaphore set in the key hash table.
+ *
+ * @param set Semaphore set to be inserted.
+ */
+PUBLIC void sem_hash(struct semset *set)
+{
+	unsigned i;
+
+	/* Private sets are not looked up. */
+	if (set->key == IPC_PRIVATE)
+		return;
+
+	i = SEM_HASH(set->key);
+	set->next = semhash[i];
+	semhash[i] = set;
+}
+
+/**
+ * @brief Looks up a semaphore set by key.
+ *
+ * @param key Key of the semaphore set.
+ *
+ * @returns The semaphore set named after @p key, or NULL if there is none.
+ */
+PUBLIC struct semset *sem_lookup(key_t key)
+{
+	struct semset *set;
+
+	for (set = semhash[SEM_HASH(key)]; set != NULL; set = set->next)
+	{
+		/* Found. */
+		if (set->key == key)
+			return (set);
+	}
+
+	return (NULL);
+}
+
+/**
+ * @brief Releases a semaphore set.
+ *
+ * @details Processes sleeping on the set are woken up and find out that the
+ *          set is gone through its sequence number.
+ *
+ * @param set Semaphore set to be released.
+ */
+PUBLIC void sem_free(struct semset *set)
+{
+	struct semset **pp;
+
+	/* Remove set from the hash table. */
+	if (set->key != IPC_PRIVATE)
+	{
+		for (pp = &semhash[SEM_HASH(set->key)]; *pp != set; pp = &(*pp)->next)
+			/* noop */ ;
+		*pp = set->next;
+	}
+
+	kfree(set->sems);
+	set->sems = NULL;
+	set->next = NULL;
+	set->seq++;
+
+	wakeup(&set->chain);
+}
+
+/**
+ * @brief Gets an adjust on exit entry of the current process.
+ *
+ * @param semid Semaphore set ID.
+ * @param num   Semaphore number.
+ *
+ * @returns The adjust on exit entry of the target semaphore. If the current
+ *          process has none, a new zeroed one is allocated. If the entry
+ *          table is full, a NULL pointer is returned instead.
+ */
+PUBLIC struct semundo *sem_undo(int semid, unsigned short num)
+{
+	struct semundo *u;
+
+	for (u = curr_proc->semundo; u != NULL; u = u->next)
+	{
+		if ((u->semid != semid) || (u->num != num))
+			continue;
+
+		/* Left over from a removed set. */
+		if (u->seq != semtab[semid].seq)
+		{
+			u->seq = semtab[semid].seq;
+			u->adj = 0;
+		}
+
+		return (u);
+	}
+
+	/* Entry table overflow. */
+	if ((u = free_semundos) == NULL)
+		return (NULL);
+
+	free_semundos = u->next;
+	u->semid = semid;
+	u->seq = semtab[semid].seq;
+	u->num = num;
+	u->adj = 0;
+	u->next = curr_proc->semundo;
+	curr_proc->semundo = u;
+
+	return (u);
+}
+
+/**
+ * @brief Clears adjust on exit entries of a semaphore.
+ *
+ * @details This is called whenever semctl() sets a semaphore value.
+ *
+ * @param semid Semaphore set ID.
+ * @param num   Semaphore number, or -1 for all semaphores of the set.
+ */
+PUBLIC void sem_unadj(int semid, int num)
+{
+	struct process *p;
+	struct semundo *u;
+
+	for (p = FIRST_PROC; p <= LAST_PROC; p++)
+	{
+		/* Skip invalid processes. */
+		if (!IS_VALID(p))
+			continue;
+
+		for (u = p->semundo; u != NULL; u = u->next)
+		{
+			if ((u->semid == semid) && ((num < 0) || (u->num == num)))
+				u->adj = 0;
+		}
+	}
+}
+
+/**
+ * @brief Applies adjust on exit entries of a process.
+ *
+ * @details Adjusted values are clamped to the valid range, and the entries
+ *          are given back to the free list.
+ *
+ * @param proc Exiting process.
+ */
+PUBLIC void sem_exit(struct process *proc)
+{
+	int val;               /* Adjusted value.   */
+	struct semset *set;    /* Semaphore set.    */
+	struct semaphore *sem; /* Semaphore.        */
+	struct semundo *u;     /* Working entry.    */
+
+	while ((u = proc->semundo) != NULL)
+	{
+		proc->semundo = u->next;
+
+		set = &semtab[u->semid];
+
+		/* Adjust semaphore. */
+		if ((u->adj != 0) && (set->sems != NULL) && (set->seq == u->seq))
+		{
+			sem = &set->sems[u->num];
+			val = sem->semval + u->adj;
+			sem->semval = (val < 0) ? 0 : (val > SEMVMX) ? SEMVMX : val;
+			sem->sempid = proc->pid;
+			wakeup(&set->chain);
+		}
+
+		u->next = free_semundos;
+		free_semundos = u;
+	}
+}
+
 /**
- * @brief Defining the semaphore table.
- * All semaphores are stored in this table.
- * (its always full of non valid semaphores at the beginning)
+ * @brief Initializes System V semaphores.
  */
-PUBLIC struct sem sems[SEM_MAX];
+PUBLIC void sem_init(void)
+{
+	struct semundo *u;
 
+	/* Build free list of adjust on exit entries. */
+	for (u = &semundos[0]; u < &semundos[NR_SEMUNDO]; u++)
+	{
+		u->next = free_semundos;
+		free_semundos = u;
+	}
+}
@@ -1,27 +1,205 @@
+
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/clock.h>
+#include <nanvix/const.h>
+#include <nanvix/fs.h>
+#include <nanvix/klib.h>
+#include <nanvix/mm.h>
+#include <nanvix/pm.h>
+#include <nanvix/sem.h>
+#include <nanvix/syscall.h>
 #include <sys/sem.h>
-#ifdef SEM_ENABLED
+#include <sys/stat.h>
+#include <errno.h>
 
-void destroy(struct sem *semaphore_to_destroy){
-    // TODO Implement the wake up of all processes waiting on the semaphore (semaphore_to_destroy->sleep_queue)
-    semaphore_to_destroy->valid = SEM_INVALID;
-}
+/**
+ * @brief Asserts if the current process owns a semaphore set.
+ *
+ * @param set Target semaphore set.
+ *
+ * @returns True if the current process may change the set, and false
+ *          otherwise.
+ */
+#define ISOWNER(set)                        \
+	(IS_SUPERUSER(curr_proc) ||             \
+	(curr_proc->euid == (set)->perm.uid) || \
+	(curr_proc->euid == (set)->perm.cuid))
 
-int sys_semctl(int semid, int cmd, int val)
+/*
+ * Performs control operations on a semaphore set.
+ */
+PUBLIC int sys_semctl(const struct semctl_args *uargs)
 {
-    struct sem *sem = &sems[semid]; // Get the semaphore from the table using the index
-
-    switch (cmd)
-    {
-    case GETVAL:
-        return sem->n; // Return the value of the semaphore
-    case SETVAL:
-        sem->n = val; // Set the value of the semaphore
-        return 0;
-    case IPC_RMID:
-        destroy(sem); // Destroy the semaphore
-        return 0;
-    }
-
-    return -1; // Return -1 if the command is invalid
+	int semid;                /* Semaphore set ID.  */
+	size_t size;              /* Buffer size.       */
+	struct semset *set;       /* Semaphore set.     */
+	struct semaphore *sem;    /* Target semaphore.  */
+	struct semctl_args args;  /* Control arguments. */
+
+	/* Bad arguments. */
+	if (!chkmem(uargs, sizeof(struct semctl_args), MAY_READ))
+		return (-EFAULT);
+
+	kmemcpy(&args, uargs, sizeof(struct semctl_args));
+
+	semid = args.semid;
+
+	/* Invalid set. */
+	if (!SEM_VALID(semid))
+		return (-EINVAL);
+
+	set = &semtab[semid];
+
+	/* Commands on a single semaphore. */
+	sem = NULL;
+	if ((args.cmd == GETPID) || (args.cmd == GETVAL) || (args.cmd == GETNCNT) ||
+		(args.cmd == GETZCNT) || (args.cmd == SETVAL))
+	{
+		/* Invalid semaphore number. */
+		if ((args.semnum < 0) || (args.semnum >= set->nsems))
+			return (-EINVAL);
+
+		sem = &set->sems[args.semnum];
+	}
+
+	switch (args.cmd)
+	{
+		/* Get semaphore information. */
+		case GETPID:
+		case GETVAL:
+		case GETNCNT:
+		case GETZCNT:
+			/* Not allowed to read the set. */
+			if (!accesssem(set, MAY_READ))
+				return (-EACCES);
+
+			if (args.cmd == GETPID)
+				return (sem->sempid);
+			if (args.cmd == GETVAL)
+				return (sem->semval);
+			return ((args.cmd == GETNCNT) ? sem->semncnt : sem->semzcnt);
+
+		/* Set semaphore value. */
+		case SETVAL:
+			/* Not allowed to change the set. */
+			if (!accesssem(set, MAY_WRITE))
+				return (-EACCES);
+
+			/* Value out of range. */
+			if ((args.arg.val < 0) || (args.arg.val > SEMVMX))
+				return (-ERANGE);
+
+			sem->semval = args.arg.val;
+			sem_unadj(semid, args.semnum);
+			set->ctime = CURRENT_TIME;
+			wakeup(&set->chain);
+			break;
+
+		/* Get all semaphore values. */
+		case GETALL:
+			/* Bad buffer. */
+			size = set->nsems*sizeof(unsigned short);
+			if (!chkmem(args.arg.array, size, MAY_WRITE))
+				return (-EFAULT);
+
+			/* Not allowed to read the set. */
+			if (!accesssem(set, MAY_READ))
+				return (-EACCES);
+
+			for (int i = 0; i < set->nsems; i++)
+				args.arg.array[i] = set->sems[i].semval;
+			break;
+
+		/* Set all semaphore values. */
+		case SETALL:
+			/* Bad buffer. */
+			size = set->nsems*sizeof(unsigned short);
+			if (!chkmem(args.arg.array, size, MAY_READ))
+				return (-EFAULT);
+
+			/* Not allowed to change the set. */
+			if (!accesssem(set, MAY_WRITE))
+				return (-EACCES);
+
+			/* Value out of range. */
+			for (int i = 0; i < set->nsems; i++)
+			{
+				if (args.arg.array[i] > SEMVMX)
+					return (-ERANGE);
+			}
+
+			for (int i = 0; i < set->nsems; i++)
+				set->sems[i].semval = args.arg.array[i];
+			sem_unadj(semid, -1);
+			set->ctime = CURRENT_TIME;
+			wakeup(&set->chain);
+			break;
+
+		/* Get set information. */
+		case IPC_STAT:
+			/* Bad buffer. */
+			if (!chkmem(args.arg.buf, sizeof(struct semid_ds), MAY_WRITE))
+				return (-EFAULT);
+
+			/* Not allowed to read the set. */
+			if (!accesssem(set, MAY_READ))
+				return (-EACCES);
+
+			args.arg.buf->sem_perm = set->perm;
+			args.arg.buf->sem_nsems = set->nsems;
+			args.arg.buf->sem_otime = set->otime;
+			args.arg.buf->sem_ctime = set->ctime;
+			break;
+
+		/* Set set information. */
+		case IPC_SET:
+			/* Bad buffer. */
+			if (!chkmem(args.arg.buf, sizeof(struct semid_ds), MAY_READ))
+				return (-EFAULT);
+
+			/* Not allowed to change the set. */
+			if (!ISOWNER(set))
+				return (-EPERM);
+
+			set->perm.uid = args.arg.buf->sem_perm.uid;
+			set->perm.gid = args.arg.buf->sem_perm.gid;
+			set->perm.mode = args.arg.buf->sem_perm.mode &
+				(S_IRWXU | S_IRWXG | S_IRWXO);
+			set->ctime = CURRENT_TIME;
+			break;
+
+		/* Remove set. */
+		case IPC_RMID:
+			/* Not allowed to change the set. */
+			if (!ISOWNER(set))
+				return (-EPERM);
+
+			/* Sleeping processes fail with EIDRM. */
+			sem_free(set);
+			break;
+
+		/* Invalid command. */
+		default:
+			return (-EINVAL);
+	}
+
+	return (0);
 }
-#endif // SEM_ENABLED
\ No newline at end of file
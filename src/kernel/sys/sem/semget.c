@@ -1,35 +1,98 @@
-#include <sys/sem.h>
+
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/clock.h>
+#include <nanvix/const.h>
+#include <nanvix/fs.h>
+#include <nanvix/mm.h>
 #include <nanvix/pm.h>
+#include <nanvix/sem.h>
+#include <sys/sem.h>
+#include <sys/stat.h>
 #include <errno.h>
 
-#ifdef SEM_ENABLED
-int create(int key){
-    for(int i = 0; i<SEM_MAX;i++){
-         // Find the first invalid semaphore (empty space in the table)
-        if(!sems[i].valid) {
-            // Initialize the semaphore
-            sems[i].valid = 1;
-            sems[i].key = key;
-            sems[i].n = 0;
-            sems[i].sleep_chain = NULL;
-            return i; 
-        }
-    }
-    curr_proc->errno = ENOSPC; // All semaphores are in use
-    return -1;
-}
+/*
+ * Gets a semaphore set.
+ */
+PUBLIC int sys_semget(key_t key, int nsems, int semflg)
+{
+	struct semset *set; /* Working set. */
+
+	/* Look up set. */
+	if (key != IPC_PRIVATE)
+	{
+		if ((set = sem_lookup(key)) != NULL)
+		{
+			/* Set already exists. */
+			if ((semflg & IPC_CREAT) && (semflg & IPC_EXCL))
+				return (-EEXIST);
+
+			/* Set is too small. */
+			if (nsems > set->nsems)
+				return (-EINVAL);
+
+			/* Not allowed to read the set. */
+			if (!accesssem(set, MAY_READ))
+				return (-EACCES);
+
+			return (set - semtab);
+		}
+
+		/* Set does not exist. */
+		if (!(semflg & IPC_CREAT))
+			return (-ENOENT);
+	}
+
+	/* Invalid number of semaphores. */
+	if ((nsems <= 0) || (nsems > SEMMSL))
+		return (-EINVAL);
+
+	/* Search for free set. */
+	for (set = &semtab[0]; set < &semtab[SEM_MAX]; set++)
+	{
+		/* Found. */
+		if (set->sems == NULL)
+			goto found;
+	}
+
+	return (-ENOSPC);
+
+found:
+
+	set->sems = kmalloc(nsems*sizeof(struct semaphore));
+
+	/* Failed to allocate semaphores. */
+	if (set->sems == NULL)
+		return (-ENOMEM);
+
+	set->key = key;
+	set->nsems = nsems;
+	set->perm.uid = curr_proc->euid;
+	set->perm.gid = curr_proc->egid;
+	set->perm.cuid = curr_proc->euid;
+	set->perm.cgid = curr_proc->egid;
+	set->perm.mode = semflg & (S_IRWXU | S_IRWXG | S_IRWXO);
+	set->otime = 0;
+	set->ctime = CURRENT_TIME;
+	set->chain = NULL;
+	sem_hash(set);
 
-int sys_semget(int key){
-    // Look for a semaphore with the given key
-    for (int i = 0; i < SEM_MAX; i++){
-        if(!sems[i].valid){ // If the semaphore is not valid, continue
-            continue;
-        }
-        if (sems[i].key == key){
-            return i; // Found, return its index (id)
-        }
-    }
-    // No semaphore with this key in the table, create it
-    return create(key);
+	return (set - semtab);
 }
-#endif // SEM_ENABLED
\ No newline at end of file
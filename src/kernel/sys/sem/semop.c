@@ -1,40 +1,268 @@
-#include <sys/sem.h>
+
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/clock.h>
+#include <nanvix/const.h>
+#include <nanvix/fs.h>
+#include <nanvix/klib.h>
+#include <nanvix/mm.h>
 #include <nanvix/pm.h>
-#include <nanvix/hal.h>
-#ifdef SEM_ENABLED
-int up(int semid) {
-    disable_interrupts();
-    struct sem *sem = &sems[semid];
-    if (!(sem->valid)) {
-        enable_interrupts();
-        return -1; // Skip invalid semaphore
-    }
-    if (sem->n <= 0 && sem->sleep_chain) {
-        wakeup_one(&(sem->sleep_chain));
-    } else {
-        sem->n++;
-    }
-    enable_interrupts();
-    return 0;
+#include <nanvix/sem.h>
+#include <nanvix/syscall.h>
+#include <sys/sem.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+
+/**
+ * @brief Tries to apply operations to a semaphore set.
+ *
+ * @details Operations are applied in order. If any of them cannot be
+ *          carried out right away, the ones that have already been applied
+ *          are rolled back, so that either all operations take effect or
+ *          none does.
+ *
+ * @param set   Target semaphore set.
+ * @param sops  Operations.
+ * @param nsops Number of operations.
+ * @param blk   Store location for the index of a blocking operation.
+ *
+ * @returns Zero if all operations were applied, one if some operation would
+ *          block, and -ERANGE if some operation would overflow a semaphore.
+ */
+PRIVATE int semtry
+(struct semset *set, const struct sembuf *sops, size_t nsops, size_t *blk)
+{
+	int ret;               /* Return value.      */
+	size_t i;              /* Working operation. */
+	struct semaphore *sem; /* Working semaphore. */
+
+	for (i = 0; i < nsops; i++)
+	{
+		sem = &set->sems[sops[i].sem_num];
+
+		/* Increase. */
+		if (sops[i].sem_op > 0)
+		{
+			if (sem->semval + sops[i].sem_op > SEMVMX)
+			{
+				ret = -ERANGE;
+				goto rollback;
+			}
+		}
+
+		/* Decrease. */
+		else if (sops[i].sem_op < 0)
+		{
+			if (sem->semval < -sops[i].sem_op)
+				goto block;
+		}
+
+		/* Wait for zero. */
+		else if (sem->semval != 0)
+			goto block;
+
+		sem->semval += sops[i].sem_op;
+	}
+
+	return (0);
+
+block:
+	*blk = i;
+	ret = 1;
+
+rollback:
+	while (i-- > 0)
+		set->sems[sops[i].sem_num].semval -= sops[i].sem_op;
+
+	return (ret);
+}
+
+/**
+ * @brief Performs operations on a semaphore set.
+ *
+ * @param semid   Semaphore set ID.
+ * @param usops   Operations.
+ * @param nsops   Number of operations.
+ * @param timeout Clock tick at which to give up waiting (zero for none).
+ *
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ */
+PRIVATE int dosemop
+(int semid, struct sembuf *usops, size_t nsops, unsigned timeout)
+{
+	int ret;                    /* Return value.         */
+	int alter;                  /* Change any semaphore? */
+	size_t i;                   /* Working operation.    */
+	size_t blk;                 /* Blocking operation.   */
+	unsigned seq;               /* Sequence number.      */
+	unsigned short *cnt;        /* Waiting counter.      */
+	struct semset *set;         /* Semaphore set.        */
+	struct semundo *u;          /* Adjust on exit entry. */
+	struct sembuf sops[SEMOPM]; /* Operations.           */
+
+	/* Invalid number of operations. */
+	if (nsops == 0)
+		return (-EINVAL);
+	if (nsops > SEMOPM)
+		return (-E2BIG);
+
+	/* Bad operations. */
+	if (!chkmem(usops, nsops*sizeof(struct sembuf), MAY_READ))
+		return (-EFAULT);
+
+	kmemcpy(sops, usops, nsops*sizeof(struct sembuf));
+
+	/* Invalid set. */
+	if (!SEM_VALID(semid))
+		return (-EINVAL);
+
+	set = &semtab[semid];
+
+	alter = 0;
+	for (i = 0; i < nsops; i++)
+	{
+		/* Invalid semaphore number. */
+		if (sops[i].sem_num >= set->nsems)
+			return (-EFBIG);
+
+		if (sops[i].sem_op != 0)
+			alter = 1;
+	}
+
+	/* Not allowed to operate on the set. */
+	if (!accesssem(set, (alter) ? MAY_WRITE : MAY_READ))
+		return (-EACCES);
+
+	/*
+	 * Set up adjust on exit entries beforehand,
+	 * so that running out of them does not
+	 * leave operations half recorded.
+	 */
+	for (i = 0; i < nsops; i++)
+	{
+		if ((sops[i].sem_flg & SEM_UNDO) && (sops[i].sem_op != 0))
+		{
+			if (sem_undo(semid, sops[i].sem_num) == NULL)
+				return (-ENOSPC);
+		}
+	}
+
+	seq = set->seq;
+
+	while ((ret = semtry(set, sops, nsops, &blk)) > 0)
+	{
+		/* Not allowed to wait. */
+		if (sops[blk].sem_flg & IPC_NOWAIT)
+			return (-EAGAIN);
+
+		/* Timed out. */
+		if ((timeout) && (ticks >= timeout))
+			return (-EAGAIN);
+
+		cnt = (sops[blk].sem_op == 0) ?
+			&set->sems[sops[blk].sem_num].semzcnt :
+			&set->sems[sops[blk].sem_num].semncnt;
+
+		(*cnt)++;
+		curr_proc->timeout = timeout;
+		sleep(&set->chain, PRIO_USER);
+		curr_proc->timeout = 0;
+
+		/* Set removed. */
+		if ((set->sems == NULL) || (set->seq != seq))
+			return (-EIDRM);
+
+		(*cnt)--;
+
+		/* Interrupted. */
+		if (issig() != SIGNULL)
+			return (-EINTR);
+	}
+
+	/* Overflow. */
+	if (ret < 0)
+		return (ret);
+
+	/* Record operations. */
+	for (i = 0; i < nsops; i++)
+	{
+		set->sems[sops[i].sem_num].sempid = curr_proc->pid;
+
+		if ((sops[i].sem_flg & SEM_UNDO) && (sops[i].sem_op != 0))
+		{
+			u = sem_undo(semid, sops[i].sem_num);
+			u->adj -= sops[i].sem_op;
+		}
+	}
+
+	set->otime = CURRENT_TIME;
+
+	/* Let waiters check again. */
+	if (alter)
+		wakeup(&set->chain);
+
+	return (0);
 }
 
-int down(int semid) {
-    disable_interrupts();
-    struct sem *sem = &sems[semid];
-    if (!(sem->valid)) {
-        enable_interrupts();
-        return -1; // Skip invalid semaphore
-    }
-    if (sem->n <= 0) {
-        sleep(&(sem->sleep_chain), curr_proc->priority);
-    } else {
-        sem->n--;
-    }
-    enable_interrupts();
-    return 0;
+/*
+ * Performs operations on a semaphore set.
+ */
+PUBLIC int sys_semop(int semid, struct sembuf *sops, size_t nsops)
+{
+	return (dosemop(semid, sops, nsops, 0));
 }
 
-int sys_semop(int semid, int op){
-    return (op >= 0) ? up(semid) : down(semid);
+/*
+ * Performs operations on a semaphore set with a timeout.
+ */
+PUBLIC int sys_semtimedop(const struct semtimedop_args *uargs)
+{
+	unsigned timeout;            /* Wakeup tick.         */
+	const struct timespec *ts;   /* Timeout.             */
+	struct semtimedop_args args; /* Operation arguments. */
+
+	/* Bad arguments. */
+	if (!chkmem(uargs, sizeof(struct semtimedop_args), MAY_READ))
+		return (-EFAULT);
+
+	kmemcpy(&args, uargs, sizeof(struct semtimedop_args));
+
+	/* Wait forever. */
+	if ((ts = args.timeout) == NULL)
+		return (dosemop(args.semid, args.sops, args.nsops, 0));
+
+	/* Bad timeout. */
+	if (!chkmem(ts, sizeof(struct timespec), MAY_READ))
+		return (-EFAULT);
+
+	/* Invalid timeout. */
+	if ((ts->tv_sec < 0) || (ts->tv_nsec < 0) || (ts->tv_nsec >= 1000000000))
+		return (-EINVAL);
+	if ((unsigned)ts->tv_sec > (~0U - ticks)/CLOCK_FREQ - 2)
+		return (-EINVAL);
+
+	/* Round up to whole clock ticks, as nanosleep() does. */
+	timeout = ticks + ts->tv_sec*CLOCK_FREQ + 1;
+	timeout += (ts->tv_nsec + NSEC_PER_TICK - 1)/NSEC_PER_TICK;
+
+	return (dosemop(args.semid, args.sops, args.nsops, timeout));
 }
-#endif // SEM_ENABLED
\ No newline at end of file
@@ -0,0 +1,128 @@
+
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/fs.h>
+#include <nanvix/mm.h>
+#include <nanvix/pm.h>
+#include <nanvix/region.h>
+#include <nanvix/shm.h>
+#include <sys/shm.h>
+#include <errno.h>
+
+/*
+ * Segments are attached to memory map slots.
+ */
+#if (SHMLBA != REGION_SIZE)
+	#error "bad SHMLBA"
+#endif
+
+/*
+ * Attaches a shared memory segment.
+ */
+PUBLIC void *sys_shmat(int shmid, const void *shmaddr, int shmflg)
+{
+	int i;                /* Memory map slot. */
+	addr_t addr;          /* Attach address.  */
+	struct shm *shm;      /* Segment.         */
+	struct region *reg;   /* Memory region.   */
+	struct pregion *preg; /* Process region.  */
+
+	/* Invalid segment. */
+	if (!SHM_VALID(shmid))
+		return ((void *)-EINVAL);
+
+	shm = &shmtab[shmid];
+	reg = shm->reg;
+
+	/* Not allowed to read the segment. */
+	if (!(accessreg(curr_proc, reg) & MAY_READ))
+		return ((void *)-EACCES);
+
+	/* Not allowed to write the segment. */
+	if (!(shmflg & SHM_RDONLY) && !(accessreg(curr_proc, reg) & MAY_WRITE))
+		return ((void *)-EACCES);
+
+	/* Search for free memory map slot. */
+	if (shmaddr == NULL)
+	{
+		for (i = 0; i < NR_MMAPS; i++)
+		{
+			/* Found. */
+			if (MMAP(curr_proc, i)->reg == NULL)
+				goto found;
+		}
+
+		return ((void *)-EMFILE);
+	}
+
+	addr = (addr_t)shmaddr;
+
+	/* Bad address. */
+	if ((addr < UMMAP_ADDR) || (addr - UMMAP_ADDR >= NR_MMAPS*SHMLBA))
+		return ((void *)-EINVAL);
+
+	/* Round down address. */
+	if (shmflg & SHM_RND)
+		addr -= (addr - UMMAP_ADDR) % SHMLBA;
+
+	/* Address is not properly aligned. */
+	if ((addr - UMMAP_ADDR) % SHMLBA)
+		return ((void *)-EINVAL);
+
+	i = (addr - UMMAP_ADDR)/SHMLBA;
+
+	/* Slot is busy. */
+	if (MMAP(curr_proc, i)->reg != NULL)
+		return ((void *)-EINVAL);
+
+found:
+
+	preg = MMAP(curr_proc, i);
+	addr = UMMAP_ADDR + i*REGION_SIZE;
+
+	lockreg(reg);
+
+	/* Segment was removed while we slept. */
+	if (shm->reg != reg)
+	{
+		unlockreg(reg);
+		return ((void *)-EIDRM);
+	}
+
+	/* Flag attachment. */
+	preg->flags = PREGION_SHM;
+	if (shmflg & SHM_RDONLY)
+		preg->flags |= PREGION_RDONLY;
+
+	/* Failed to attach region. */
+	if (attachreg(curr_proc, preg, addr, reg))
+	{
+		preg->flags = 0;
+		unlockreg(reg);
+		return ((void *)-ENOMEM);
+	}
+
+	shm->lpid = curr_proc->pid;
+
+	unlockreg(reg);
+
+	return ((void *)addr);
+}
@@ -0,0 +1,122 @@
+
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/fs.h>
+#include <nanvix/mm.h>
+#include <nanvix/pm.h>
+#include <nanvix/region.h>
+#include <nanvix/shm.h>
+#include <sys/shm.h>
+#include <sys/stat.h>
+#include <errno.h>
+
+/**
+ * @brief Asserts if the current process owns a shared memory segment.
+ *
+ * @param reg Underlying memory region of the segment.
+ *
+ * @returns True if the current process may change the segment, and false
+ *          otherwise.
+ */
+#define ISOWNER(reg)                       \
+	(IS_SUPERUSER(curr_proc) ||            \
+	(curr_proc->euid == (reg)->uid) ||     \
+	(curr_proc->euid == (reg)->cuid))
+
+/*
+ * Performs control operations on a shared memory segment.
+ */
+PUBLIC int sys_shmctl(int shmid, int cmd, struct shmid_ds *buf)
+{
+	struct shm *shm;    /* Segment.        */
+	struct region *reg; /* Memory region.  */
+
+	/* Invalid segment. */
+	if (!SHM_VALID(shmid))
+		return (-EINVAL);
+
+	shm = &shmtab[shmid];
+	reg = shm->reg;
+
+	switch (cmd)
+	{
+		/* Get segment information. */
+		case IPC_STAT:
+			/* Bad buffer. */
+			if (!chkmem(buf, sizeof(struct shmid_ds), MAY_WRITE))
+				return (-EFAULT);
+
+			/* Not allowed to read the segment. */
+			if (!(accessreg(curr_proc, reg) & MAY_READ))
+				return (-EACCES);
+
+			buf->shm_perm.uid = reg->uid;
+			buf->shm_perm.gid = reg->gid;
+			buf->shm_perm.cuid = reg->cuid;
+			buf->shm_perm.cgid = reg->cgid;
+			buf->shm_perm.mode = reg->mode;
+			buf->shm_segsz = shm->size;
+			buf->shm_lpid = shm->lpid;
+			buf->shm_cpid = shm->cpid;
+			buf->shm_nattch = reg->count - 1;
+			break;
+
+		/* Set segment information. */
+		case IPC_SET:
+			/* Bad buffer. */
+			if (!chkmem(buf, sizeof(struct shmid_ds), MAY_READ))
+				return (-EFAULT);
+
+			/* Not allowed to change the segment. */
+			if (!ISOWNER(reg))
+				return (-EPERM);
+
+			editreg(reg, buf->shm_perm.uid, buf->shm_perm.gid,
+				buf->shm_perm.mode & (S_IRWXU | S_IRWXG | S_IRWXO));
+			break;
+
+		/* Remove segment. */
+		case IPC_RMID:
+			/* Not allowed to change the segment. */
+			if (!ISOWNER(reg))
+				return (-EPERM);
+
+			/*
+			 * Drop the segment's reference to the region.
+			 * Attached processes keep it alive until they
+			 * detach it, exit or call execve().
+			 */
+			lockreg(reg);
+			shm->reg = NULL;
+			reg->count--;
+			unlockreg(reg);
+
+			if (reg->count == 0)
+				freereg(reg);
+			break;
+
+		/* Invalid command. */
+		default:
+			return (-EINVAL);
+	}
+
+	return (0);
+}
@@ -0,0 +1,70 @@
+
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/mm.h>
+#include <nanvix/pm.h>
+#include <nanvix/region.h>
+#include <nanvix/shm.h>
+#include <errno.h>
+
+/*
+ * Detaches a shared memory segment.
+ */
+PUBLIC int sys_shmdt(const void *shmaddr)
+{
+	struct shm *shm;      /* Working segment. */
+	struct region *reg;   /* Memory region.   */
+	struct pregion *preg; /* Process region.  */
+
+	preg = findreg(curr_proc, (addr_t)shmaddr);
+
+	/* Not a memory map. */
+	if ((preg == NULL) || (preg < MMAP(curr_proc, 0)))
+		return (-EINVAL);
+
+	/* Not the start of the memory map. */
+	if ((addr_t)shmaddr != preg->start)
+		return (-EINVAL);
+
+	reg = preg->reg;
+
+	/*
+	 * Not a shared memory segment. Segments removed
+	 * with IPC_RMID are no longer in the segment table,
+	 * so attachments are recognized by their flags.
+	 */
+	if (!(preg->flags & PREGION_SHM))
+		return (-EINVAL);
+
+	/* Update segment information. */
+	for (shm = &shmtab[0]; shm < &shmtab[SHM_MAX]; shm++)
+	{
+		if (shm->reg == reg)
+		{
+			shm->lpid = curr_proc->pid;
+			break;
+		}
+	}
+
+	detachreg(curr_proc, preg);
+
+	return (0);
+}
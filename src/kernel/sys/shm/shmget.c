@@ -0,0 +1,100 @@
+
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/fs.h>
+#include <nanvix/pm.h>
+#include <nanvix/region.h>
+#include <nanvix/shm.h>
+#include <sys/shm.h>
+#include <sys/stat.h>
+#include <errno.h>
+
+/*
+ * Gets a shared memory segment.
+ */
+PUBLIC int sys_shmget(key_t key, size_t size, int shmflg)
+{
+	struct shm *shm;    /* Working segment. */
+	struct region *reg; /* Memory region.   */
+
+	/* Look up segment. */
+	if (key != IPC_PRIVATE)
+	{
+		for (shm = &shmtab[0]; shm < &shmtab[SHM_MAX]; shm++)
+		{
+			/* Skip free segments and other keys. */
+			if ((shm->reg == NULL) || (shm->key != key))
+				continue;
+
+			/* Segment already exists. */
+			if ((shmflg & IPC_CREAT) && (shmflg & IPC_EXCL))
+				return (-EEXIST);
+
+			/* Segment is too small. */
+			if (size > shm->size)
+				return (-EINVAL);
+
+			/* Not allowed to read the segment. */
+			if (!(accessreg(curr_proc, shm->reg) & MAY_READ))
+				return (-EACCES);
+
+			return (shm - shmtab);
+		}
+
+		/* Segment does not exist. */
+		if (!(shmflg & IPC_CREAT))
+			return (-ENOENT);
+	}
+
+	/* Invalid size. */
+	if ((size == 0) || (size > REGION_SIZE))
+		return (-EINVAL);
+
+	/* Search for free segment. */
+	for (shm = &shmtab[0]; shm < &shmtab[SHM_MAX]; shm++)
+	{
+		/* Found. */
+		if (shm->reg == NULL)
+			goto found;
+	}
+
+	return (-ENOSPC);
+
+found:
+
+	reg = allocreg(shmflg & (S_IRWXU|S_IRWXG|S_IRWXO), size, REGION_SHARED);
+
+	/* Failed to allocate region. */
+	if (reg == NULL)
+		return (-ENOMEM);
+
+	/* The segment holds a reference to the region. */
+	reg->count++;
+	unlockreg(reg);
+
+	shm->key = key;
+	shm->reg = reg;
+	shm->size = size;
+	shm->cpid = curr_proc->pid;
+	shm->lpid = 0;
+
+	return (shm - shmtab);
+}
@@ -76,5 +76,27 @@ PUBLIC void (*syscalls_table[NR_SYSCALLS])(void)  = {
 	(void (*)(void))&sys_semget,
 	(void (*)(void))&sys_semctl,
 	(void (*)(void))&sys_semop,
-	(void (*)(void))&sys_test
+	(void (*)(void))&sys_test,
+	(void (*)(void))&sys_vfork,
+	(void (*)(void))&sys_mmap,
+	(void (*)(void))&sys_munmap,
+	(void (*)(void))&sys_msync,
+	(void (*)(void))&sys_shmget,
+	(void (*)(void))&sys_shmat,
+	(void (*)(void))&sys_shmdt,
+	(void (*)(void))&sys_shmctl,
+	(void (*)(void))&sys_clock_gettime,
+	(void (*)(void))&sys_nanosleep,
+	(void (*)(void))&sys_futex,
+	(void (*)(void))&sys_semtimedop,
+	(void (*)(void))&sys_clone,
+	(void (*)(void))&sys_thread_exit,
+	(void (*)(void))&sys_getdents,
+	(void (*)(void))&sys_getcwd,
+	(void (*)(void))&sys_copy_file_range,
+	(void (*)(void))&sys_pread,
+	(void (*)(void))&sys_pwrite,
+	(void (*)(void))&sys_readv,
+	(void (*)(void))&sys_writev,
+	(void (*)(void))&sys_poll
 };
@@ -30,9 +30,9 @@ PUBLIC mode_t sys_umask(mode_t cmask)
 {
 	mode_t old_mask;
 
-	old_mask = curr_proc->umask;
+	old_mask = curr_proc->tg->umask;
 
-	curr_proc->umask = cmask & (MAY_READ | MAY_WRITE | MAY_EXEC);
+	curr_proc->tg->umask = cmask & (MAY_READ | MAY_WRITE | MAY_EXEC);
 
 	return (old_mask);
 }
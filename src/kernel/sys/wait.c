@@ -20,12 +20,10 @@
 #include <nanvix/const.h>
 #include <nanvix/mm.h>
 #include <nanvix/pm.h>
+#include <nanvix/vdso.h>
 #include <sys/types.h>
 #include <errno.h>
 
-/* Sleeping chain. */
-PRIVATE struct process *chain = NULL;
-
 /*
  * Waits for a child process to terminate.
  */
@@ -46,55 +44,48 @@ repeat:
 		return (-ECHILD);
 
 	/* Look for child processes. */
-	for (p = FIRST_PROC; p <= LAST_PROC; p++)
+	for (p = curr_proc->children; p != NULL; p = p->next_sibling)
 	{
-		/* Skip invalid processes. */
-		if (!IS_VALID(p))
-			continue;
+		/* Stopped. */
+		if (p->state == PROC_STOPPED)
+		{
+			/* Already reported. */
+			if (p->status)
+				continue;
+
+			p->status = 1 << 10;
+
+			/* Get exit code. */
+			if (stat_loc != NULL)
+				*stat_loc = p->status;
+
+			return (p->pid);
+		}
 
-		 /* Found. */
-		if (p->father == curr_proc)
+		/* Terminated. */
+		else if (p->state == PROC_ZOMBIE)
 		{
-			/* Stopped. */
-			if (p->state == PROC_STOPPED)
-			{
-				/* Already reported. */
-				if (p->status)
-					continue;
-
-				p->status = 1 << 10;
-
-				/* Get exit code. */
-				if (stat_loc != NULL)
-					*stat_loc = p->status;
-
-				return (p->pid);
-			}
-
-			/* Terminated. */
-			else if (p->state == PROC_ZOMBIE)
-			{
-				/* Get exit code. */
-				if (stat_loc != NULL)
-					*stat_loc = p->status;
-
-				/*
-				 * Get information from child
-				 * process before burying it.
-				 */
-				pid = p->pid;
-				curr_proc->cutime += p->utime;
-				curr_proc->cktime += p->ktime;
-
-				/* Bury child process. */
-				bury(p);
-
-				return (pid);
-			}
+			/* Get exit code. */
+			if (stat_loc != NULL)
+				*stat_loc = p->status;
+
+			/*
+			 * Get information from child
+			 * process before burying it.
+			 */
+			pid = p->pid;
+			curr_proc->cutime += p->utime;
+			curr_proc->cktime += p->ktime;
+			vdso_update(curr_proc);
+
+			/* Bury child process. */
+			bury(p);
+
+			return (pid);
 		}
 	}
 
-	sleep(&chain, PRIO_USER);
+	sleep(&curr_proc->wchain, PRIO_USER);
 	sig = issig();
 
 	/* Go back and check what happened. */
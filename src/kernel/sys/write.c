@@ -23,77 +23,221 @@
 #include <nanvix/fs.h>
 #include <nanvix/klib.h>
 #include <nanvix/mm.h>
+#include <nanvix/syscall.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <fcntl.h>
 #include <errno.h>
-#include <nanvix/klib.h>
+#include <limits.h>
+#include <poll.h>
+
 /*
- * Writes to a file.
+ * Gets a file that is opened for writing.
  */
-PUBLIC ssize_t sys_write(int fd, const void *buf, size_t n)
+PRIVATE struct file *wrfile(int fd)
 {
-	dev_t dev;         /* Device number.          */
-	struct file *f;    /* File.                   */
-	struct inode *i;   /* Inode.                  */
-	ssize_t count = 0; /* Bytes actually written. */
+	struct file *f;
 
 	/* Invalid file descriptor. */
-	if ((fd < 0) || (fd >= OPEN_MAX) || ((f = curr_proc->ofiles[fd]) == NULL))
-		return (-EBADF);
+	if ((fd < 0) || (fd >= OPEN_MAX) || ((f = curr_proc->tg->ofiles[fd]) == NULL))
+		return (NULL);
 
 	/* File not opened for writing. */
 	if (ACCMODE(f->oflag) == O_RDONLY)
-		return (-EBADF);
-
-#if (EDUCATIONAL_KERNEL == 0)
-
-	/* Invalid buffer. */
-	if (!chkmem(buf, n, MAY_READ))
-		return (-EINVAL);
+		return (NULL);
 
-#endif
-
-	/* Nothing to do. */
-	if (n == 0)
-		return (0);
-
-	i = f->inode;
+	return (f);
+}
 
-	/* Append mode. */
-	if (f->oflag & O_APPEND)
-		f->pos = i->size;
+/*
+ * Writes to a file at a given offset.
+ */
+PRIVATE ssize_t do_write
+(struct inode *i, const void *buf, size_t n, off_t off, int nonblock)
+{
+	dev_t dev;         /* Device number.          */
+	ssize_t count = 0; /* Bytes actually written. */
 
 	/* Character special file. */
 	if (S_ISCHR(i->mode))
 	{
 		dev = i->blocks[0];
-		count = cdev_write(dev, buf, n);
-		return (count);
+
+		/* Would block. */
+		if ((nonblock) && (!(cdev_poll(dev, POLLOUT) & POLLOUT)))
+			return (-EAGAIN);
+
+		return (cdev_write(dev, buf, n));
 	}
 
 	/* Block special file. */
 	else if (S_ISBLK(i->mode))
 	{
 		dev = i->blocks[0];
-		count = bdev_write(dev, buf, n, f->pos);
+		count = bdev_write(dev, buf, n, off);
 	}
 
 	/* Pipe file. */
 	else if (S_ISFIFO(i->mode))
 	{
-		kprintf("write to pipe");
-		count = pipe_write(i, buf, n);
+		count = pipe_write(i, buf, n, nonblock);
 	}
 
 	/* Regular file. */
 	else if (S_ISREG(i->mode))
-		count = file_write(i, buf, n, f->pos);
+		count = file_write(i, buf, n, off);
 
 	/* Failed to write. */
 	if (count < 0)
 		return (curr_proc->errno);
 
-	f->pos += count;
+	return (count);
+}
+
+/*
+ * Writes to a file.
+ */
+PUBLIC ssize_t sys_write(int fd, const void *buf, size_t n)
+{
+	struct file *f; /* File.                   */
+	ssize_t count;  /* Bytes actually written. */
+
+	/* Invalid file descriptor. */
+	if ((f = wrfile(fd)) == NULL)
+		return (-EBADF);
+
+#if (EDUCATIONAL_KERNEL == 0)
+
+	/* Invalid buffer. */
+	if (!chkmem(buf, n, MAY_READ))
+		return (-EINVAL);
+
+#endif
+
+	/* Nothing to do. */
+	if (n == 0)
+		return (0);
+
+	/* Append mode. */
+	if (f->oflag & O_APPEND)
+		f->pos = f->inode->size;
+
+	count = do_write(f->inode, buf, n, f->pos, f->oflag & O_NONBLOCK);
+
+	/* Character devices have no file position. */
+	if ((count > 0) && (!S_ISCHR(f->inode->mode)))
+		f->pos += count;
+
+	return (count);
+}
+
+/*
+ * Writes to a file at a given offset.
+ */
+PUBLIC ssize_t sys_pwrite(const struct pio_args *uargs)
+{
+	struct file *f;       /* File.            */
+	struct pio_args args; /* Write arguments. */
+
+	/* Bad arguments. */
+	if (!chkmem(uargs, sizeof(struct pio_args), MAY_READ))
+		return (-EFAULT);
+
+	kmemcpy(&args, uargs, sizeof(struct pio_args));
+
+	/* Invalid file descriptor. */
+	if ((f = wrfile(args.fd)) == NULL)
+		return (-EBADF);
+
+	/* Pipes cannot seek. */
+	if (S_ISFIFO(f->inode->mode))
+		return (-ESPIPE);
+
+	/* Invalid offset. */
+	if (args.off < 0)
+		return (-EINVAL);
+
+#if (EDUCATIONAL_KERNEL == 0)
+
+	/* Invalid buffer. */
+	if (!chkmem(args.buf, args.n, MAY_READ))
+		return (-EINVAL);
+
+#endif
+
+	/* Nothing to do. */
+	if (args.n == 0)
+		return (0);
+
+	return (do_write(f->inode, args.buf, args.n, args.off, f->oflag & O_NONBLOCK));
+}
+
+/*
+ * Writes to a file from multiple buffers.
+ */
+PUBLIC ssize_t sys_writev(int fd, const struct iovec *iov, int iovcnt)
+{
+	struct file *f;             /* File.                   */
+	size_t total;               /* Bytes requested.        */
+	ssize_t count;              /* Bytes actually written. */
+	ssize_t n;                  /* Bytes written now.      */
+	struct iovec kiov[IOV_MAX]; /* Buffers.                */
+
+	/* Invalid file descriptor. */
+	if ((f = wrfile(fd)) == NULL)
+		return (-EBADF);
+
+	/* Invalid number of buffers. */
+	if ((iovcnt <= 0) || (iovcnt > IOV_MAX))
+		return (-EINVAL);
+
+	/* Bad buffer list. */
+	if (!chkmem(iov, iovcnt*sizeof(struct iovec), MAY_READ))
+		return (-EFAULT);
+
+	kmemcpy(kiov, iov, iovcnt*sizeof(struct iovec));
+
+	/* Invalid buffers. */
+	total = 0;
+	for (int j = 0; j < iovcnt; j++)
+	{
+		if (kiov[j].iov_len > SSIZE_MAX - total)
+			return (-EINVAL);
+		total += kiov[j].iov_len;
+
+#if (EDUCATIONAL_KERNEL == 0)
+		if (!chkmem(kiov[j].iov_base, kiov[j].iov_len, MAY_READ))
+			return (-EINVAL);
+#endif
+	}
+
+	/* Append mode. */
+	if (f->oflag & O_APPEND)
+		f->pos = f->inode->size;
+
+	/* Drain buffers in order, in a single kernel entry. */
+	count = 0;
+	for (int j = 0; j < iovcnt; j++)
+	{
+		/* Skip empty buffers. */
+		if (kiov[j].iov_len == 0)
+			continue;
+
+		n = do_write(f->inode, kiov[j].iov_base, kiov[j].iov_len, f->pos,
+			f->oflag & O_NONBLOCK);
+
+		/* Failed to write. */
+		if (n < 0)
+			return ((count > 0) ? count : n);
+
+		if (!S_ISCHR(f->inode->mode))
+			f->pos += n;
+		count += n;
+
+		/* Short write. */
+		if ((size_t)n < kiov[j].iov_len)
+			break;
+	}
 
 	return (count);
 }
@@ -25,6 +25,11 @@
  */
 extern int main(int argc, char **argv);
 
+/*
+ * Selects the system call entry.
+ */
+extern void __sysentry_init(void);
+
 /*
  * Entry point of the program.
  */
@@ -32,6 +37,8 @@ void _start(int argc, char **argv, char **envp)
 {
 	int ret;
 
+	__sysentry_init();
+
 	environ = envp;
 
 	ret= main(argc, argv);
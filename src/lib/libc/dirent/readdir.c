@@ -17,19 +17,15 @@
  * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <nanvix/fs.h>
 #include <dirent.h>
 #include <stdlib.h>
-#include <unistd.h>
-#include <stdio.h>
 
 /*
  * Reads a directory.
  */
 struct dirent *readdir(DIR *dirp)
 {
-	struct dirent *buf; /* Buffer.         */
-	struct dirent *dp;  /* Working dirent. */
+	struct dirent *buf; /* Buffer. */
 
 	/* End of directory. */
 	if (dirp->flags & _DIR_EOD)
@@ -37,15 +33,9 @@ struct dirent *readdir(DIR *dirp)
 
 	do
 	{
-		/* Get next non-empty directory entry. */
-		while (--dirp->count >= 0)
-		{
-			dp = dirp->ptr++;
-
-			/* Found. */
-			if (dp->d_ino != INODE_NULL)
-				return (dp);
-		}
+		/* Get next directory entry. */
+		if (--dirp->count >= 0)
+			return (dirp->ptr++);
 
 		/* Allocate buffer. */
 		if ((buf = dirp->buf) == NULL)
@@ -56,7 +46,10 @@ struct dirent *readdir(DIR *dirp)
 				return (NULL);
 		}
 
-		dirp->count = read(dirp->fd, buf, _DIR_BUFSIZ)/sizeof(struct dirent);
+		/* Only live entries are returned. */
+		dirp->count = getdents(dirp->fd, buf, _DIR_BUFSIZ);
+		if (dirp->count > 0)
+			dirp->count /= sizeof(struct dirent);
 
 		/* Reset buffer. */
 		dirp->ptr = buf;
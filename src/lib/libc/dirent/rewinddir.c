@@ -18,15 +18,18 @@
  */
 
 #include <dirent.h>
+#include <unistd.h>
 
 /*
  * Rewinds a directory stream.
  */
 void rewinddir(DIR *dirp)
 {
+	lseek(dirp->fd, 0, SEEK_SET);
+
 	/* Invalidate buffer. */
 	dirp->count = 0;
-	dirp->buf = dirp->ptr;
+	dirp->ptr = dirp->buf;
 	dirp->flags &= ~_DIR_EOD;
 }
 
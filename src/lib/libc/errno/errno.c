@@ -23,8 +23,31 @@
  * @brief errno variable.
  */
 
+#include <nanvix/vdso.h>
+#include <errno.h>
+#include <stddef.h>
+
+/**
+ * @brief Number of last error of the initial thread.
+ */
+static int main_errno = 0;
+
 /**
- * @brief Number of last error.
+ * @brief Gets the location of errno for the calling thread.
+ *
+ * @details Threads that are created with pthread_create() register their
+ *          descriptor as thread pointer, and the kernel publishes it in the
+ *          vDSO data page whenever they run. The number of last error is the
+ *          first field of the descriptor.
+ *
+ * @returns The location of errno for the calling thread.
  */
-int errno = 0;
+int *__errno(void)
+{
+	int *err;
+
+	err = (int *)VDSO->tp;
+
+	return ((err != NULL) ? err : &main_errno);
+}
 
@@ -28,20 +28,22 @@
 int fcntl(int fd, int cmd, ...)
 {
 	int ret;      /* Return value.      */
-	int arg;      /* Creation mode.     */
+	int arg;      /* Command argument.  */
 	va_list varg; /* Variable argument. */
 
 	arg = 0;
 
-	if (cmd == F_DUPFD)
+	/* Commands that take an argument. */
+	if ((cmd == F_DUPFD) || (cmd == F_SETFD) || (cmd == F_SETFL) ||
+		(cmd == F_SETPIPE_SZ))
 	{
-		va_start(varg, arg);
-		arg = va_arg(varg, int)
+		va_start(varg, cmd);
+		arg = va_arg(varg, int);
 		va_end(varg);
 	}
 
 	__asm__ volatile (
-		"int $0x80"
+		"call *__sysentry"
 		: "=a" (ret)
 		: "0" (NR_fcntl),
 		  "b" (fd),
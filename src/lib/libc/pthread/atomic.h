@@ -0,0 +1,87 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna   <pedrohenriquepenna@gmail.com>
+ *              2015-2016 Davidson Francis <davidsondfgl@hotmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _ATOMIC_H_
+#define _ATOMIC_H_
+
+	/**
+	 * @brief Atomically compares and exchanges a word.
+	 *
+	 * @param p   Target word.
+	 * @param old Expected value.
+	 * @param new New value.
+	 *
+	 * @returns The value that @p p held.
+	 */
+	static inline int atomic_cmpxchg(volatile int *p, int old, int new)
+	{
+		int prev;
+
+		__asm__ volatile (
+			"lock; cmpxchgl %2, %1"
+			: "=a" (prev), "+m" (*p)
+			: "r" (new), "0" (old)
+			: "memory"
+		);
+
+		return (prev);
+	}
+
+	/**
+	 * @brief Atomically exchanges a word.
+	 *
+	 * @param p   Target word.
+	 * @param new New value.
+	 *
+	 * @returns The value that @p p held.
+	 */
+	static inline int atomic_xchg(volatile int *p, int new)
+	{
+		__asm__ volatile (
+			"xchgl %0, %1"
+			: "+r" (new), "+m" (*p)
+			:
+			: "memory"
+		);
+
+		return (new);
+	}
+
+	/**
+	 * @brief Atomically adds to a word.
+	 *
+	 * @param p   Target word.
+	 * @param val Value to add.
+	 *
+	 * @returns The value that @p p held.
+	 */
+	static inline int atomic_add(volatile int *p, int val)
+	{
+		__asm__ volatile (
+			"lock; xaddl %0, %1"
+			: "+r" (val), "+m" (*p)
+			:
+			: "memory"
+		);
+
+		return (val);
+	}
+
+#endif /* _ATOMIC_H_ */
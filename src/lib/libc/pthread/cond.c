@@ -0,0 +1,116 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna   <pedrohenriquepenna@gmail.com>
+ *              2015-2016 Davidson Francis <davidsondfgl@hotmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sys/futex.h>
+#include <limits.h>
+#include <pthread.h>
+#include "atomic.h"
+
+/**
+ * @brief Initializes a condition variable.
+ *
+ * @param cond Target condition variable.
+ * @param attr Condition variable attributes (ignored).
+ *
+ * @returns Zero.
+ */
+int pthread_cond_init(pthread_cond_t *cond, const pthread_condattr_t *attr)
+{
+	((void) attr);
+
+	cond->seq = 0;
+
+	return (0);
+}
+
+/**
+ * @brief Destroys a condition variable.
+ *
+ * @param cond Target condition variable.
+ *
+ * @returns Zero.
+ */
+int pthread_cond_destroy(pthread_cond_t *cond)
+{
+	((void) cond);
+
+	return (0);
+}
+
+/**
+ * @brief Waits on a condition variable.
+ *
+ * @details The caller sleeps until the signal count of @p cond changes, so a
+ *          signal sent after @p mutex is released is never missed. As with
+ *          any condition variable, wake ups may be spurious.
+ *
+ * @param cond  Target condition variable.
+ * @param mutex Mutex that the caller holds.
+ *
+ * @returns Zero.
+ */
+int pthread_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mutex)
+{
+	int seq;
+
+	seq = cond->seq;
+
+	pthread_mutex_unlock(mutex);
+	futex((int *)&cond->seq, FUTEX_WAIT, seq);
+
+	/*
+	 * Others may be waiting on the mutex along
+	 * with us, so take it as contended.
+	 */
+	while (atomic_xchg(&mutex->lock, MUTEX_CONTENDED) != MUTEX_UNLOCKED)
+		futex((int *)&mutex->lock, FUTEX_WAIT, MUTEX_CONTENDED);
+
+	return (0);
+}
+
+/**
+ * @brief Wakes up one process waiting on a condition variable.
+ *
+ * @param cond Target condition variable.
+ *
+ * @returns Zero.
+ */
+int pthread_cond_signal(pthread_cond_t *cond)
+{
+	atomic_add(&cond->seq, 1);
+	futex((int *)&cond->seq, FUTEX_WAKE, 1);
+
+	return (0);
+}
+
+/**
+ * @brief Wakes up all processes waiting on a condition variable.
+ *
+ * @param cond Target condition variable.
+ *
+ * @returns Zero.
+ */
+int pthread_cond_broadcast(pthread_cond_t *cond)
+{
+	atomic_add(&cond->seq, 1);
+	futex((int *)&cond->seq, FUTEX_WAKE, INT_MAX);
+
+	return (0);
+}
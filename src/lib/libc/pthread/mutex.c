@@ -0,0 +1,120 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna   <pedrohenriquepenna@gmail.com>
+ *              2015-2016 Davidson Francis <davidsondfgl@hotmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sys/futex.h>
+#include <pthread.h>
+#include <errno.h>
+#include "atomic.h"
+
+/**
+ * @brief Initializes a mutex.
+ *
+ * @param mutex Target mutex.
+ * @param attr  Mutex attributes (ignored).
+ *
+ * @returns Zero.
+ */
+int pthread_mutex_init(pthread_mutex_t *mutex, const pthread_mutexattr_t *attr)
+{
+	((void) attr);
+
+	mutex->lock = MUTEX_UNLOCKED;
+
+	return (0);
+}
+
+/**
+ * @brief Destroys a mutex.
+ *
+ * @param mutex Target mutex.
+ *
+ * @returns Zero if @p mutex is unlocked, and EBUSY otherwise.
+ */
+int pthread_mutex_destroy(pthread_mutex_t *mutex)
+{
+	return ((mutex->lock != MUTEX_UNLOCKED) ? EBUSY : 0);
+}
+
+/**
+ * @brief Locks a mutex.
+ *
+ * @details The uncontended case is a single compare-and-exchange. Otherwise,
+ *          the mutex is marked as contended and the caller sleeps in the
+ *          kernel until the lock word changes.
+ *
+ * @param mutex Target mutex.
+ *
+ * @returns Zero.
+ */
+int pthread_mutex_lock(pthread_mutex_t *mutex)
+{
+	int c;
+
+	/* Fast path. */
+	c = atomic_cmpxchg(&mutex->lock, MUTEX_UNLOCKED, MUTEX_LOCKED);
+	if (c == MUTEX_UNLOCKED)
+		return (0);
+
+	/* Slow path. */
+	if (c != MUTEX_CONTENDED)
+		c = atomic_xchg(&mutex->lock, MUTEX_CONTENDED);
+	while (c != MUTEX_UNLOCKED)
+	{
+		futex((int *)&mutex->lock, FUTEX_WAIT, MUTEX_CONTENDED);
+		c = atomic_xchg(&mutex->lock, MUTEX_CONTENDED);
+	}
+
+	return (0);
+}
+
+/**
+ * @brief Attempts to lock a mutex.
+ *
+ * @param mutex Target mutex.
+ *
+ * @returns Zero if the mutex was locked, and EBUSY if it was already locked.
+ */
+int pthread_mutex_trylock(pthread_mutex_t *mutex)
+{
+	int c;
+
+	c = atomic_cmpxchg(&mutex->lock, MUTEX_UNLOCKED, MUTEX_LOCKED);
+	if (c != MUTEX_UNLOCKED)
+		return (EBUSY);
+
+	return (0);
+}
+
+/**
+ * @brief Unlocks a mutex.
+ *
+ * @details The kernel is entered only if some process may be waiting.
+ *
+ * @param mutex Target mutex.
+ *
+ * @returns Zero.
+ */
+int pthread_mutex_unlock(pthread_mutex_t *mutex)
+{
+	if (atomic_xchg(&mutex->lock, MUTEX_UNLOCKED) == MUTEX_CONTENDED)
+		futex((int *)&mutex->lock, FUTEX_WAKE, 1);
+
+	return (0);
+}
@@ -0,0 +1,191 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna   <pedrohenriquepenna@gmail.com>
+ *              2015-2016 Davidson Francis <davidsondfgl@hotmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <nanvix/syscall.h>
+#include <nanvix/vdso.h>
+#include <sys/futex.h>
+#include <sys/mman.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <errno.h>
+
+/**
+ * @brief Size of the memory area of a thread.
+ */
+#define PTHREAD_SIZE (64*1024)
+
+/**
+ * @brief Thread.
+ *
+ * @details The thread descriptor lives at the bottom of the memory area
+ *          that also holds the thread's stack. It is registered as thread
+ *          pointer of the thread, and __errno() expects to find the number
+ *          of last error of the thread in its first field.
+ */
+struct pthread
+{
+	int err;                 /**< Number of last error.         */
+	volatile int tid;        /**< Thread ID (zero once exited). */
+	void *(*start)(void *);  /**< Start routine.                */
+	void *arg;               /**< Argument to start routine.    */
+	void *retval;            /**< Exit value.                   */
+};
+
+/* Forward definitions. */
+extern int __clone(int (*)(void *), void *, void *, int *, void *);
+
+/**
+ * @brief Initial thread.
+ */
+static struct pthread main_thread;
+
+/**
+ * @brief Runs the start routine of a thread.
+ *
+ * @param arg Thread.
+ *
+ * @returns Zero.
+ */
+static int pthread_start(void *arg)
+{
+	struct pthread *self = arg;
+
+	self->retval = self->start(self->arg);
+
+	return (0);
+}
+
+/**
+ * @brief Creates a thread.
+ *
+ * @param thread Store location for the thread.
+ * @param attr   Thread attributes (ignored).
+ * @param start  Start routine.
+ * @param arg    Argument to @p start.
+ *
+ * @returns Upon successful completion, zero is returned. Otherwise, EAGAIN is
+ *          returned if there are not enough resources to create the thread.
+ */
+int pthread_create(pthread_t *thread, const pthread_attr_t *attr,
+	void *(*start)(void *), void *arg)
+{
+	int tid;
+	struct pthread *t;
+
+	((void) attr);
+
+	t = mmap(NULL, PTHREAD_SIZE, PROT_READ | PROT_WRITE,
+		MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+
+	/* Failed to allocate stack. */
+	if (t == MAP_FAILED)
+		return (EAGAIN);
+
+	t->err = 0;
+	t->tid = 0;
+	t->start = start;
+	t->arg = arg;
+	t->retval = NULL;
+
+	tid = __clone(pthread_start, t, (char *)t + PTHREAD_SIZE, (int *)&t->tid, t);
+
+	/* Failed to create thread. */
+	if (tid < 0)
+	{
+		munmap(t, PTHREAD_SIZE);
+		return (EAGAIN);
+	}
+
+	*thread = t;
+
+	return (0);
+}
+
+/**
+ * @brief Terminates the calling thread.
+ *
+ * @param retval Exit value.
+ */
+void pthread_exit(void *retval)
+{
+	pthread_t self;
+
+	self = pthread_self();
+	self->retval = retval;
+
+	__asm__ volatile(
+		"call *__sysentry"
+		: /* empty. */
+		: "a" (NR_thread_exit),
+		"b" (0)
+	);
+}
+
+/**
+ * @brief Waits for a thread to terminate.
+ *
+ * @details The kernel clears the thread ID of the thread when it exits, and
+ *          wakes up anyone waiting on it.
+ *
+ * @param thread Target thread.
+ * @param retval Store location for the exit value of @p thread.
+ *
+ * @returns Upon successful completion, zero is returned. Otherwise, EDEADLK is
+ *          returned if @p thread is the calling thread, and ESRCH if it cannot
+ *          be joined.
+ */
+int pthread_join(pthread_t thread, void **retval)
+{
+	int tid;
+
+	/* Deadlock. */
+	if (thread == pthread_self())
+		return (EDEADLK);
+
+	/* Not joinable. */
+	if (thread == &main_thread)
+		return (ESRCH);
+
+	while ((tid = thread->tid) != 0)
+		futex((int *)&thread->tid, FUTEX_WAIT, tid);
+
+	if (retval != NULL)
+		*retval = thread->retval;
+
+	munmap(thread, PTHREAD_SIZE);
+
+	return (0);
+}
+
+/**
+ * @brief Gets the calling thread.
+ *
+ * @details The descriptor of the calling thread is its thread pointer, which
+ *          the kernel publishes in the vDSO data page.
+ *
+ * @returns The calling thread.
+ */
+pthread_t pthread_self(void)
+{
+	struct pthread *t;
+
+	t = (struct pthread *)VDSO->tp;
+
+	return ((t != NULL) ? t : &main_thread);
+}
@@ -33,7 +33,7 @@ sighandler_t signal(int sig, sighandler_t func)
 	sighandler_t ret;
 
 	__asm__ volatile (
-		"int $0x80"
+		"call *__sysentry"
 		: "=a" (ret)
 		: "0" (NR_signal),
 		  "b" (sig),
@@ -0,0 +1,53 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include "stdio.h"
+
+/**
+ * @brief Associates a file stream with a file descriptor.
+ *
+ * @param fd   Target file descriptor.
+ * @param mode Access mode, as in fopen().
+ *
+ * @returns A pointer to the object controlling the stream. Otherwise, a null
+ *          pointer is returned, and errno is set to indicate the error.
+ */
+FILE *fdopen(int fd, const char *mode)
+{
+	FILE *stream; /* File stream.      */
+	int flags;    /* Stream flags.     */
+	int oflags;   /* Flags for open(). */
+
+	/* No file stream left. */
+	if ((stream = _getstream()) == NULL)
+		return (NULL);
+
+	/* Bad opening mode. */
+	if ((flags = _sflags(mode, &oflags)) == 0)
+		return (NULL);
+
+	stream->fd = fd;
+	stream->flags = flags;
+	stream->buf = NULL;
+	stream->count = 0;
+
+	return (stream);
+}
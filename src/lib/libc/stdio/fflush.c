@@ -27,9 +27,6 @@
  */
 static int do_fflush(FILE *stream)
 {
-	char *buf; /* Buffer.              */
-	ssize_t n; /* Byte count to flush. */
-
 	/* Not buffered. */
 	if (stream->flags & _IONBF)
 		return (0);
@@ -39,23 +36,16 @@ static int do_fflush(FILE *stream)
 		return (0);
 
 	/* No buffer assigned. */
-	if ((buf = stream->buf) == NULL)
+	if (stream->buf == NULL)
 		return (0);
 
 	/* Nothing to flushed. */
-	if ((n = stream->ptr - buf) == 0)
+	if (stream->ptr == stream->buf)
 		return (0);
 
-	/* Reset buffer. */
-	stream->ptr = buf;
-	stream->count = (stream->flags & _IOLBF) ? 0 : stream->bufsiz - 1;
-
 	/* Flush. */
-	if (write(fileno(stream), buf, n) != n)
-	{
-		stream->flags |= _IOERROR;
+	if (_sflush(stream, NULL, 0) < 0)
 		return (EOF);
-	}
 
 	return (0);
 }
@@ -25,12 +25,15 @@
  */
 int fputs(const char *str, FILE *stream)
 {
-	int c;       /* Working character. */
-	int ret = 0; /* Return value.      */
+	size_t len; /* String length. */
+
+	/* Nothing to be done. */
+	if ((len = strlen(str)) == 0)
+		return (0);
 
 	/* Write string. */
-	while ((c = *str++) != '\0')
-		ret = putc(c, stream);
+	if (fwrite(str, 1, len, stream) != len)
+		return (EOF);
 
-	return (ret);
+	return (0);
 }
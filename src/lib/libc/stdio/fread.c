@@ -0,0 +1,125 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "stdio.h"
+
+/**
+ * @brief Reads from a file stream.
+ *
+ * @details Buffered data is consumed first. Transfers that are at least as
+ *          large as the stream buffer are then read straight into @p ptr,
+ *          and smaller ones refill the stream buffer.
+ *
+ * @param ptr    Array where elements shall be stored.
+ * @param size   Size of each element.
+ * @param nitems Number of elements.
+ * @param stream Target file stream.
+ *
+ * @returns The number of elements successfully read, which is less than
+ *          @p nitems only if a read error or end-of-file is encountered.
+ */
+size_t fread(void *ptr, size_t size, size_t nitems, FILE *stream)
+{
+	size_t n;      /* Bytes to read.      */
+	size_t len;    /* Bytes to copy.      */
+	size_t bufsiz; /* Buffer size.        */
+	ssize_t nread; /* Bytes read.         */
+	char *p;       /* Write pointer.      */
+	char *buf;     /* Stream buffer.      */
+
+	/* Nothing to be done. */
+	if ((size == 0) || (nitems == 0))
+		return (0);
+
+	/* Too many bytes. */
+	if (nitems > ((size_t)-1)/size)
+	{
+		errno = EINVAL;
+		return (0);
+	}
+
+	/* Now reading. */
+	if (stream->flags & _IORW)
+	{
+		stream->flags &= ~_IOWRITE;
+		stream->flags |= _IOREAD;
+	}
+
+	/* File is not readable. */
+	if (!(stream->flags & _IOREAD))
+	{
+		errno = EBADF;
+		return (0);
+	}
+
+	n = size*nitems;
+	p = ptr;
+
+	/* Consume buffered data. */
+	if (stream->count > 0)
+	{
+		len = ((size_t)stream->count < n) ? (size_t)stream->count : n;
+		memcpy(p, stream->ptr, len);
+		stream->ptr += len;
+		stream->count -= len;
+		p += len;
+		n -= len;
+	}
+
+	while ((n > 0) && !(stream->flags & _IOEOF))
+	{
+		bufsiz = (stream->buf != NULL) ? stream->bufsiz : BUFSIZ;
+
+		/* Large transfer, or not buffered. */
+		if ((stream->flags & _IONBF) || (n >= bufsiz))
+		{
+			if ((nread = read(fileno(stream), p, n)) > 0)
+			{
+				p += nread;
+				n -= nread;
+				continue;
+			}
+		}
+
+		/* Failed to assign buffer. */
+		else if ((buf = _getbuf(stream)) == NULL)
+			continue;
+
+		/* Refill buffer. */
+		else if ((nread = read(fileno(stream), buf, stream->bufsiz)) > 0)
+		{
+			len = ((size_t)nread < n) ? (size_t)nread : n;
+			memcpy(p, buf, len);
+			stream->ptr = buf + len;
+			stream->count = nread - len;
+			p += len;
+			n -= len;
+			continue;
+		}
+
+		stream->flags |= (nread == 0) ? _IOEOF : _IOERROR;
+		break;
+	}
+
+	return ((p - (char *)ptr)/size);
+}
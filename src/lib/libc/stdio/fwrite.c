@@ -0,0 +1,150 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "stdio.h"
+
+/**
+ * @brief Writes to a file stream.
+ *
+ * @details Data is copied into the stream buffer in bulk. Transfers that are
+ *          at least as large as the stream buffer are written straight to the
+ *          underlying file, along with pending data, in a single writev().
+ *
+ * @param ptr    Array to write.
+ * @param size   Size of each element.
+ * @param nitems Number of elements.
+ * @param stream Target file stream.
+ *
+ * @returns The number of elements successfully written, which is less than
+ *          @p nitems only if a write error is encountered.
+ */
+size_t fwrite(const void *ptr, size_t size, size_t nitems, FILE *stream)
+{
+	size_t n;          /* Bytes to write.        */
+	size_t space;      /* Free space in buffer.  */
+	size_t bufsiz;     /* Buffer size.           */
+	size_t nwritten;   /* Bytes written.         */
+	ssize_t ret;       /* Bytes flushed.         */
+	const char *p;     /* Read pointer.          */
+	char *buf;         /* Stream buffer.         */
+
+	/* Nothing to be done. */
+	if ((size == 0) || (nitems == 0))
+		return (0);
+
+	/* Too many bytes. */
+	if (nitems > ((size_t)-1)/size)
+	{
+		errno = EINVAL;
+		return (0);
+	}
+
+	/* Now writing. */
+	if (stream->flags & _IORW)
+	{
+		stream->flags &= ~_IOREAD;
+		stream->flags |= _IOWRITE;
+	}
+
+	/* File is not writable. */
+	if (!(stream->flags & _IOWRITE))
+	{
+		errno = EBADF;
+		return (0);
+	}
+
+	/* Synchronize file position. */
+	if ((stream->flags & (_IOSYNC | _IOAPPEND)) == (_IOSYNC | _IOAPPEND))
+	{
+		/* Failed. */
+		if (lseek(fileno(stream), 0, SEEK_END) < 0)
+		{
+			stream->flags |= _IOERROR;
+			return (0);
+		}
+	}
+
+	n = size*nitems;
+	p = ptr;
+	nwritten = 0;
+
+	bufsiz = (stream->buf != NULL) ? stream->bufsiz : BUFSIZ;
+
+	/* Large transfer, or not buffered. */
+	if ((stream->flags & _IONBF) || (n >= bufsiz))
+	{
+		/* Write pending data and the transfer together. */
+		if ((ret = _sflush(stream, p, n)) < 0)
+			return (0);
+
+		return ((size_t)ret/size);
+	}
+
+	/* Top up pending data and flush it. */
+	if ((buf = stream->buf) != NULL)
+	{
+		space = (buf + bufsiz) - stream->ptr;
+
+		if ((stream->ptr != buf) && (n >= space))
+		{
+			memcpy(stream->ptr, p, space);
+			stream->ptr += space;
+
+			if (fflush(stream) == EOF)
+				return (0);
+
+			nwritten = space;
+		}
+	}
+
+	/* Copy to buffer. */
+	if ((buf = _getbuf(stream)) != NULL)
+	{
+		memcpy(stream->ptr, p + nwritten, n - nwritten);
+		stream->ptr += n - nwritten;
+		nwritten = n;
+
+		/* Line buffered. */
+		if (stream->flags & _IOLBF)
+		{
+			stream->count = 0;
+
+			/* Flush buffer. */
+			if (memchr(p, '\n', n) != NULL)
+			{
+				if (fflush(stream) == EOF)
+					return (0);
+			}
+		}
+
+		/* Fully buffered. */
+		else
+			stream->count = (buf + stream->bufsiz) - stream->ptr;
+	}
+
+	/* Failed to assign buffer. */
+	else if ((ret = _sflush(stream, p + nwritten, n - nwritten)) > 0)
+		nwritten += ret;
+
+	return (nwritten/size);
+}
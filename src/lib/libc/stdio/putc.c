@@ -122,7 +122,7 @@ again:
 			*stream->ptr++ = c;
 
 			/* Reset buffer. */
-			stream->count = stream->bufsiz - 1;
+			stream->count = (buf + stream->bufsiz) - stream->ptr;
 		}
 	}
 
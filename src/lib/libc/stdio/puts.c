@@ -25,11 +25,9 @@
  */
 int puts(const char *str)
 {
-	int c;
-
 	/* Write string. */
-	while ((c = *str++) != '\0')
-		putchar(c);
+	if (fputs(str, stdout) == EOF)
+		return (EOF);
 
 	return (putchar('\n'));
 }
@@ -60,7 +60,7 @@ int setvbuf(FILE *stream, char *buf, int type, size_t size)
 			stream->flags |= _IOMYBUF;
 		}
 
-		stream->flags &= ~(_IOFBF | _IONBF | _IOFBF);
+		stream->flags &= ~(_IOFBF | _IONBF | _IOLBF);
 		stream->flags |= (type == _IOLBF) ? _IOLBF : _IOFBF;
 		stream->buf = buf;
 		stream->ptr = buf;
@@ -17,8 +17,10 @@
  * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <sys/uio.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <unistd.h>
 
 /* File streams table. */
 FILE streams[FOPEN_MAX] = {
@@ -66,3 +68,112 @@ FILE *_getstream(void)
 	return (NULL);
 }
 
+
+/**
+ * @brief Assigns a library buffer to a file stream.
+ *
+ * @details If the stream already has a buffer, nothing is done. If a buffer
+ *          cannot be allocated, the stream is made unbuffered.
+ *
+ * @param stream Target file stream.
+ *
+ * @returns The stream buffer, or NULL if the stream is unbuffered.
+ */
+char *_getbuf(FILE *stream)
+{
+	char *buf;
+
+	/* Not buffered. */
+	if (stream->flags & _IONBF)
+		return (NULL);
+
+	/* Buffer already assigned. */
+	if ((buf = stream->buf) != NULL)
+		return (buf);
+
+	/* Failed to allocate buffer. */
+	if ((buf = malloc(BUFSIZ)) == NULL)
+	{
+		stream->flags &= ~(_IOLBF | _IOFBF);
+		stream->flags |= _IONBF;
+		return (NULL);
+	}
+
+	stream->flags |= _IOMYBUF;
+	stream->buf = buf;
+	stream->ptr = buf;
+	stream->bufsiz = BUFSIZ;
+	stream->count = 0;
+
+	return (buf);
+}
+
+/**
+ * @brief Flushes a stream buffer, followed by a memory area.
+ *
+ * @details Pending data in the stream buffer and the memory area are handed
+ *          to the kernel together, with a single writev() in the common case.
+ *          Short writes are retried until all data is written or an error
+ *          occurs, in which case the error indicator of the stream is set.
+ *
+ * @param stream Target file stream.
+ * @param buf    Data to write after pending data (may be NULL).
+ * @param n      Number of bytes to write from @p buf.
+ *
+ * @returns The number of bytes written from @p buf, or -1 if pending data
+ *          could not be written.
+ */
+ssize_t _sflush(FILE *stream, const char *buf, size_t n)
+{
+	ssize_t nwritten;    /* Bytes written in one go. */
+	size_t pending;      /* Pending bytes.           */
+	struct iovec iov[2]; /* Data to write.           */
+	struct iovec *v;     /* Working buffer.          */
+	int cnt;             /* Number of buffers.       */
+
+	pending = (stream->buf != NULL) ? (size_t)(stream->ptr - stream->buf) : 0;
+
+	iov[0].iov_base = stream->buf;
+	iov[0].iov_len = pending;
+	iov[1].iov_base = (void *)buf;
+	iov[1].iov_len = n;
+
+	/* Reset buffer. */
+	if (stream->buf != NULL)
+	{
+		stream->ptr = stream->buf;
+		stream->count = (stream->flags & _IOLBF) ? 0 : stream->bufsiz;
+	}
+
+	/* Skip empty buffers. */
+	for (v = iov, cnt = 2; (cnt > 0) && (v->iov_len == 0); v++, cnt--)
+		/* noop */ ;
+
+	while (cnt > 0)
+	{
+		/* Failed to write. */
+		if ((nwritten = writev(fileno(stream), v, cnt)) <= 0)
+		{
+			stream->flags |= _IOERROR;
+			break;
+		}
+
+		/* Skip data that was written. */
+		while ((cnt > 0) && ((size_t)nwritten >= v->iov_len))
+		{
+			nwritten -= v->iov_len;
+			v++; cnt--;
+		}
+		if (cnt > 0)
+		{
+			v->iov_base = (char *)v->iov_base + nwritten;
+			v->iov_len -= nwritten;
+		}
+	}
+
+	/* Pending data was not written. */
+	if ((cnt > 0) && (v == &iov[0]))
+		return (-1);
+
+	return ((cnt > 0) ? (ssize_t)(n - iov[1].iov_len) : (ssize_t)n);
+}
@@ -25,6 +25,8 @@
 	/* Forward definitions. */
 	extern FILE *_getstream(void);
 	extern int _sflags(const char *, int *);
+	extern char *_getbuf(FILE *);
+	extern ssize_t _sflush(FILE *, const char *, size_t);
 
 	/* File streams table. */
 	extern FILE streams[FOPEN_MAX];
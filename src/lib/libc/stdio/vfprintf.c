@@ -32,8 +32,11 @@ int vfprintf(FILE *stream, const char *format, va_list ap)
 	n = vsprintf(buffer, format, ap);
 
 	/* Write formated string to file. */
-	if (n > 0)
-		fputs(buffer, stream);
+	if (--n > 0)
+	{
+		if (fwrite(buffer, 1, n, stream) != (size_t)n)
+			return (EOF);
+	}
 
 	return (n);
 }
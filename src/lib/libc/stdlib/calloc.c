@@ -23,6 +23,7 @@
  * @brief calloc() implementation.
  */
 
+#include <errno.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -43,6 +44,13 @@ void *calloc(size_t n, size_t size)
 {
   register char *cp;
 
+  /* Overflow. */
+  if ((size != 0) && (n > ((size_t)-1)/size))
+  {
+    errno = ENOMEM;
+    return (NULL);
+  }
+
   n *= size;
 
   cp = malloc(n);
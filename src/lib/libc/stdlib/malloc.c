@@ -20,112 +20,464 @@
 /**
  * @file
  *
- * @brief malloc() and free() implementation.
+ * @brief malloc(), free() and realloc() implementation.
+ *
+ * @details Segregated-fit allocator. Free chunks are kept in bins: exact
+ *          size classes for small chunks, and power of two size classes for
+ *          large ones. Chunks carry boundary tags, so a freed chunk is
+ *          coalesced with its free neighbours in constant time. The chunk at
+ *          the end of the heap (the top chunk) is carved up when no bin can
+ *          serve a request, and it is extended with sbrk() in geometric
+ *          steps.
  */
 
+#include <nanvix/mm.h>
 #include <sys/types.h>
 #include <errno.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
 /**
- * @brief expand() in at least NALLOC blocks.
+ * @brief Memory chunk.
+ *
+ * @details The size of a chunk is a multiple of ALIGNMENT, so its two low
+ *          bits are used as flags. The link fields are only valid in free
+ *          chunks, which also store their size in the prev_size field of the
+ *          next chunk (the footer). In chunks that are in use, that field is
+ *          part of the payload.
+ */
+struct chunk
+{
+	size_t prev_size;   /**< Size of previous chunk, if free. */
+	size_t size;        /**< Size and flags.                  */
+	struct chunk *next; /**< Next chunk in bin.               */
+	struct chunk *prev; /**< Previous chunk in bin.           */
+};
+
+/**
+ * @name Chunk flags
+ */
+/**@{*/
+#define CINUSE    0x1               /**< Chunk in use?          */
+#define PINUSE    0x2               /**< Previous chunk in use? */
+#define SIZE_BITS (CINUSE | PINUSE) /**< Flags mask.            */
+/**@}*/
+
+/**
+ * @name Chunk geometry
+ */
+/**@{*/
+#define ALIGNMENT  8                      /**< Payload alignment.         */
+#define OVERHEAD   sizeof(size_t)         /**< Overhead of a used chunk.  */
+#define MINCHUNK   sizeof(struct chunk)   /**< Minimum chunk size.        */
+#define FENCE_SIZE (2*sizeof(size_t))     /**< Size of a segment fence.   */
+#define MAX_REQUEST (((size_t)-1) >> 2)   /**< Largest request.           */
+/**@}*/
+
+/**
+ * @name Chunk helpers
  */
-#define NALLOC 511
+/**@{*/
+#define CHUNKSIZE(c) ((c)->size & ~SIZE_BITS)
+#define NEXT(c) ((struct chunk *)((char *)(c) + CHUNKSIZE(c)))
+#define PREV(c) ((struct chunk *)((char *)(c) - (c)->prev_size))
+#define MEM(c) ((void *)((char *)(c) + 2*sizeof(size_t)))
+#define CHUNK(p) ((struct chunk *)((char *)(p) - 2*sizeof(size_t)))
+#define ALIGN(x, a) (((x) + ((a) - 1)) & ~((a) - 1))
+/**@}*/
 
 /**
- * @brief Size of block structure.
+ * @name Bins
  */
-#define SIZEOF_BLOCK (sizeof(struct block))
+/**@{*/
+#define NSMALLBINS 32                       /**< Number of small bins.   */
+#define NBINS      (NSMALLBINS + 24)        /**< Number of bins.         */
+#define SMALL_MAX  (NSMALLBINS*ALIGNMENT)   /**< Largest small chunk.    */
+/**@}*/
 
 /**
- * @brief Memory block.
+ * @name Heap growth
  */
-struct block
+/**@{*/
+#define BRK_STEP_MIN (16*1024)  /**< First sbrk() increment.   */
+#define BRK_STEP_MAX (512*1024) /**< Largest sbrk() increment. */
+/**@}*/
+
+/**
+ * @brief Free chunks, by size class.
+ */
+static struct chunk *bins[NBINS];
+
+/**
+ * @brief Non-empty bins.
+ */
+static unsigned binmap[(NBINS + 31)/32];
+
+/**
+ * @brief Top chunk.
+ */
+static struct chunk *top = NULL;
+
+/**
+ * @brief End of the heap.
+ */
+static char *heap_end = NULL;
+
+/**
+ * @brief Next sbrk() increment.
+ */
+static size_t brk_step = BRK_STEP_MIN;
+
+/**
+ * @brief Allocator lock.
+ */
+static pthread_mutex_t malloc_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief Computes the bin of a chunk size.
+ *
+ * @param size Chunk size.
+ *
+ * @returns The bin index of @p size.
+ */
+static unsigned bin_index(size_t size)
 {
-	struct block *nextp; /* Next free block.  */
-	unsigned nblocks;    /* Size (in blocks). */
-};
+	unsigned i;
+
+	/* Small chunk. */
+	if (size < SMALL_MAX)
+		return (size/ALIGNMENT);
+
+	/* Large chunk. */
+	for (i = NSMALLBINS; (size >>= 1) >= SMALL_MAX; i++)
+		/* noop */ ;
+
+	return (i);
+}
 
 /**
- * @brief Free list of blocks.
+ * @brief Inserts a free chunk in its bin.
+ *
+ * @param c Target chunk.
  */
-static struct block head;
-static struct block *freep = NULL;
+static void bin_insert(struct chunk *c)
+{
+	unsigned i;
+
+	i = bin_index(CHUNKSIZE(c));
+
+	c->prev = NULL;
+	if ((c->next = bins[i]) != NULL)
+		c->next->prev = c;
+	bins[i] = c;
+	binmap[i >> 5] |= 1u << (i & 31);
+}
 
 /**
- * @brief Frees allocated memory.
+ * @brief Removes a free chunk from its bin.
  *
- * @param ptr Memory area to free.
+ * @param c Target chunk.
  */
-void free(void *ptr)
+static void bin_remove(struct chunk *c)
 {
-	struct block *p;  /* Working block.     */
-	struct block *bp; /* Block being freed. */
+	unsigned i;
 
-	/* Nothing to be done. */
-	if (ptr == NULL)
-		return;
+	i = bin_index(CHUNKSIZE(c));
 
-	bp = (struct block *)ptr - 1;
+	if (c->prev != NULL)
+		c->prev->next = c->next;
+	else if ((bins[i] = c->next) == NULL)
+		binmap[i >> 5] &= ~(1u << (i & 31));
+	if (c->next != NULL)
+		c->next->prev = c->prev;
+}
 
-	/* Look for insertion point. */
-	for (p = freep; p > bp || p->nextp < bp; p = p->nextp)
+/**
+ * @brief Finds the first non-empty bin.
+ *
+ * @param i First bin to look at.
+ *
+ * @returns The index of the first non-empty bin starting at @p i, or NBINS
+ *          if there is none.
+ */
+static unsigned bin_next(unsigned i)
+{
+	unsigned map;
+
+	while (i < NBINS)
 	{
-		/* Freed block at start or end. */
-		if (p >= p->nextp && (bp > p || bp < p->nextp))
-			break;
+		map = binmap[i >> 5] & (~0u << (i & 31));
+
+		/* Found. */
+		if (map != 0)
+			return ((i & ~31u) + __builtin_ctz(map));
+
+		i = (i + 32) & ~31u;
 	}
 
-	/* Merge with upper block. */
-	if (bp + bp->nblocks == p->nextp)
+	return (NBINS);
+}
+
+/**
+ * @brief Marks a chunk as free.
+ *
+ * @param c    Target chunk.
+ * @param size Chunk size.
+ */
+static void set_free(struct chunk *c, size_t size)
+{
+	c->size = size | (c->size & PINUSE);
+	NEXT(c)->prev_size = size;
+	NEXT(c)->size &= ~PINUSE;
+}
+
+/**
+ * @brief Marks a chunk as used.
+ *
+ * @param c    Target chunk.
+ * @param size Chunk size.
+ */
+static void set_inuse(struct chunk *c, size_t size)
+{
+	c->size = size | CINUSE | (c->size & PINUSE);
+	NEXT(c)->size |= PINUSE;
+}
+
+/**
+ * @brief Splits a chunk that is about to be used.
+ *
+ * @details The tail of @p c that is not needed goes back into a bin, if it
+ *          is large enough to make up a chunk.
+ *
+ * @param c    Target chunk.
+ * @param size Size of @p c.
+ * @param nb   Needed size.
+ */
+static void split(struct chunk *c, size_t size, size_t nb)
+{
+	struct chunk *r;
+
+	/* Too small to split. */
+	if (size - nb < MINCHUNK)
 	{
-		bp->nblocks += p->nextp->nblocks + 1;
-		bp->nextp = p->nextp->nextp;
+		set_inuse(c, size);
+		return;
 	}
-	else
-		bp->nextp = p->nextp;
 
-	/* Merge with lower block. */
-	if (p + p->nblocks == bp)
+	c->size = nb | CINUSE | (c->size & PINUSE);
+	r = NEXT(c);
+	r->size = PINUSE;
+	set_free(r, size - nb);
+	bin_insert(r);
+}
+
+/**
+ * @brief Expands the heap.
+ *
+ * @details The heap grows in steps that double up to BRK_STEP_MAX, so that
+ *          programs that allocate a lot call sbrk() a logarithmic number of
+ *          times. The end of every heap segment holds a fence that looks like
+ *          a used chunk, so that chunks are never coalesced past it.
+ *
+ * @param nb Number of bytes that the top chunk should be able to serve.
+ *
+ * @returns Upon successful completion, zero is returned. Upon failure, -1 is
+ *          returned instead and errno is set to indicate the error.
+ */
+static int grow(size_t nb)
+{
+	size_t incr;     /* Heap increment. */
+	char *p;         /* New memory.     */
+	struct chunk *f; /* Segment fence.  */
+	struct chunk *t; /* Old top chunk.  */
+
+	incr = nb + MINCHUNK + FENCE_SIZE + ALIGNMENT;
+	if (incr < brk_step)
+		incr = brk_step;
+	incr = ALIGN(incr, PAGE_SIZE);
+
+	if (brk_step < BRK_STEP_MAX)
+		brk_step <<= 1;
+
+	/* Out of memory. */
+	if ((p = sbrk(incr)) == (void *)-1)
 	{
-		p->nblocks += bp->nblocks + 1;
-		p->nextp = bp->nextp;
+		errno = ENOMEM;
+		return (-1);
 	}
+
+	/* Extend top chunk over the old fence. */
+	if ((top != NULL) && (p == heap_end))
+		top->size += incr;
+
+	/* Start a new segment. */
 	else
-		p->nextp = bp;
+	{
+		/* Retire old top chunk. */
+		if ((t = top) != NULL)
+		{
+			set_free(t, CHUNKSIZE(t));
+			bin_insert(t);
+		}
 
-	freep = p;
+		top = (struct chunk *)ALIGN((size_t)p, ALIGNMENT);
+		top->size = PINUSE;
+		top->size |= (ALIGN((size_t)p + incr - (ALIGNMENT - 1), ALIGNMENT) -
+			FENCE_SIZE) - (size_t)top;
+	}
+
+	heap_end = p + incr;
+
+	f = NEXT(top);
+	f->size = CINUSE;
+
+	return (0);
 }
 
 /**
- * @brief Expands the heap.
+ * @brief Frees a chunk.
  *
- * @details Expands the heap by @p nblocks.
+ * @param c Target chunk.
+ */
+static void chunk_free(struct chunk *c)
+{
+	size_t size;     /* Chunk size.    */
+	struct chunk *n; /* Next chunk.    */
+	struct chunk *p; /* Previous chunk. */
+
+	size = CHUNKSIZE(c);
+
+	/* Coalesce with previous chunk. */
+	if (!(c->size & PINUSE))
+	{
+		p = PREV(c);
+		bin_remove(p);
+		size += CHUNKSIZE(p);
+		c = p;
+	}
+
+	n = (struct chunk *)((char *)c + size);
+
+	/* Coalesce with top chunk. */
+	if (n == top)
+	{
+		c->size = (size + CHUNKSIZE(top)) | (c->size & PINUSE);
+		top = c;
+		return;
+	}
+
+	/* Coalesce with next chunk. */
+	if (!(n->size & CINUSE))
+	{
+		bin_remove(n);
+		size += CHUNKSIZE(n);
+	}
+
+	c->size = (c->size & PINUSE);
+	set_free(c, size);
+	bin_insert(c);
+}
+
+/**
+ * @brief Converts a request size into a chunk size.
  *
- * @param nblocks Number of blocks to expand.
+ * @param size Request size.
  *
- * @returns Upon successful completion a pointed to the expansion is returned.
- *          Upon failure, a null pointed is returned instead and errno is set
- *          to indicate the error.
+ * @returns The chunk size that serves @p size bytes.
  */
-static void *expand(unsigned nblocks)
+static size_t request2size(size_t size)
 {
-	struct block *p;
+	size = ALIGN(size + OVERHEAD, ALIGNMENT);
 
-	/* Expand in at least NALLOC blocks. */
-	if (nblocks < NALLOC)
-		nblocks = NALLOC;
+	return ((size < MINCHUNK) ? MINCHUNK : size);
+}
 
-	/* Request more memory to the kernel. */
-	if ((p = sbrk((nblocks + 1)*SIZEOF_BLOCK)) == (void *)-1)
-		return (NULL);
+/**
+ * @brief Allocates a chunk.
+ *
+ * @param nb Chunk size.
+ *
+ * @returns Upon successful completion, the allocated chunk is returned. Upon
+ *          failure, a null pointer is returned instead and errno is set to
+ *          indicate the error.
+ */
+static struct chunk *chunk_alloc(size_t nb)
+{
+	unsigned i;          /* Bin index.     */
+	size_t size;         /* Chunk size.    */
+	struct chunk *c;     /* Working chunk. */
+	struct chunk *best;  /* Best fit.      */
+
+	i = bin_index(nb);
+
+	/* Exact fit. */
+	if ((i < NSMALLBINS) && ((c = bins[i]) != NULL))
+	{
+		bin_remove(c);
+		set_inuse(c, nb);
+		return (c);
+	}
+
+	/* Best fit in a large bin. */
+	if (i >= NSMALLBINS)
+	{
+		best = NULL;
+		for (c = bins[i]; c != NULL; c = c->next)
+		{
+			if ((CHUNKSIZE(c) >= nb) &&
+				((best == NULL) || (CHUNKSIZE(c) < CHUNKSIZE(best))))
+				best = c;
+		}
+
+		if ((c = best) != NULL)
+			goto found;
+	}
+
+	/* Any chunk in a larger bin fits. */
+	if ((i = bin_next(i + 1)) < NBINS)
+	{
+		c = bins[i];
+		goto found;
+	}
+
+	/* Carve up top chunk. */
+	if ((top == NULL) || (CHUNKSIZE(top) < nb + MINCHUNK))
+	{
+		if (grow(nb))
+			return (NULL);
+	}
+
+	c = top;
+	size = CHUNKSIZE(c);
+	top = (struct chunk *)((char *)c + nb);
+	top->size = (size - nb) | PINUSE;
+	c->size = nb | CINUSE | (c->size & PINUSE);
+
+	return (c);
+
+found:
+	bin_remove(c);
+	split(c, CHUNKSIZE(c), nb);
+
+	return (c);
+}
 
-	p->nblocks = nblocks;
-	free(p + 1);
+/**
+ * @brief Frees allocated memory.
+ *
+ * @param ptr Memory area to free.
+ */
+void free(void *ptr)
+{
+	/* Nothing to be done. */
+	if (ptr == NULL)
+		return;
 
-	return (freep);
+	pthread_mutex_lock(&malloc_lock);
+	chunk_free(CHUNK(ptr));
+	pthread_mutex_unlock(&malloc_lock);
 }
 
 /**
@@ -141,72 +493,108 @@ static void *expand(unsigned nblocks)
  */
 void *malloc(size_t size)
 {
-	struct block *p;     /* Working block.            */
-	struct block *prevp; /* Previous working block.   */
-	unsigned nblocks;    /* Request size (in blocks). */
+	struct chunk *c;
 
 	/* Nothing to be done. */
 	if (size == 0)
 		return (NULL);
 
-	nblocks = (size + (SIZEOF_BLOCK - 1))/SIZEOF_BLOCK + 1;
-
-	/* Create free list. */
-	if ((prevp = freep) == NULL)
+	/* Request too large. */
+	if (size > MAX_REQUEST)
 	{
-		head.nextp = freep = prevp = &head;
-		head.nblocks = 0;
+		errno = ENOMEM;
+		return (NULL);
 	}
 
-	/* Look for a free block that is big enough. */
-	for (p = prevp->nextp; /* void */ ; prevp = p, p = p->nextp)
-	{
-		/* Found. */
-		if (p->nblocks >= nblocks)
-		{
-			/* Exact. */
-			if (p->nblocks == nblocks)
-				prevp->nextp = p->nextp;
+	pthread_mutex_lock(&malloc_lock);
+	c = chunk_alloc(request2size(size));
+	pthread_mutex_unlock(&malloc_lock);
 
-			/* Split block. */
-			else
-			{
-				p->nblocks -= nblocks;
-				p += p->nblocks;
-				p->nblocks = nblocks;
-			}
+	return ((c != NULL) ? MEM(c) : NULL);
+}
+
+/**
+ * @brief Resizes a chunk in place.
+ *
+ * @param c  Target chunk.
+ * @param nb New chunk size.
+ *
+ * @returns Non-zero if @p c was resized, and zero otherwise.
+ */
+static int chunk_resize(struct chunk *c, size_t nb)
+{
+	size_t size;     /* Chunk size. */
+	size_t tsize;    /* Top size.   */
+	struct chunk *n; /* Next chunk. */
 
-			freep = prevp;
+	size = CHUNKSIZE(c);
 
-			return (p + 1);
+	/* Shrink. */
+	if (size >= nb)
+	{
+		if (size - nb >= MINCHUNK)
+		{
+			c->size = nb | CINUSE | (c->size & PINUSE);
+			n = NEXT(c);
+			n->size = (size - nb) | CINUSE | PINUSE;
+			chunk_free(n);
 		}
+		return (1);
+	}
+
+	n = NEXT(c);
 
-		/* Wrapped around free list. */
-		if (p == freep)
+	/* Grow into top chunk. */
+	if (n == top)
+	{
+		if (size + CHUNKSIZE(top) < nb + MINCHUNK)
 		{
-			/* Expand heap. */
-			if ((p = expand(nblocks)) == NULL)
-				break;
+			if ((grow(nb - size)) || (NEXT(c) != top))
+				return (0);
 		}
+
+		tsize = CHUNKSIZE(top);
+		top = (struct chunk *)((char *)c + nb);
+		top->size = (size + tsize - nb) | PINUSE;
+		c->size = nb | CINUSE | (c->size & PINUSE);
+
+		return (1);
 	}
 
-	return (NULL);
+	/* Grow into next chunk. */
+	if ((!(n->size & CINUSE)) && (size + CHUNKSIZE(n) >= nb))
+	{
+		bin_remove(n);
+		c->size = (size + CHUNKSIZE(n)) | CINUSE | (c->size & PINUSE);
+		NEXT(c)->size |= PINUSE;
+
+		/* Give back what is not needed. */
+		chunk_resize(c, nb);
+
+		return (1);
+	}
+
+	return (0);
 }
 
 /**
  * @brief Reallocates a memory chunk.
  *
+ * @details The chunk is resized in place whenever possible, growing it into
+ *          a free neighbour or into the top chunk. Otherwise, a new chunk is
+ *          allocated and the old contents are copied over.
+ *
  * @param ptr  Pointer to old object.
  * @param size Size of new object.
  *
  * @returns Upon successful completion, realloc() returns a pointer to the
  *           allocated space. Upon failure, a null pointer is returned instead.
- *
- * @todo Check if we can simply expand.
  */
 void *realloc(void *ptr, size_t size)
 {
-	void *newptr;
+	size_t nb;       /* New chunk size. */
+	size_t old;      /* Old data size.  */
+	struct chunk *c; /* New chunk.      */
 
 	/* Nothing to be done. */
 	if (size == 0)
@@ -215,11 +603,36 @@ void *realloc(void *ptr, size_t size)
 		return (NULL);
 	}
 
-	newptr = malloc(size);
-	if (ptr != NULL)
-		memcpy(newptr, ptr, size);
+	if (ptr == NULL)
+		return (malloc(size));
+
+	/* Request too large. */
+	if (size > MAX_REQUEST)
+	{
+		errno = ENOMEM;
+		return (NULL);
+	}
+
+	nb = request2size(size);
+
+	pthread_mutex_lock(&malloc_lock);
+
+	/* Resize in place. */
+	if (chunk_resize(CHUNK(ptr), nb))
+	{
+		pthread_mutex_unlock(&malloc_lock);
+		return (ptr);
+	}
+
+	/* Move. */
+	if ((c = chunk_alloc(nb)) != NULL)
+	{
+		old = CHUNKSIZE(CHUNK(ptr)) - OVERHEAD;
+		memcpy(MEM(c), ptr, (old < size) ? old : size);
+		chunk_free(CHUNK(ptr));
+	}
 
-	free(ptr);
+	pthread_mutex_unlock(&malloc_lock);
 
-	return (newptr);
+	return ((c != NULL) ? MEM(c) : NULL);
 }
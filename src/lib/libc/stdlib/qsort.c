@@ -58,110 +58,258 @@
 
 #include <stddef.h>
 #include <stdlib.h>
-#include <string.h>
 
 /**
- * @brief Compare function.
+ * @brief Partitions that are at most this long are insertion sorted.
  */
-static int (*_cmp)(const void *, const void *) = NULL;
+#define INSERTION_SORT_MAX 12
 
 /**
- * @brief Finds sorting pivot.
+ * @brief Word that may alias any element.
  */
-static int find_pivot(void *base, int i, int j, size_t size)
+typedef long word_t __attribute__((__may_alias__));
+
+/**
+ * @brief Sort parameters.
+ */
+struct sort
 {
-	void *first_key;
-	void *next_key;
+	size_t size;                                   /**< Element size.   */
+	int (*cmp)(const void *, const void *, void *); /**< Comparator.     */
+	void *arg;                                     /**< Comparator arg. */
+	int words;                                     /**< Swap words?     */
+};
 
-	first_key = (void *) (((char *) base) + (i*size));
-	next_key = first_key;
+/**
+ * @brief Compares two elements.
+ */
+#define CMP(s, a, b) \
+	((s)->cmp((a), (b), (s)->arg))
 
-	for (int k = i + 1; k <= j; k++)
-    {
-		int res;
+/**
+ * @brief Swaps two elements.
+ *
+ * @details Elements are swapped a word at a time when the array and the
+ *          element size are word aligned, and a byte at a time otherwise.
+ */
+static void swap(const struct sort *s, char *a, char *b)
+{
+	size_t n;
 
-		next_key = (void *) (((char *) next_key) + size);
-		res = (*_cmp) (next_key, first_key);
+	/* Swap words. */
+	if (s->words)
+	{
+		word_t *wa = (word_t *)a;
+		word_t *wb = (word_t *)b;
 
-		if (res > 0)
-			return (k);
-		else if (res < 0)
-			return (i);
+		for (n = s->size/sizeof(word_t); n > 0; n--)
+		{
+			word_t tmp = *wa;
+			*wa++ = *wb;
+			*wb++ = tmp;
+		}
 	}
 
-	return (-1);
+	/* Swap bytes. */
+	else
+	{
+		for (n = s->size; n > 0; n--)
+		{
+			char tmp = *a;
+			*a++ = *b;
+			*b++ = tmp;
+		}
+	}
 }
 
 /**
- * @brief Swaps two elements.
+ * @brief Sorts a small array with insertion sort.
  */
-static void swap(void *base, int i, int j, size_t size)
+static void insertion_sort(const struct sort *s, char *base, size_t nmemb)
 {
-	static void *temp = NULL;
-	static size_t max_size = 0;
-	void *elem1, *elem2;
+	char *end = base + nmemb*s->size;
 
-	if (size > max_size)
+	for (char *p = base + s->size; p < end; p += s->size)
 	{
-		temp = realloc(temp, size);
-		max_size = size;
+		char *q;
+
+		for (q = p; q > base; q -= s->size)
+		{
+			if (CMP(s, q - s->size, q) <= 0)
+				break;
+
+			swap(s, q - s->size, q);
+		}
 	}
+}
+
+/**
+ * @brief Sifts an element down a heap.
+ */
+static void sift_down
+(const struct sort *s, char *base, size_t root, size_t nmemb)
+{
+	size_t child;
 
-	elem1 = ((char *) base) + (i * size);
-	elem2 = ((char *) base) + (j * size);
+	while ((child = 2*root + 1) < nmemb)
+	{
+		/* Pick larger child. */
+		if ((child + 1 < nmemb) &&
+			(CMP(s, base + child*s->size, base + (child + 1)*s->size) < 0))
+			child++;
+
+		/* Heap property holds. */
+		if (CMP(s, base + root*s->size, base + child*s->size) >= 0)
+			break;
 
-	memcpy (temp, elem1, size);
-	memcpy (elem1, elem2, size);
-	memcpy (elem2, temp, size);
+		swap(s, base + root*s->size, base + child*s->size);
+		root = child;
+	}
 }
 
 /**
- * @brief Partitions the array.
+ * @brief Sorts an array with heapsort.
  */
-static int partition(void *base, int i, int j, int pivot_index, size_t size)
+static void heap_sort(const struct sort *s, char *base, size_t nmemb)
 {
-	int left, right;
+	/* Build heap. */
+	for (size_t i = nmemb/2; i-- > 0; /* noop */)
+		sift_down(s, base, i, nmemb);
 
-	left = i;
-	right = j;
+	/* Pop maximums. */
+	for (size_t i = nmemb - 1; i > 0; i--)
+	{
+		swap(s, base, base + i*s->size);
+		sift_down(s, base, 0, i);
+	}
+}
 
-	do
+/**
+ * @brief Sorts an array with introsort.
+ *
+ * @details Quicksort with a median-of-three pivot, which switches to heapsort
+ *          once @p depth partitioning rounds are exceeded and leaves small
+ *          partitions to insertion sort. The smaller partition is sorted
+ *          recursively and the larger one iteratively, so the stack depth
+ *          is logarithmic.
+ */
+static void intro_sort
+(const struct sort *s, char *base, size_t nmemb, int depth)
+{
+	char *lo, *mid, *hi; /* Pivot candidates. */
+	char *i, *j;         /* Partition scans.  */
+	size_t nleft;        /* Left partition.   */
+
+	while (nmemb > INSERTION_SORT_MAX)
 	{
-		swap (base, left, right, size);
+		/* Too many rounds, so input is adversarial. */
+		if (depth-- == 0)
+		{
+			heap_sort(s, base, nmemb);
+			return;
+		}
+
+		/* Median of three. */
+		lo = base;
+		mid = base + (nmemb/2)*s->size;
+		hi = base + (nmemb - 1)*s->size;
+		if (CMP(s, mid, lo) < 0)
+			swap(s, mid, lo);
+		if (CMP(s, hi, mid) < 0)
+		{
+			swap(s, hi, mid);
+			if (CMP(s, mid, lo) < 0)
+				swap(s, mid, lo);
+		}
+		swap(s, base, mid);
+
+		/*
+		 * Partition around the pivot, which is now at base. The last
+		 * element is not smaller than the pivot, so both scans are bounded.
+		 */
+		i = base;
+		j = base + nmemb*s->size;
+		for (;;)
+		{
+			do
+				i += s->size;
+			while (CMP(s, i, base) < 0);
+
+			do
+				j -= s->size;
+			while (CMP(s, j, base) > 0);
 
-		if (pivot_index == left)
-			pivot_index = right;
-		else if (pivot_index == right)
-			pivot_index = left;
+			if (i >= j)
+				break;
 
-		while (_cmp ((void *) (((char *) base) + (left * size)),
-			(void *) (((char *) base) + (pivot_index * size))) < 0)
-			left++;
+			swap(s, i, j);
+		}
+		swap(s, base, j);
 
-		while (_cmp ((void *) (((char *) base) + (right * size)),
-			(void *) (((char *) base) + (pivot_index * size))) >= 0)
-			right--;
-	} while (left <= right);
+		nleft = (j - base)/s->size;
 
-	return (left);
+		/* Recurse into smaller partition. */
+		if (nleft < nmemb - nleft - 1)
+		{
+			intro_sort(s, base, nleft, depth);
+			base = j + s->size;
+			nmemb = nmemb - nleft - 1;
+		}
+		else
+		{
+			intro_sort(s, j + s->size, nmemb - nleft - 1, depth);
+			nmemb = nleft;
+		}
+	}
+
+	insertion_sort(s, base, nmemb);
 }
 
 /**
- * @brief Internal qsort().
+ * @brief Sorts a table of data, passing an argument to the comparator.
+ *
+ * @param base  Array to sort.
+ * @param nmemb Number of elements in the array.
+ * @param size  Size of each element.
+ * @param cmp   Comparison function.
+ * @param arg   Argument to @p cmp.
  */
-static void _qsort(void *base, int i, int j, size_t size)
+void qsort_r(void *base, size_t nmemb, size_t size,
+             int (*cmp)(const void *, const void *, void *), void *arg)
 {
-	int pivot_index, mid;
+	struct sort s;
+	int depth;
 
-	pivot_index = find_pivot(base, i, j, size);
-
-	if (pivot_index == -1)
+	/* Nothing to be done. */
+	if ((nmemb < 2) || (size == 0))
 		return;
 
-	/* Sort. */
-	mid = partition (base, i, j, pivot_index, size);
-	_qsort (base, i, mid - 1, size);
-	_qsort (base, mid, j, size);
+	s.size = size;
+	s.cmp = cmp;
+	s.arg = arg;
+	s.words = (((unsigned long)base | size) % sizeof(word_t)) == 0;
+
+	/* Twice the depth of a balanced partitioning. */
+	for (depth = 0; (nmemb >> (depth/2)) > 1; depth += 2)
+		/* noop */ ;
+
+	intro_sort(&s, base, nmemb, depth);
+}
+
+/**
+ * @brief Comparator of qsort().
+ */
+struct qsort_cmp
+{
+	int (*cmp)(const void *, const void *); /**< Comparator. */
+};
+
+/**
+ * @brief Calls the comparator of qsort().
+ */
+static int qsort_cmp(const void *a, const void *b, void *arg)
+{
+	return (((struct qsort_cmp *)arg)->cmp(a, b));
 }
 
 /**
@@ -175,6 +323,8 @@ static void _qsort(void *base, int i, int j, size_t size)
 void qsort
 (void *base, size_t nmemb, size_t size, int (*cmp)(const void *, const void *))
 {
-	_cmp = cmp;
-	_qsort(base, 0, nmemb - 1, size);
+	struct qsort_cmp c;
+
+	c.cmp = cmp;
+	qsort_r(base, nmemb, size, qsort_cmp, &c);
 }
@@ -59,14 +59,14 @@ int system(const char *command)
 	argv[2] = (command == NULL) ? "exit 0" : command;
 	argv[3] = NULL;
 
-	if ((pid = fork()) < 0)
+	if ((pid = vfork()) < 0)
 		return ((command == NULL) ? 0 : -1);
 
 	/* Execute command. */
 	else if (pid == 0)
 	{
 		execvp("sh", (char * const *)argv);
-		exit(-1);
+		_exit(-1);
 	}
 
 	/* Wait for child. */
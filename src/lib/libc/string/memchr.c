@@ -25,6 +25,7 @@
 
 #include <stdlib.h>
 #include <sys/types.h>
+#include "word.h"
 
 /**
  * @brief Finds a byte in memory.
@@ -41,14 +42,32 @@
 void *memchr(const void *s, int c, size_t n)
 {
 	const unsigned char *p;
+	const word_t *w;
+	word_t mask;
 
 	p = s;
+	c = (unsigned char)c;
+
+	/* Search up to a word boundary. */
+	for (/* noop */; (n > 0) && !WORD_ALIGNED(p); p++, n--)
+	{
+		if (*p == c)
+			return ((void *)p);
+	}
+
+	/* Skip words that do not have the byte. */
+	mask = c*WORD_ONES;
+	for (w = (const word_t *)p; n >= WORD_SIZE; w++, n -= WORD_SIZE)
+	{
+		if (WORD_HASZERO(*w ^ mask))
+			break;
+	}
 
 	/* Search byte. */
-	while (n-- > 0)
+	for (p = (const unsigned char *)w; n > 0; p++, n--)
 	{
-		if (*p++ == c)
-			return ((void *)(p - 1));
+		if (*p == c)
+			return ((void *)p);
 	}
 
 	return (NULL);
@@ -24,6 +24,7 @@
  */
 
 #include <sys/types.h>
+#include "word.h"
 
 /**
  * @brief Copies bytes in memory.
@@ -35,18 +36,42 @@
  * @returns @p s1 is returned.
  *
  * @note If copying takes place between objects that overlap, the behavior is
- *       undefined.
+ *       undefined. This implementation always copies forward, so memmove()
+ *       relies on it when the target precedes the source.
  */
 void *memcpy(void *restrict s1, const void *restrict s2, size_t n)
 {
-    char *p1;
-    const char* p2;
+	char *p1;
+	const char* p2;
+	size_t nwords;
 
-    p1 = s1;
-    p2 = s2;
+	p1 = s1;
+	p2 = s2;
 
-    while (n-- > 0)
-    	*p1++ = *p2++;
+	if (n >= WORD_THRESHOLD)
+	{
+		/* Align target. */
+		while (!WORD_ALIGNED(p1))
+		{
+			*p1++ = *p2++;
+			n--;
+		}
 
-    return (p1);
+		/* Copy words. */
+		nwords = n/WORD_SIZE;
+		__asm__ volatile (
+			"rep movsl"
+			: "+D" (p1), "+S" (p2), "+c" (nwords)
+			:
+			: "memory"
+		);
+
+		n &= WORD_SIZE - 1;
+	}
+
+	/* Copy remaining bytes. */
+	while (n-- > 0)
+		*p1++ = *p2++;
+
+	return (s1);
 }
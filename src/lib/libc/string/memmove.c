@@ -57,6 +57,7 @@
  */
 
 #include <sys/types.h>
+#include <string.h>
 
 /**
  * @brief Copies bytes in memory with overlapping areas.
@@ -86,11 +87,9 @@ void *memmove(void *s1, const void *s2, size_t n)
 			*--p1 = *--p2;
 	}
 
+	/* memcpy() copies forward. */
 	else
-	{
-		while (n-- > 0)
-			*p1++ = *p2++;
-	}
+		memcpy(p1, p2, n);
 
 	return (s1);
 }
@@ -24,6 +24,7 @@
  */
 
 #include <sys/types.h>
+#include "word.h"
 
 /**
  * @brief Sets bytes in memory.
@@ -39,9 +40,34 @@
 void *memset(void *s, int c, size_t n)
 {
 	unsigned char *p;
+	word_t w;
+	size_t nwords;
 
 	p = s;
 
+	if (n >= WORD_THRESHOLD)
+	{
+		/* Align target. */
+		while (!WORD_ALIGNED(p))
+		{
+			*p++ = c;
+			n--;
+		}
+
+		/* Set words. */
+		w = (unsigned char)c*WORD_ONES;
+		nwords = n/WORD_SIZE;
+		__asm__ volatile (
+			"rep stosl"
+			: "+D" (p), "+c" (nwords)
+			: "a" (w)
+			: "memory"
+		);
+
+		n &= WORD_SIZE - 1;
+	}
+
+	/* Set remaining bytes. */
 	while (n-- > 0)
 		*p++ = c;
 
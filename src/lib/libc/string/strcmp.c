@@ -23,6 +23,8 @@
  * @brief strcmp() implementation.
  */
 
+#include "word.h"
+
 /**
  * @brief Compares two strings.
  *
@@ -37,6 +39,34 @@
  */
 int strcmp(const char *s1, const char *s2)
 {
+	const word_t *w1, *w2;
+
+	/* Compare whole words. */
+	if (WORD_ALIGNED((unsigned long)s1 ^ (unsigned long)s2))
+	{
+		/* Compare up to a word boundary. */
+		while ((!WORD_ALIGNED(s1)) && (*s1 == *s2) && (*s1 != '\0'))
+		{
+			s1++;
+			s2++;
+		}
+
+		if (WORD_ALIGNED(s1))
+		{
+			w1 = (const word_t *)s1;
+			w2 = (const word_t *)s2;
+
+			while ((*w1 == *w2) && !WORD_HASZERO(*w1))
+			{
+				w1++;
+				w2++;
+			}
+
+			s1 = (const char *)w1;
+			s2 = (const char *)w2;
+		}
+	}
+
 	/* Compare strings. */
 	while (*s1 == *s2)
 	{
@@ -24,6 +24,7 @@
  */
 
 #include <sys/types.h>
+#include "word.h"
 
 /**
  * @brief Gets string length.
@@ -37,9 +38,24 @@
 size_t strlen(const char *str)
 {
 	const char *p;
+	const word_t *w;
 
-	/* Count the number of characters. */
-	for (p = str; *p != '\0'; p++)
+	/* Scan up to a word boundary. */
+	for (p = str; !WORD_ALIGNED(p); p++)
+	{
+		if (*p == '\0')
+			return (p - str);
+	}
+
+	/*
+	 * Scan whole words. Aligned words never cross a page boundary, so
+	 * reading past the terminator is safe.
+	 */
+	for (w = (const word_t *)p; !WORD_HASZERO(*w); w++)
+		/* No operation.*/;
+
+	/* Find terminator in last word. */
+	for (p = (const char *)w; *p != '\0'; p++)
 		/* No operation.*/;
 
 	return (p - str);
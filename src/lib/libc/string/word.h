@@ -0,0 +1,53 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _WORD_H_
+#define _WORD_H_
+
+	/*
+	 * Machine word, as used by word-at-a-time string routines. Words may
+	 * alias any object.
+	 */
+	typedef unsigned long word_t __attribute__((__may_alias__));
+
+	/* Word size. */
+	#define WORD_SIZE sizeof(word_t)
+
+	/* Word with all bytes set to one. */
+	#define WORD_ONES 0x01010101UL
+
+	/* Word with the high bit of all bytes set. */
+	#define WORD_HIGHS 0x80808080UL
+
+	/*
+	 * Asserts if a word has a zero byte.
+	 */
+	#define WORD_HASZERO(w) \
+		(((w) - WORD_ONES) & ~(w) & WORD_HIGHS)
+
+	/*
+	 * Asserts if a pointer is word aligned.
+	 */
+	#define WORD_ALIGNED(p) \
+		(((unsigned long)(p) & (WORD_SIZE - 1)) == 0)
+
+	/* Smallest copy done with string instructions. */
+	#define WORD_THRESHOLD 16
+
+#endif /* _WORD_H_ */
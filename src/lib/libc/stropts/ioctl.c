@@ -41,7 +41,7 @@ int ioctl(int fd, int cmd, ...)
 	}
 
 	__asm__ volatile (
-		"int $0x80"
+		"call *__sysentry"
 		: "=a" (ret)
 		: "0" (NR_ioctl),
 		  "b" (fd),
@@ -0,0 +1,55 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/syscall.h>
+#include <sys/mman.h>
+#include <errno.h>
+
+/**
+ * @brief Maps pages of memory.
+ */
+void *mmap(void *addr, size_t len, int prot, int flags, int fd, off_t off)
+{
+	int ret;
+	struct mmap_args args;
+
+	args.addr = addr;
+	args.len = len;
+	args.prot = prot;
+	args.flags = flags;
+	args.fd = fd;
+	args.off = off;
+
+	__asm__ volatile (
+		"call *__sysentry"
+		: "=a" (ret)
+		: "0" (NR_mmap),
+		  "b" (&args)
+		: "memory"
+	);
+
+	/* Error. */
+	if ((ret < 0) && (ret > -4096))
+	{
+		errno = -ret;
+		return (MAP_FAILED);
+	}
+
+	return ((void *)ret);
+}
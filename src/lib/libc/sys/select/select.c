@@ -0,0 +1,146 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sys/select.h>
+#include <errno.h>
+#include <limits.h>
+#include <poll.h>
+#include <stddef.h>
+
+/*
+ * Events that make a file descriptor ready.
+ */
+#define SELECT_READ  (POLLIN | POLLRDNORM | POLLHUP | POLLERR)
+#define SELECT_WRITE (POLLOUT | POLLWRNORM | POLLERR)
+#define SELECT_ERROR (POLLPRI | POLLRDBAND)
+
+/**
+ * @brief Waits for file descriptors to become ready.
+ *
+ * @details Implemented on top of poll(), which checks all file descriptors in
+ *          a single kernel entry. File descriptors that are not ready are
+ *          removed from the sets.
+ *
+ * @param nfds     Range of file descriptors to check.
+ * @param readfds  File descriptors to check for reading.
+ * @param writefds File descriptors to check for writing.
+ * @param errorfds File descriptors to check for errors.
+ * @param timeout  Maximum time to wait (NULL to wait forever).
+ *
+ * @returns Upon successful completion, the total number of bits set in the
+ *          sets is returned. Upon failure, -1 is returned and errno is set to
+ *          indicate the error.
+ */
+int select(int nfds, fd_set *readfds, fd_set *writefds,
+	fd_set *errorfds, struct timeval *timeout)
+{
+	int n;                        /* Polled file descriptors. */
+	int ret;                      /* Return value.            */
+	int msecs;                    /* Timeout in milliseconds. */
+	struct pollfd fds[OPEN_MAX];  /* Polled file descriptors. */
+
+	/* Invalid range. */
+	if ((nfds < 0) || (nfds > FD_SETSIZE))
+	{
+		errno = EINVAL;
+		return (-1);
+	}
+
+	/* Convert timeout. */
+	msecs = -1;
+	if (timeout != NULL)
+	{
+		if ((timeout->tv_sec < 0) || (timeout->tv_usec < 0) || (timeout->tv_usec >= 1000000))
+		{
+			errno = EINVAL;
+			return (-1);
+		}
+
+		msecs = (timeout->tv_sec > INT_MAX/1000 - 1) ? INT_MAX :
+			timeout->tv_sec*1000 + (timeout->tv_usec + 999)/1000;
+	}
+
+	/* Build poll list. */
+	n = 0;
+	for (int fd = 0; fd < nfds; fd++)
+	{
+		short events = 0;
+
+		if ((readfds != NULL) && (FD_ISSET(fd, readfds)))
+			events |= POLLIN;
+		if ((writefds != NULL) && (FD_ISSET(fd, writefds)))
+			events |= POLLOUT;
+		if ((errorfds != NULL) && (FD_ISSET(fd, errorfds)))
+			events |= POLLPRI;
+
+		if (events == 0)
+			continue;
+
+		/* Bad file descriptor. */
+		if (n == OPEN_MAX)
+		{
+			errno = EBADF;
+			return (-1);
+		}
+
+		fds[n].fd = fd;
+		fds[n].events = events;
+		fds[n].revents = 0;
+		n++;
+	}
+
+	if (poll(fds, n, msecs) < 0)
+		return (-1);
+
+	/* Update sets. */
+	ret = 0;
+	for (int i = 0; i < n; i++)
+	{
+		/* Bad file descriptor. */
+		if (fds[i].revents & POLLNVAL)
+		{
+			errno = EBADF;
+			return (-1);
+		}
+
+		if ((readfds != NULL) && (FD_ISSET(fds[i].fd, readfds)))
+		{
+			if (fds[i].revents & SELECT_READ)
+				ret++;
+			else
+				FD_CLR(fds[i].fd, readfds);
+		}
+		if ((writefds != NULL) && (FD_ISSET(fds[i].fd, writefds)))
+		{
+			if (fds[i].revents & SELECT_WRITE)
+				ret++;
+			else
+				FD_CLR(fds[i].fd, writefds);
+		}
+		if ((errorfds != NULL) && (FD_ISSET(fds[i].fd, errorfds)))
+		{
+			if (fds[i].revents & SELECT_ERROR)
+				ret++;
+			else
+				FD_CLR(fds[i].fd, errorfds);
+		}
+	}
+
+	return (ret);
+}
@@ -18,22 +18,54 @@
  */
 
 #include <nanvix/syscall.h>
+#include <sys/sem.h>
 #include <errno.h>
+#include <stdarg.h>
 
 /**
- * @brief Performs control operations in a semaphore.
+ * @brief Performs control operations on a semaphore set.
+ *
+ * @details The fourth argument is only fetched by commands that take one.
  */
-int semctl(int semid, int cmd, int val)
+int semctl(int semid, int semnum, int cmd, ...)
 {
 	int ret;
+	va_list ap;
+	struct semctl_args args;
+
+	args.semid = semid;
+	args.semnum = semnum;
+	args.cmd = cmd;
+	args.arg.buf = NULL;
+
+	va_start(ap, cmd);
+	switch (cmd)
+	{
+		case SETVAL:
+			args.arg.val = va_arg(ap, int);
+			break;
+
+		case GETALL:
+		case SETALL:
+			args.arg.array = va_arg(ap, unsigned short *);
+			break;
+
+		case IPC_STAT:
+		case IPC_SET:
+			args.arg.buf = va_arg(ap, struct semid_ds *);
+			break;
+
+		default:
+			break;
+	}
+	va_end(ap);
 
 	__asm__ volatile (
-		"int $0x80"
+		"call *__sysentry"
 		: "=a" (ret)
 		: "0" (NR_semctl),
-		  "b" (semid),
-		  "c" (cmd),
-		  "d" (val)
+		  "b" (&args)
+		: "memory"
 	);
 
 	/* Error. */
@@ -18,20 +18,23 @@
  */
 
 #include <nanvix/syscall.h>
+#include <sys/sem.h>
 #include <errno.h>
 
 /**
- * @brief Creates a semaphore.
+ * @brief Gets a semaphore set.
  */
-int semget(unsigned key)
+int semget(key_t key, int nsems, int semflg)
 {
 	int ret;
 
 	__asm__ volatile (
-		"int $0x80"
+		"call *__sysentry"
 		: "=a" (ret)
 		: "0" (NR_semget),
-		  "b" (key)
+		  "b" (key),
+		  "c" (nsems),
+		  "d" (semflg)
 	);
 
 	/* Error. */
@@ -18,21 +18,24 @@
  */
 
 #include <nanvix/syscall.h>
+#include <sys/sem.h>
 #include <errno.h>
 
 /**
- * @brief Performs operations in a semaphore.
+ * @brief Performs operations on a semaphore set.
  */
-int semop(int semid, int op)
+int semop(int semid, struct sembuf *sops, size_t nsops)
 {
 	int ret;
 
 	__asm__ volatile (
-		"int $0x80"
+		"call *__sysentry"
 		: "=a" (ret)
 		: "0" (NR_semop),
 		  "b" (semid),
-		  "c" (op)
+		  "c" (sops),
+		  "d" (nsops)
+		: "memory"
 	);
 
 	/* Error. */
@@ -44,4 +47,3 @@ int semop(int semid, int op)
 
 	return (ret);
 }
-
@@ -0,0 +1,49 @@
+
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/syscall.h>
+#include <sys/shm.h>
+#include <errno.h>
+
+/**
+ * @brief Attaches a shared memory segment.
+ */
+void *shmat(int shmid, const void *shmaddr, int shmflg)
+{
+	int ret;
+
+	__asm__ volatile (
+		"call *__sysentry"
+		: "=a" (ret)
+		: "0" (NR_shmat),
+		  "b" (shmid),
+		  "c" (shmaddr),
+		  "d" (shmflg)
+	);
+
+	/* Error. */
+	if ((ret < 0) && (ret > -4096))
+	{
+		errno = -ret;
+		return ((void *) -1);
+	}
+
+	return ((void *)ret);
+}
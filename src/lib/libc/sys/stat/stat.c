@@ -29,7 +29,7 @@ int stat(const char *path, struct stat *buf)
 	int ret;
 
 	__asm__ volatile (
-		"int $0x80"
+		"call *__sysentry"
 		: "=a" (ret)
 		: "0" (NR_stat),
 		  "b" (path),
@@ -17,7 +17,8 @@
  * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <nanvix/syscall.h>
+#include <nanvix/vdso.h>
+#include <stddef.h>
 #include <sys/times.h>
 #include <sys/types.h>
 #include <errno.h>
@@ -25,6 +26,9 @@
 /**
  * @brief Gets process and waited-for child process times.
  *
+ * @details Times are read from the vDSO data page, and the read is retried
+ *          if the kernel updated the page meanwhile.
+ *
  * @param buffer Timing accounting information.
  *
  * @returns Upon successful completion, the elapsed real time, in clock ticks,
@@ -33,21 +37,25 @@
  */
 clock_t times(struct tms *buffer)
 {
-	clock_t elapsed;
-
-	__asm__ volatile (
-		"int $0x80"
-		: "=a" (elapsed)
-		: "0" (NR_times),
-		  "b" (buffer)
-	);
+	unsigned seq;    /* Sequence number. */
+	clock_t elapsed; /* Elapsed time.    */
 
-	/* Error. */
-	if (elapsed < 0)
+	/* Not a valid buffer. */
+	if (buffer == NULL)
 	{
-		errno = -elapsed;
+		errno = EINVAL;
 		return (-1);
 	}
 
+	do
+	{
+		seq = VDSO->seq;
+		buffer->tms_utime = VDSO->times.tms_utime;
+		buffer->tms_stime = VDSO->times.tms_stime;
+		buffer->tms_cutime = VDSO->times.tms_cutime;
+		buffer->tms_cstime = VDSO->times.tms_cstime;
+		elapsed = VDSO->time*VDSO->hz;
+	} while ((seq & 1) || (seq != VDSO->seq));
+
 	return (elapsed);
 }
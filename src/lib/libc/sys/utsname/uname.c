@@ -34,7 +34,7 @@ int uname(struct utsname *name)
 	int ret;
 
 	__asm__ volatile (
-		"int $0x80"
+		"call *__sysentry"
 		: "=a" (ret)
 		: "0" (NR_uname),
 		  "b" (name)
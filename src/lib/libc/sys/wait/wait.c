@@ -28,7 +28,7 @@ pid_t wait(int *stat_loc)
 	pid_t pid;
 
 	__asm__ volatile (
-		"int $0x80"
+		"call *__sysentry"
 		: "=a" (pid)
 		: "0" (NR_wait),
 		  "b" (stat_loc)
@@ -0,0 +1,41 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/vdso.h>
+#include <stddef.h>
+#include <time.h>
+
+/**
+ * @brief Gets time.
+ *
+ * @param tloc Where to store the time (may be NULL).
+ *
+ * @returns The current time, in seconds since the Epoch.
+ */
+time_t time(time_t *tloc)
+{
+	time_t t;
+
+	t = VDSO->time;
+
+	if (tloc != NULL)
+		*tloc = t;
+
+	return (t);
+}
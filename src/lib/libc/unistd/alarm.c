@@ -28,7 +28,7 @@ unsigned alarm(unsigned seconds)
     unsigned ret;
 
 	__asm__ volatile (
-		"int $0x80"
+		"call *__sysentry"
 		: "=a" (ret)
 		: "0" (NR_alarm),
           "b" (seconds)
@@ -29,7 +29,7 @@ int chown(const char *path, uid_t owner, gid_t group)
 	int ret;
 
 	__asm__ volatile (
-		"int $0x80"
+		"call *__sysentry"
 		: "=a" (ret)
 		: "0" (NR_chown),
 		  "b" (path),
@@ -29,7 +29,7 @@ int close(int fd)
 	int ret;
 
 	__asm__ volatile (
-		"int $0x80"
+		"call *__sysentry"
 		: "=a" (ret)
 		: "0" (NR_close),
 		  "b" (fd)
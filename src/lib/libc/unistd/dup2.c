@@ -29,7 +29,7 @@ int dup2(int oldfd, int newfd)
 	int ret;
 
 	__asm__ volatile (
-		"int $0x80"
+		"call *__sysentry"
 		: "=a" (ret)
 		: "0" (NR_dup2),
 		  "b" (oldfd),
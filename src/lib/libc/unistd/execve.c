@@ -19,6 +19,7 @@
 
 #include <nanvix/syscall.h>
 #include <errno.h>
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
@@ -31,7 +32,7 @@ int execve(const char *filename, char *const argv[],  char *const envp[])
 	int ret;
 
 	__asm__ volatile (
-		"int $0x80"
+		"call *__sysentry"
 		: "=a" (ret)
 		: "0" (NR_execve),
 		  "b" (filename),
@@ -54,11 +55,11 @@ int execve(const char *filename, char *const argv[],  char *const envp[])
  */
 int execvp(const char *file, char *const argv[])
 {
-	int denied; /* Access denied?       */
-	char *name; /* Working path name.   */
-	int length; /* File name length.    */
-	char *path; /* Working path.        */
-	char *p;    /* End of working path. */
+	int denied;          /* Access denied?       */
+	char name[PATH_MAX]; /* Working path name.   */
+	int length;          /* File name length.    */
+	char *path;          /* Working path.        */
+	char *p;             /* End of working path. */
 
 	/* Use given path. */
 	if (strchr(file, '/') != NULL)
@@ -71,9 +72,10 @@ int execvp(const char *file, char *const argv[])
 	length = strlen(file) + 1;
 	path = getenv("PATH");
 
-	name = malloc(length + strlen(path));
-	if (name == NULL)
-		return (-1);
+	/*
+	 * Build path names on the stack, rather than on
+	 * the heap, so that we are safe after vfork().
+	 */
 
 	/* Search for executable. */
 	do
@@ -90,6 +92,13 @@ int execvp(const char *file, char *const argv[])
 		if (p == NULL)
 			p = strchr(path, '\0');
 
+		/* Path name too long. */
+		if ((p - path) + 1 + length > PATH_MAX)
+		{
+			errno = ENAMETOOLONG;
+			goto error;
+		}
+
 		/* Build path name.  */
 		memcpy (name, path, p - path);
 		name[p - path] = '/';
@@ -123,7 +132,6 @@ int execvp(const char *file, char *const argv[])
 		errno = EACCES;
 
 error:
-	free(name);
 	return (-1);
 }
 
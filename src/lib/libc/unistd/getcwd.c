@@ -17,6 +17,7 @@
  * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <nanvix/syscall.h>
 #include <dirent.h>
 #include <errno.h>
 #include <stdlib.h>
@@ -80,6 +81,24 @@ static int prepend(char *pathname, const char *dirname, size_t n)
 	return (0);
 }
 
+/*
+ * Asks the kernel for the pathname of the current working directory.
+ */
+static int __getcwd(char *buf, size_t size)
+{
+	int ret;
+
+	__asm__ volatile (
+		"call *__sysentry"
+		: "=a" (ret)
+		: "0" (NR_getcwd),
+		  "b" (buf),
+		  "c" (size)
+	);
+
+	return (ret);
+}
+
 /*
  * Gets the pathname of the current working directory.
  */
@@ -93,6 +112,7 @@ char *getcwd(char *buf, size_t size)
 	struct stat st;        /* Working directory stat.    */
 	struct dirent *dp;     /* Working directory entry.   */
 	char curdir[PATH_MAX]; /* Current directory.         */
+	int ret;               /* Kernel return value.       */
 
 	/* Invalid size. */
 	if (size == 0)
@@ -101,6 +121,22 @@ char *getcwd(char *buf, size_t size)
 		return (NULL);
 	}
 
+	/*
+	 * The kernel rebuilds the pathname from its name cache. When some
+	 * directory on the way up is not cached, walk the tree instead.
+	 */
+	if ((ret = __getcwd(buf, size)) != -ENOENT)
+	{
+		/* Error. */
+		if (ret < 0)
+		{
+			errno = -ret;
+			return (NULL);
+		}
+
+		return (buf);
+	}
+
 	buf[0] = '\0';
 	strcpy(curdir, ".");
 
@@ -137,7 +173,11 @@ char *getcwd(char *buf, size_t size)
 			goto error0;
 
 		/* Get lower directory name. */
-		dp = getdirent(dirp, cino);
+		if ((dp = getdirent(dirp, cino)) == NULL)
+		{
+			errno = ENOENT;
+			goto error1;
+		}
 		if (prepend(buf, dp->d_name, size))
 			goto error1;
 
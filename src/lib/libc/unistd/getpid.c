@@ -17,21 +17,16 @@
  * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <nanvix/syscall.h>
+#include <nanvix/vdso.h>
 #include <unistd.h>
 
 /**
  * @brief Gets the ID of the calling process
+ *
+ * @details The ID is read from the vDSO data page, where the kernel
+ *          publishes the ID of the running process.
  */
 pid_t getpid(void)
 {
-	pid_t pid;
-
-	__asm__ volatile (
-		"int $0x80"
-		: "=a" (pid)
-		: "0" (NR_getpid)
-	);
-
-	return (pid);
+	return (VDSO->pid);
 }
@@ -29,7 +29,7 @@ uid_t getuid(void)
 	uid_t ret;
 
 	__asm__ volatile (
-		"int $0x80"
+		"call *__sysentry"
 		: "=a" (ret)
 		: "0" (NR_getuid)
 	);
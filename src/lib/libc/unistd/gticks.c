@@ -17,9 +17,8 @@
  * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <nanvix/syscall.h>
+#include <nanvix/vdso.h>
 #include <unistd.h>
-#include <errno.h>
 
 /*
  * Gets sys ticks since initialization, may be useful
@@ -27,20 +26,5 @@
  */
 int gticks()
 {
-	ssize_t ret = 0;
-
-	__asm__ volatile (
-		"int $0x80"
-		: "=a" (ret)
-		: "0" (NR_gticks)
-	);
-
-	/* Error. */
-	if (ret < 0)
-	{
-		errno = -ret;
-		return (-1);
-	}
-
-	return ((ssize_t)ret);
+	return (VDSO->ticks);
 }
@@ -27,7 +27,7 @@
 off_t lseek(int fd, off_t offset, int whence)
 {
 	__asm__ volatile (
-		"int $0x80"
+		"call *__sysentry"
 		: "=a" (offset)
 		: "0" (NR_lseek),
 		  "b" (fd),
@@ -29,7 +29,7 @@ int pipe(int fildes[2])
 	int ret;
 
 	__asm__ volatile (
-		"int $0x80"
+		"call *__sysentry"
 		: "=a" (ret)
 		: "0" (NR_pipe),
 		  "b" (fildes)
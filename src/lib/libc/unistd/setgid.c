@@ -34,7 +34,7 @@ int setgid(gid_t gid)
 	int ret;
 
 	__asm__ volatile (
-		"int $0x80"
+		"call *__sysentry"
 		: "=a" (ret)
 		: "0" (NR_setgid),
 		  "b" (gid)
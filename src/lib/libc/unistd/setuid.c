@@ -34,7 +34,7 @@ int setuid(uid_t uid)
 	int ret;
 
 	__asm__ volatile (
-		"int $0x80"
+		"call *__sysentry"
 		: "=a" (ret)
 		: "0" (NR_setuid),
 		  "b" (uid)
@@ -26,7 +26,7 @@
 void sync(void)
 {
 	__asm__ volatile(
-		"int $0x80"
+		"call *__sysentry"
 		: /* empty. */
 		: "a" (NR_sync)
 	);
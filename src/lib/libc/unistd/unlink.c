@@ -28,7 +28,7 @@ int unlink(const char *path)
 	int ret;
 
 	__asm__ volatile (
-		"int $0x80"
+		"call *__sysentry"
 		: "=a" (ret)
 		: "0" (NR_unlink),
 		  "b" (path)
@@ -28,7 +28,7 @@ int utime(const char *path, struct utimbuf *times)
 	int ret;
 
 	__asm__ volatile (
-		"int $0x80"
+		"call *__sysentry"
 		: "=a" (ret)
 		: "0" (NR_utime),
 		  "b" (path),
@@ -0,0 +1,178 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Size of benchmark buffers.
+ */
+#define BUFFER_SIZE (64*1024)
+
+/**
+ * @brief Number of times each measurement is repeated.
+ */
+#define NR_RUNS 8
+
+/**
+ * @brief Benchmark buffers.
+ */
+static char src[BUFFER_SIZE + 8];
+static char dst[BUFFER_SIZE + 8];
+
+/**
+ * @brief Transfer sizes.
+ */
+static const size_t sizes[] = { 16, 64, 256, 4096, BUFFER_SIZE };
+
+/**
+ * @brief Reads the time stamp counter.
+ *
+ * @returns The low 32 bits of the time stamp counter.
+ */
+static unsigned rdtsc(void)
+{
+	unsigned lo, hi;
+
+	__asm__ volatile ("rdtsc" : "=a" (lo), "=d" (hi));
+
+	return (lo);
+}
+
+/**
+ * @brief Benchmarked routines.
+ */
+enum bench
+{
+	BENCH_MEMCPY,  /**< memcpy().  */
+	BENCH_MEMSET,  /**< memset().  */
+	BENCH_MEMMOVE, /**< memmove(). */
+	BENCH_STRLEN,  /**< strlen().  */
+	BENCH_MEMCHR,  /**< memchr().  */
+	BENCH_STRCMP,  /**< strcmp().  */
+	BENCH_NR       /**< Number of benchmarks. */
+};
+
+/**
+ * @brief Names of benchmarked routines.
+ */
+static const char *names[BENCH_NR] = {
+	"memcpy", "memset", "memmove", "strlen", "memchr", "strcmp"
+};
+
+/**
+ * @brief Runs a routine over a buffer.
+ *
+ * @param bench Target routine.
+ * @param n     Number of bytes to process.
+ * @param off   Misalignment of the source buffer.
+ *
+ * @returns The least number of cycles that the routine took.
+ */
+static unsigned run(enum bench bench, size_t n, size_t off)
+{
+	unsigned t0, t1, best;
+
+	/* Strings span the whole transfer. */
+	memset(src, 'a', sizeof(src));
+	memset(dst, 'a', sizeof(dst));
+	src[off + n - 1] = '\0';
+	dst[n - 1] = '\0';
+
+	best = ~0u;
+	for (int i = 0; i < NR_RUNS; i++)
+	{
+		t0 = rdtsc();
+
+		switch (bench)
+		{
+			case BENCH_MEMCPY:
+				memcpy(dst, src + off, n);
+				break;
+			case BENCH_MEMSET:
+				memset(dst + off, 0, n);
+				break;
+			case BENCH_MEMMOVE:
+				memmove(dst + off, dst, n);
+				break;
+			case BENCH_STRLEN:
+				strlen(src + off);
+				break;
+			case BENCH_MEMCHR:
+				memchr(src + off, 'b', n);
+				break;
+			case BENCH_STRCMP:
+				strcmp(src + off, dst);
+				break;
+			default:
+				break;
+		}
+
+		t1 = rdtsc();
+
+		if (t1 - t0 < best)
+			best = t1 - t0;
+
+		/* Restore buffers. */
+		if (bench == BENCH_MEMCPY)
+			dst[n - 1] = '\0';
+		else if ((bench == BENCH_MEMSET) || (bench == BENCH_MEMMOVE))
+			memset(dst, 'a', sizeof(dst));
+	}
+
+	return (best);
+}
+
+/**
+ * @brief Measures throughput of C library string routines.
+ *
+ * @details Prints, for each routine and transfer size, the number of bytes
+ *          processed per CPU cycle with aligned and misaligned buffers. The
+ *          best of several runs is taken, so that cache misses do not show.
+ */
+int main(int argc, char **argv)
+{
+	unsigned cycles; /* Elapsed cycles.        */
+	unsigned bpc;    /* Bytes per 100 cycles.  */
+
+	((void)argc);
+	((void)argv);
+
+	printf("ROUTINE  SIZE   ALIGN  BYTES/CYCLE\n");
+
+	for (int i = 0; i < BENCH_NR; i++)
+	{
+		for (size_t j = 0; j < sizeof(sizes)/sizeof(sizes[0]); j++)
+		{
+			for (size_t off = 0; off < 8; off += 3)
+			{
+				if ((cycles = run(i, sizes[j], off)) == 0)
+					cycles = 1;
+
+				bpc = (sizes[j]*100)/cycles;
+
+				printf("%s %d %d %d.%d%d\n", names[i], sizes[j], off,
+					bpc/100, (bpc/10)%10, bpc%10);
+			}
+		}
+	}
+
+	return (EXIT_SUCCESS);
+}
@@ -19,16 +19,27 @@
  */
 
 #include <assert.h>
+#include <errno.h>
 #include <nanvix/config.h>
+#include <nanvix/syscall.h>
+#include <sys/mman.h>
+#include <sys/select.h>
 #include <sys/times.h>
 #include <sys/wait.h>
 #include <sys/sem.h>
+#include <sys/shm.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
 #include <stdio.h>
 #include <signal.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
-#include <nanvix/fs.h>
+#include <time.h>
+#include <pthread.h>
 
 
 /* Test flags. */
@@ -449,133 +460,2350 @@ static int sched_test3(void)
 	return (0);
 }
 
+/*============================================================================*
+ *                                spawn_test                                  *
+ *============================================================================*/
+
+/**
+ * @brief Number of processes spawned by the spawn test.
+ */
+#define SPAWN_NR_PROCS 64
+
+/**
+ * @brief Spawns a process that runs a trivial program.
+ *
+ * @param use_vfork Use vfork() instead of fork()?
+ *
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+static int spawn(int use_vfork)
+{
+	pid_t pid, ret;
+	int status;
+	char *const argv[] = { "echo", NULL };
+
+	pid = (use_vfork) ? vfork() : fork();
+
+	/* Failed to fork(). */
+	if (pid < 0)
+		return (-1);
+
+	/* Child process. */
+	else if (pid == 0)
+	{
+		close(1);
+		open("/dev/null", O_WRONLY);
+		execv("/bin/echo", argv);
+		_exit(EXIT_FAILURE);
+	}
+
+	/* Wait for child. */
+	do
+	{
+		if ((ret = wait(&status)) < 0)
+			return (-1);
+	} while (ret != pid);
+
+	return (!(WIFEXITED(status) && (WEXITSTATUS(status) == EXIT_SUCCESS)));
+}
+
+/**
+ * @brief Process spawning test.
+ *
+ * @details Measures fork()+execv()+wait() latency and compares it against
+ *          vfork()+execv()+wait().
+ *
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+static int spawn_test(void)
+{
+	clock_t t0, t1, t2; /* Elapsed times.      */
+	struct tms timing;  /* Timing information. */
+
+	t0 = times(&timing);
+
+	for (int i = 0; i < SPAWN_NR_PROCS; i++)
+	{
+		if (spawn(0))
+			return (-1);
+	}
+
+	t1 = times(&timing);
+
+	for (int i = 0; i < SPAWN_NR_PROCS; i++)
+	{
+		if (spawn(1))
+			return (-1);
+	}
+
+	t2 = times(&timing);
+
+	/* Print timing statistics. */
+	if (flags & VERBOSE)
+	{
+		printf("  fork+exec+wait:  %d ticks for %d processes\n",
+			t1 - t0, SPAWN_NR_PROCS);
+		printf("  vfork+exec+wait: %d ticks for %d processes\n",
+			t2 - t1, SPAWN_NR_PROCS);
+	}
+
+	return (0);
+}
+
+/*============================================================================*
+ *                                mmap_test                                   *
+ *============================================================================*/
+
+/**
+ * @brief Largest file portion scanned by mmap_test().
+ */
+#define MMAP_TEST_SIZE 0x100000
+
+/**
+ * @brief Size of the anonymous mapping used by mmap_test().
+ */
+#define MMAP_TEST_ANON 0x2000
+
+/**
+ * @brief Memory mapping test.
+ *
+ * @details Scans /bigfile.bin with read() and then through a private file
+ *          mapping, checks that both see the same data and compares their
+ *          latencies. An anonymous mapping is checked for demand zero too.
+ *
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+static int mmap_test(void)
+{
+	int fd;                   /* File descriptor.    */
+	char *p;                  /* Mapped memory.      */
+	size_t size;              /* Bytes to scan.      */
+	ssize_t n;                /* Bytes read.         */
+	unsigned sum1, sum2;      /* Checksums.          */
+	clock_t t0, t1, t2;       /* Elapsed times.      */
+	struct tms timing;        /* Timing information. */
+	struct stat st;           /* File status.        */
+	static char buffer[4096]; /* Read buffer.        */
+
+	if ((fd = open("/bigfile.bin", O_RDONLY)) < 0)
+		return (-1);
+
+	if (stat("/bigfile.bin", &st) < 0)
+		goto error;
+
+	size = (st.st_size < MMAP_TEST_SIZE) ? st.st_size : MMAP_TEST_SIZE;
+
+	t0 = times(&timing);
+
+	/* Scan file with read(). */
+	sum1 = 0;
+	for (size_t i = 0; i < size; i += n)
+	{
+		n = read(fd, buffer, sizeof(buffer));
+		if (n <= 0)
+			goto error;
+		for (ssize_t j = 0; (j < n) && (i + j < size); j++)
+			sum1 += (unsigned char)buffer[j];
+	}
+
+	t1 = times(&timing);
+
+	/* Scan file through a mapping. */
+	p = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (p == MAP_FAILED)
+		goto error;
+	sum2 = 0;
+	for (size_t i = 0; i < size; i++)
+		sum2 += (unsigned char)p[i];
+	if (munmap(p, size) < 0)
+		goto error;
+
+	t2 = times(&timing);
+
+	close(fd);
+
+	if (sum1 != sum2)
+		return (-1);
+
+	/* Anonymous mapping. */
+	p = mmap(NULL, MMAP_TEST_ANON, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (p == MAP_FAILED)
+		return (-1);
+	for (int i = 0; i < MMAP_TEST_ANON; i++)
+	{
+		if (p[i] != 0)
+			return (-1);
+		p[i] = (char)i;
+	}
+	if (munmap(p, MMAP_TEST_ANON) < 0)
+		return (-1);
+
+	/* Print timing statistics. */
+	if (flags & VERBOSE)
+	{
+		printf("  read(): %d ticks for %d bytes\n", t1 - t0, size);
+		printf("  mmap(): %d ticks for %d bytes\n", t2 - t1, size);
+	}
+
+	return (0);
+
+error:
+	close(fd);
+	return (-1);
+}
+
+/*============================================================================*
+ *                                pipe_test                                   *
+ *============================================================================*/
+
+/**
+ * @brief Number of bytes sent through a pipe by pipe_test().
+ */
+#define PIPE_TEST_SIZE 0x100000
+
+/**
+ * @brief Size of read()/write() requests issued by pipe_test().
+ */
+#define PIPE_TEST_CHUNK 4096
+
+/**
+ * @brief Large pipe buffer size used by pipe_test().
+ */
+#define PIPE_TEST_BUFSIZE 0x10000
+
+/**
+ * @brief Sends data from a child process through a pipe.
+ *
+ * @param bufsize Pipe buffer size (zero for default).
+ *
+ * @returns Upon successful completion, the elapsed time in ticks is returned.
+ *          Upon failure, -1 is returned instead.
+ */
+static int pipe_bandwidth(int bufsize)
+{
+	int fd[2];                           /* Pipe.               */
+	pid_t pid;                           /* Child process ID.   */
+	ssize_t n;                           /* Bytes transferred.  */
+	size_t total;                        /* Total bytes.        */
+	clock_t t0, t1;                      /* Elapsed times.      */
+	struct tms timing;                   /* Timing information. */
+	static char buffer[PIPE_TEST_CHUNK]; /* Transfer buffer.    */
+
+	if (pipe(fd) < 0)
+		return (-1);
+
+	/* Resize pipe buffer. */
+	if ((bufsize > 0) && (fcntl(fd[1], F_SETPIPE_SZ, bufsize) != bufsize))
+		goto error;
+
+	t0 = times(&timing);
+
+	if ((pid = fork()) < 0)
+		goto error;
+
+	/* Writer. */
+	if (pid == 0)
+	{
+		close(fd[0]);
+		memset(buffer, 1, sizeof(buffer));
+		for (total = 0; total < PIPE_TEST_SIZE; total += n)
+		{
+			if ((n = write(fd[1], buffer, sizeof(buffer))) <= 0)
+				_exit(EXIT_FAILURE);
+		}
+		_exit(EXIT_SUCCESS);
+	}
+
+	/* Reader. */
+	close(fd[1]);
+	total = 0;
+	while ((n = read(fd[0], buffer, sizeof(buffer))) > 0)
+		total += n;
+	close(fd[0]);
+	wait(NULL);
+
+	t1 = times(&timing);
+
+	return ((total == PIPE_TEST_SIZE) ? (int)(t1 - t0) : -1);
+
+error:
+	close(fd[0]);
+	close(fd[1]);
+	return (-1);
+}
+
+/**
+ * @brief Pipe bandwidth test.
+ *
+ * @details Sends data through a pipe with the default buffer size and with
+ *          a larger buffer, and compares their throughput.
+ *
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+static int pipe_test(void)
+{
+	int t1, t2; /* Elapsed times. */
+
+	if ((t1 = pipe_bandwidth(0)) < 0)
+		return (-1);
+	if ((t2 = pipe_bandwidth(PIPE_TEST_BUFSIZE)) < 0)
+		return (-1);
+
+	/* Print timing statistics. */
+	if (flags & VERBOSE)
+	{
+		printf("  default buffer: %d ticks for %d bytes\n",
+			t1, PIPE_TEST_SIZE);
+		printf("  %d-byte buffer: %d ticks for %d bytes\n",
+			PIPE_TEST_BUFSIZE, t2, PIPE_TEST_SIZE);
+	}
+
+	return (0);
+}
+
+/*============================================================================*
+ *                              forkstorm_test                                *
+ *============================================================================*/
+
+/**
+ * @brief Largest number of children alive at once in forkstorm_test().
+ */
+#define FORKSTORM_NR_PROCS 96
+
+/**
+ * @brief Forks many children, kills them and reaps them.
+ *
+ * @param nprocs Number of children.
+ *
+ * @returns Upon successful completion, the elapsed time in ticks is returned.
+ *          Upon failure, -1 is returned instead.
+ */
+static int forkstorm(int nprocs)
+{
+	int n;                                 /* Children forked.    */
+	clock_t t0, t1;                        /* Elapsed times.      */
+	struct tms timing;                     /* Timing information. */
+	static pid_t pids[FORKSTORM_NR_PROCS]; /* Children IDs.       */
+
+	t0 = times(&timing);
+
+	/* Fork children. */
+	for (n = 0; n < nprocs; n++)
+	{
+		if ((pids[n] = fork()) < 0)
+			break;
+
+		/* Child process. */
+		if (pids[n] == 0)
+		{
+			pause();
+			_exit(EXIT_SUCCESS);
+		}
+	}
+
+	/* Kill and reap children. */
+	for (int i = 0; i < n; i++)
+		kill(pids[i], SIGTERM);
+	for (int i = 0; i < n; i++)
+	{
+		if (wait(NULL) < 0)
+			return (-1);
+	}
+
+	t1 = times(&timing);
+
+	return ((n == nprocs) ? (int)(t1 - t0) : -1);
+}
+
+/**
+ * @brief Fork storm test.
+ *
+ * @details Forks, signals and reaps increasingly large batches of children,
+ *          so that the cost per child can be compared across batch sizes.
+ *
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+static int forkstorm_test(void)
+{
+	int t; /* Elapsed time. */
+
+	for (int nprocs = FORKSTORM_NR_PROCS/4; nprocs <= FORKSTORM_NR_PROCS; nprocs *= 2)
+	{
+		if ((t = forkstorm(nprocs)) < 0)
+			return (-1);
+
+		/* Print timing statistics. */
+		if (flags & VERBOSE)
+			printf("  %d children: %d ticks\n", nprocs, t);
+	}
+
+	return (0);
+}
+
+/*============================================================================*
+ *                                clock_test                                  *
+ *============================================================================*/
+
+/**
+ * @brief Number of clock samples taken by clock_test().
+ */
+#define CLOCK_TEST_NR_SAMPLES 1000
+
+/**
+ * @brief Interval slept by clock_test() (in nanoseconds).
+ */
+#define CLOCK_TEST_SLEEP 50000000
+
+/**
+ * @brief Oversleep tolerated by clock_test() (in nanoseconds).
+ */
+#define CLOCK_TEST_SLACK 30000000
+
+/**
+ * @brief Returns a time in nanoseconds.
+ */
+#define TS_TO_NS(ts) \
+	((long long)(ts).tv_sec*1000000000 + (ts).tv_nsec)
+
+/**
+ * @brief High-resolution clock test.
+ *
+ * @details Checks that the monotonic clock never goes backwards, that
+ *          nanosleep() sleeps at least for the requested interval, and not
+ *          much longer even if a busy process competes for the processor,
+ *          and that the process CPU time clock advances.
+ *
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+static int clock_test(void)
+{
+	long long t0, t1;      /* Samples.              */
+	long long resolution;  /* Smallest step.        */
+	long long slept;       /* Time slept.           */
+	long long busy;        /* Time slept with load. */
+	pid_t pid;             /* Busy process.         */
+	struct timespec ts;    /* Working time.         */
+	struct timespec req;   /* Requested interval.   */
+	volatile unsigned x;   /* Busy work.            */
+
+	/* Monotonicity. */
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) < 0)
+		return (-1);
+	t0 = TS_TO_NS(ts);
+	resolution = 0;
+	for (int i = 0; i < CLOCK_TEST_NR_SAMPLES; i++)
+	{
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		t1 = TS_TO_NS(ts);
+
+		/* Clock went backwards. */
+		if (t1 < t0)
+			return (-1);
+
+		if ((t1 > t0) && ((resolution == 0) || (t1 - t0 < resolution)))
+			resolution = t1 - t0;
+		t0 = t1;
+	}
+
+	/* Sleep. */
+	req.tv_sec = 0;
+	req.tv_nsec = CLOCK_TEST_SLEEP;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	t0 = TS_TO_NS(ts);
+	if (nanosleep(&req, NULL) < 0)
+		return (-1);
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	slept = TS_TO_NS(ts) - t0;
+	if (slept < CLOCK_TEST_SLEEP)
+		return (-1);
+
+	/* Sleep while a busy process runs. */
+	if ((pid = fork()) < 0)
+		return (-1);
+	if (pid == 0)
+	{
+		while (1)
+			/* noop */ ;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	t0 = TS_TO_NS(ts);
+	nanosleep(&req, NULL);
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	busy = TS_TO_NS(ts) - t0;
+	kill(pid, SIGKILL);
+	wait(NULL);
+	if ((busy < CLOCK_TEST_SLEEP) || (busy > CLOCK_TEST_SLEEP + CLOCK_TEST_SLACK))
+		return (-1);
+
+	/* CPU time. */
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+	t0 = TS_TO_NS(ts);
+	for (x = 0; x < 1000000; x++)
+		/* noop */ ;
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+	if (TS_TO_NS(ts) <= t0)
+		return (-1);
+
+	/* Print timing statistics. */
+	if (flags & VERBOSE)
+	{
+		printf("  clock resolution: %d ns\n", (int)resolution);
+		printf("  slept:            %d ns for %d ns\n",
+			(int)slept, CLOCK_TEST_SLEEP);
+		printf("  slept with load:  %d ns for %d ns\n",
+			(int)busy, CLOCK_TEST_SLEEP);
+		printf("  busy loop:        %d ns of cpu time\n",
+			(int)(TS_TO_NS(ts) - t0));
+	}
+
+	return (0);
+}
+
+/*============================================================================*
+ *                               syscall_test                                 *
+ *============================================================================*/
+
+/**
+ * @brief Number of system calls issued by syscall_test() (log 2).
+ */
+#define SYSCALL_TEST_LOG_NR_CALLS 16
+
+/**
+ * @brief Issues a null system call through the C library entry.
+ */
+static pid_t getpid_sysentry(void)
+{
+	pid_t pid;
+
+	__asm__ volatile (
+		"call *__sysentry"
+		: "=a" (pid)
+		: "0" (NR_getpid)
+	);
+
+	return (pid);
+}
+
+/**
+ * @brief Issues a null system call through a software interrupt.
+ */
+static pid_t getpid_int(void)
+{
+	pid_t pid;
+
+	__asm__ volatile (
+		"int $0x80"
+		: "=a" (pid)
+		: "0" (NR_getpid)
+	);
+
+	return (pid);
+}
+
+/**
+ * @brief Measures the latency of a null system call.
+ *
+ * @param call System call to measure.
+ *
+ * @returns The average latency of @p call in nanoseconds, or a negative
+ *          number upon failure.
+ */
+static long long syscall_latency(pid_t (*call)(void))
+{
+	long long t0, t1;   /* Samples.      */
+	struct timespec ts; /* Working time. */
+	pid_t pid;          /* Our ID.       */
+
+	pid = getpid();
+
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) < 0)
+		return (-1);
+	t0 = TS_TO_NS(ts);
+
+	for (int i = 0; i < (1 << SYSCALL_TEST_LOG_NR_CALLS); i++)
+	{
+		if (call() != pid)
+			return (-1);
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	t1 = TS_TO_NS(ts);
+
+	return ((t1 - t0) >> SYSCALL_TEST_LOG_NR_CALLS);
+}
+
+/**
+ * @brief Null system call latency test.
+ *
+ * @details Times the getpid() system call through the entry selected by the
+ *          C library and through int $0x80, as lmbench's lat_syscall null
+ *          does, and getpid() itself, which reads the vDSO data page.
+ *
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+static int syscall_test(void)
+{
+	long long lat_entry; /* Latency through the C library. */
+	long long lat_int;   /* Latency through int $0x80.     */
+	long long lat_vdso;  /* Latency through the vDSO.      */
+
+	if ((lat_entry = syscall_latency(getpid_sysentry)) < 0)
+		return (-1);
+	if ((lat_int = syscall_latency(getpid_int)) < 0)
+		return (-1);
+	if ((lat_vdso = syscall_latency(getpid)) < 0)
+		return (-1);
+
+	/* Print timing statistics. */
+	if (flags & VERBOSE)
+	{
+		printf("  libc entry: %d ns\n", (int)lat_entry);
+		printf("  int $0x80:  %d ns\n", (int)lat_int);
+		printf("  vdso:       %d ns\n", (int)lat_vdso);
+	}
+
+	return (0);
+}
+
 /*============================================================================*
  *                             Semaphores Test                                *
  *============================================================================*/
 
 /**
- * @brief Creates a semaphore.
+ * @brief Creates a semaphore.
+ */
+#define SEM_CREATE(a, b) \
+	(assert(((a) = semget((b), 1, IPC_CREAT | S_IRUSR | S_IWUSR)) >= 0))
+
+/**
+ * @brief Initializes a semaphore.
+ */
+#define SEM_INIT(a, b) (assert(semctl((a), 0, SETVAL, (b)) == 0))
+
+/**
+ * @brief Destroys a semaphore.
+ */
+#define SEM_DESTROY(x) (assert(semctl((x), 0, IPC_RMID) == 0))
+
+/**
+ * @brief Ups a semaphore.
+ */
+#define SEM_UP(x) (assert(semop((x), &(struct sembuf){0, 1, 0}, 1) == 0))
+
+/**
+ * @brief Downs a semaphore.
+ */
+#define SEM_DOWN(x) (assert(semop((x), &(struct sembuf){0, -1, 0}, 1) == 0))
+
+/**
+ * @brief Puts an item in a buffer.
+ */
+#define PUT_ITEM(a, b)                                \
+{                                                     \
+	assert(lseek((a), 0, SEEK_SET) != -1);            \
+	assert(write((a), &(b), sizeof(b)) == sizeof(b)); \
+}                                                     \
+
+/**
+ * @brief Gets an item from a buffer.
+ */
+#define GET_ITEM(a, b)                               \
+{                                                    \
+	assert(lseek((a), 0, SEEK_SET) != -1);           \
+	assert(read((a), &(b), sizeof(b)) == sizeof(b)); \
+}                                                    \
+
+/**
+ * @brief Producer-Consumer problem with semaphores.
+ *
+ * @details Reproduces consumer-producer scenario using semaphores.
+ *
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+int semaphore_test3(void)
+{
+	pid_t pid;                  /* Process ID.              */
+	int buffer_fd;              /* Buffer file descriptor.  */
+	int empty;                  /* Empty positions.         */
+	int full;                   /* Full positions.          */
+	int mutex;                  /* Mutex.                   */
+	const int BUFFER_SIZE = 32; /* Buffer size.             */
+	const int NR_ITEMS = 512;   /* Number of items to send. */
+
+	/* Create buffer.*/
+	buffer_fd = open("buffer", O_RDWR | O_CREAT, S_IRUSR | S_IWUSR);
+	if (buffer_fd < 0)
+		return (-1);
+
+	/* Create semaphores. */
+	SEM_CREATE(mutex, 1);
+	SEM_CREATE(empty, 2);
+	SEM_CREATE(full, 3);
+
+	/* Initialize semaphores. */
+	SEM_INIT(full, 0);
+	SEM_INIT(empty, BUFFER_SIZE);
+	SEM_INIT(mutex, 1);
+
+	if ((pid = fork()) < 0)
+		return (-1);
+
+	/* Producer. */
+	else if (pid == 0)
+	{
+		for (int item = 0; item < NR_ITEMS; item++)
+		{
+			SEM_DOWN(empty);
+			SEM_DOWN(mutex);
+
+			PUT_ITEM(buffer_fd, item);
+
+			SEM_UP(mutex);
+			SEM_UP(full);
+		}
+
+		_exit(EXIT_SUCCESS);
+	}
+
+	/* Consumer. */
+	else
+	{
+		int item;
+
+		do
+		{
+			SEM_DOWN(full);
+			SEM_DOWN(mutex);
+
+			GET_ITEM(buffer_fd, item);
+
+			SEM_UP(mutex);
+			SEM_UP(empty);
+		} while (item != (NR_ITEMS - 1));
+	}
+
+	/* Destroy semaphores. */
+	SEM_DESTROY(mutex);
+	SEM_DESTROY(empty);
+	SEM_DESTROY(full);
+
+	close(buffer_fd);
+	unlink("buffer");
+
+	return (0);
+}
+
+/**
+ * @brief Number of slots in the shared ring buffer.
+ */
+#define RING_NR_SLOTS 8
+
+/**
+ * @brief Size of a slot in the shared ring buffer.
+ */
+#define RING_SLOT_SIZE 4096
+
+/**
+ * @brief Number of slots sent through the shared ring buffer.
+ */
+#define RING_NR_ITEMS 256
+
+/**
+ * @brief Zero-copy Producer-Consumer problem with shared memory.
+ *
+ * @details Reproduces consumer-producer scenario on a ring buffer that lives
+ *          in a shared memory segment. The producer fills slots in place, the
+ *          consumer checks them in place, and semaphores count empty and
+ *          full slots.
+ *
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+int semaphore_test4(void)
+{
+	int ret;           /* Return value.        */
+	pid_t pid;         /* Process ID.          */
+	int shmid;         /* Segment ID.          */
+	char *ring;        /* Ring buffer.         */
+	char *slot;        /* Working slot.        */
+	int empty;         /* Empty slots.         */
+	int full;          /* Full slots.          */
+	clock_t t0, t1;    /* Elapsed times.       */
+	struct tms timing; /* Timing information.  */
+
+	/* Create ring buffer. */
+	shmid = shmget(IPC_PRIVATE, RING_NR_SLOTS*RING_SLOT_SIZE,
+		IPC_CREAT | S_IRUSR | S_IWUSR);
+	if (shmid < 0)
+		return (-1);
+	if ((ring = shmat(shmid, NULL, 0)) == (void *) -1)
+		return (-1);
+
+	/* Segment goes away on last detach. */
+	if (shmctl(shmid, IPC_RMID, NULL) < 0)
+		return (-1);
+
+	/* Create semaphores. */
+	SEM_CREATE(empty, 4);
+	SEM_CREATE(full, 5);
+
+	/* Initialize semaphores. */
+	SEM_INIT(full, 0);
+	SEM_INIT(empty, RING_NR_SLOTS);
+
+	t0 = times(&timing);
+
+	if ((pid = fork()) < 0)
+		return (-1);
+
+	/* Producer. */
+	else if (pid == 0)
+	{
+		for (int item = 0; item < RING_NR_ITEMS; item++)
+		{
+			slot = &ring[(item%RING_NR_SLOTS)*RING_SLOT_SIZE];
+
+			SEM_DOWN(empty);
+			memset(slot, item, RING_SLOT_SIZE);
+			SEM_UP(full);
+		}
+
+		_exit(EXIT_SUCCESS);
+	}
+
+	/* Consumer. */
+	ret = 0;
+	for (int item = 0; item < RING_NR_ITEMS; item++)
+	{
+		slot = &ring[(item%RING_NR_SLOTS)*RING_SLOT_SIZE];
+
+		SEM_DOWN(full);
+		if ((slot[0] != (char)item) || (slot[RING_SLOT_SIZE - 1] != (char)item))
+			ret = -1;
+		SEM_UP(empty);
+	}
+
+	wait(NULL);
+
+	t1 = times(&timing);
+
+	/* Destroy semaphores. */
+	SEM_DESTROY(empty);
+	SEM_DESTROY(full);
+
+	if (shmdt(ring) < 0)
+		return (-1);
+
+	/* Print timing statistics. */
+	if (flags & VERBOSE)
+	{
+		printf("  %d bytes in %d ticks\n",
+			RING_NR_ITEMS*RING_SLOT_SIZE, t1 - t0);
+	}
+
+	return (ret);
+}
+
+/**
+ * @name Semaphores of the set used by semaphore_test5()
+ */
+/**@{*/
+#define SET_MUTEX 0 /**< Mutex.           */
+#define SET_EMPTY 1 /**< Empty positions. */
+#define SET_FULL  2 /**< Full positions.  */
+/**@}*/
+
+/**
+ * @brief Producer-Consumer problem with a semaphore set.
+ *
+ * @details Reproduces the scenario of semaphore_test3(), but with the three
+ *          semaphores in a single set, so that each side acquires and
+ *          releases them with one semop() call. Then checks that blocked
+ *          operations are rolled back, that semtimedop() times out, that
+ *          SEM_UNDO adjustments are applied on exit, and that removing the
+ *          set wakes up sleeping processes.
+ *
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+int semaphore_test5(void)
+{
+	int ret;                    /* Return value.            */
+	int status;                 /* Child exit status.       */
+	pid_t pid;                  /* Process ID.              */
+	int set;                    /* Semaphore set.           */
+	int item;                   /* Working item.            */
+	int buffer_fd;              /* Buffer file descriptor.  */
+	struct timespec ts;         /* Timeout.                 */
+	const int BUFFER_SIZE = 32; /* Buffer size.             */
+	const int NR_ITEMS = 512;   /* Number of items to send. */
+	unsigned short vals[3];     /* Initial values.          */
+	struct sembuf take[2] = {{SET_EMPTY, -1, 0}, {SET_MUTEX, -1, 0}};
+	struct sembuf put[2] = {{SET_MUTEX, 1, 0}, {SET_FULL, 1, 0}};
+	struct sembuf get[2] = {{SET_FULL, -1, 0}, {SET_MUTEX, -1, 0}};
+	struct sembuf give[2] = {{SET_MUTEX, 1, 0}, {SET_EMPTY, 1, 0}};
+	struct sembuf lock = {SET_MUTEX, -1, IPC_NOWAIT | SEM_UNDO};
+
+	/* Create buffer.*/
+	buffer_fd = open("buffer", O_RDWR | O_CREAT, S_IRUSR | S_IWUSR);
+	if (buffer_fd < 0)
+		return (-1);
+
+	/* Create semaphores. */
+	set = semget(IPC_PRIVATE, 3, IPC_CREAT | S_IRUSR | S_IWUSR);
+	assert(set >= 0);
+
+	/* Initialize semaphores. */
+	vals[SET_MUTEX] = 1;
+	vals[SET_EMPTY] = BUFFER_SIZE;
+	vals[SET_FULL] = 0;
+	assert(semctl(set, 0, SETALL, vals) == 0);
+
+	if ((pid = fork()) < 0)
+		return (-1);
+
+	/* Producer. */
+	else if (pid == 0)
+	{
+		for (item = 0; item < NR_ITEMS; item++)
+		{
+			assert(semop(set, take, 2) == 0);
+			PUT_ITEM(buffer_fd, item);
+			assert(semop(set, put, 2) == 0);
+		}
+
+		_exit(EXIT_SUCCESS);
+	}
+
+	/* Consumer. */
+	do
+	{
+		assert(semop(set, get, 2) == 0);
+		GET_ITEM(buffer_fd, item);
+		assert(semop(set, give, 2) == 0);
+	} while (item != (NR_ITEMS - 1));
+
+	wait(NULL);
+
+	ret = 0;
+
+	/* Blocking operation is rolled back. */
+	get[0].sem_flg = IPC_NOWAIT;
+	if ((semop(set, get, 2) == 0) || (errno != EAGAIN))
+		ret = -1;
+	if (semctl(set, SET_MUTEX, GETVAL) != 1)
+		ret = -1;
+
+	/* Blocking operation times out. */
+	get[0].sem_flg = 0;
+	ts.tv_sec = 0;
+	ts.tv_nsec = 50000000;
+	if ((semtimedop(set, get, 2, &ts) == 0) || (errno != EAGAIN))
+		ret = -1;
+
+	/* Child exits holding the mutex. */
+	if ((pid = fork()) < 0)
+		return (-1);
+	else if (pid == 0)
+		_exit((semop(set, &lock, 1) == 0) ? EXIT_SUCCESS : EXIT_FAILURE);
+	wait(&status);
+	if ((!WIFEXITED(status)) || (WEXITSTATUS(status) != EXIT_SUCCESS))
+		ret = -1;
+	if (semctl(set, SET_MUTEX, GETVAL) != 1)
+		ret = -1;
+
+	/* Child sleeps on the set until it is removed. */
+	if ((pid = fork()) < 0)
+		return (-1);
+	else if (pid == 0)
+	{
+		ret = ((semop(set, get, 2) < 0) && (errno == EIDRM));
+		_exit((ret) ? EXIT_SUCCESS : EXIT_FAILURE);
+	}
+	ts.tv_nsec = 50000000;
+	nanosleep(&ts, NULL);
+	if (semctl(set, SET_FULL, GETNCNT) != 1)
+		ret = -1;
+
+	/* Destroy semaphores. */
+	assert(semctl(set, 0, IPC_RMID) == 0);
+
+	wait(&status);
+	if ((!WIFEXITED(status)) || (WEXITSTATUS(status) != EXIT_SUCCESS))
+		ret = -1;
+
+	close(buffer_fd);
+	unlink("buffer");
+
+	return (ret);
+}
+
+/**
+ * @brief Size of the segment used by shm_test().
+ */
+#define SHM_TEST_SIZE 4096
+
+/**
+ * @brief Read-only shared memory attach test.
+ *
+ * @details Attaches a segment read-only in a child process and checks that
+ *          the child sees the contents written by the parent, but is killed
+ *          when it writes to the segment itself. Then checks that shmdt()
+ *          refuses memory maps that are not shared memory segments.
+ *
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+int shm_test(void)
+{
+	int ret;               /* Return value.     */
+	pid_t pid;             /* Process ID.       */
+	int shmid;             /* Segment ID.       */
+	int status;            /* Child status.     */
+	char *seg;             /* Segment.          */
+	volatile char *rdonly; /* Read-only attach. */
+	void *p;               /* Memory map.       */
+
+	shmid = shmget(IPC_PRIVATE, SHM_TEST_SIZE, IPC_CREAT | S_IRUSR | S_IWUSR);
+	if (shmid < 0)
+		return (-1);
+	if ((seg = shmat(shmid, NULL, 0)) == (void *) -1)
+		return (-1);
+	seg[0] = 'x';
+
+	if ((pid = fork()) < 0)
+		return (-1);
+
+	/* Writes to a read-only attach. */
+	if (pid == 0)
+	{
+		if ((rdonly = shmat(shmid, NULL, SHM_RDONLY)) == (void *) -1)
+			_exit(EXIT_FAILURE);
+		if (rdonly[0] != 'x')
+			_exit(EXIT_FAILURE);
+
+		rdonly[0] = 'y';
+
+		_exit(EXIT_FAILURE);
+	}
+
+	wait(&status);
+
+	ret = 0;
+	if ((!WIFSIGNALED(status)) || (WTERMSIG(status) != SIGSEGV))
+		ret = -1;
+	if (seg[0] != 'x')
+		ret = -1;
+
+	shmdt(seg);
+	shmctl(shmid, IPC_RMID, NULL);
+
+	/* Not a shared memory segment. */
+	p = mmap(NULL, SHM_TEST_SIZE, PROT_READ | PROT_WRITE,
+		MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (p == MAP_FAILED)
+		return (-1);
+	if ((shmdt(p) == 0) || (errno != EINVAL))
+		ret = -1;
+	munmap(p, SHM_TEST_SIZE);
+
+	return (ret);
+}
+
+/*============================================================================*
+ *                                Futex Test                                  *
+ *============================================================================*/
+
+/**
+ * @brief Number of critical sections entered by each process (log 2).
+ */
+#define FUTEX_TEST_LOG_NR_OPS 14
+
+/**
+ * @brief Shared state of futex_test().
+ */
+struct futex_test_data
+{
+	pthread_mutex_t mutex; /**< Mutex under test.        */
+	int counter;           /**< Counter that is guarded. */
+};
+
+/**
+ * @brief Enters critical sections guarded by a futex-based mutex.
+ *
+ * @param data Shared state.
+ */
+static void futex_test_mutex(struct futex_test_data *data)
+{
+	for (int i = 0; i < (1 << FUTEX_TEST_LOG_NR_OPS); i++)
+	{
+		pthread_mutex_lock(&data->mutex);
+		data->counter++;
+		pthread_mutex_unlock(&data->mutex);
+	}
+}
+
+/**
+ * @brief Enters critical sections guarded by a semaphore.
+ *
+ * @param data Shared state.
+ * @param sem  Semaphore.
+ */
+static void futex_test_sem(struct futex_test_data *data, int sem)
+{
+	for (int i = 0; i < (1 << FUTEX_TEST_LOG_NR_OPS); i++)
+	{
+		SEM_DOWN(sem);
+		data->counter++;
+		SEM_UP(sem);
+	}
+}
+
+/**
+ * @brief Times critical sections, with and without contention.
+ *
+ * @param data       Shared state.
+ * @param sem        Semaphore to use, or -1 to use the mutex.
+ * @param contention Run two processes instead of one?
+ *
+ * @returns The average time of a critical section in nanoseconds, or a
+ *          negative number upon failure.
+ */
+static long long futex_test_run(struct futex_test_data *data, int sem, int contention)
+{
+	pid_t pid;          /* Child process.  */
+	long long t0, t1;   /* Samples.        */
+	struct timespec ts; /* Working time.   */
+	int nops;           /* Expected count. */
+
+	data->counter = 0;
+	nops = (contention) ? (2 << FUTEX_TEST_LOG_NR_OPS) :
+		(1 << FUTEX_TEST_LOG_NR_OPS);
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	t0 = TS_TO_NS(ts);
+
+	pid = 0;
+	if ((contention) && ((pid = fork()) < 0))
+		return (-1);
+
+	if (sem < 0)
+		futex_test_mutex(data);
+	else
+		futex_test_sem(data, sem);
+
+	if (contention)
+	{
+		if (pid == 0)
+			_exit(EXIT_SUCCESS);
+		wait(NULL);
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	t1 = TS_TO_NS(ts);
+
+	/* Lost update. */
+	if (data->counter != nops)
+		return (-1);
+
+	return ((t1 - t0) >> FUTEX_TEST_LOG_NR_OPS);
+}
+
+/**
+ * @brief Futex-based mutex test.
+ *
+ * @details Increments a counter in a shared memory segment under a mutex and
+ *          under a semaphore, first in a single process and then in two
+ *          processes that contend for it, and checks that no update is lost.
+ *
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+static int futex_test(void)
+{
+	int sem;                      /* Semaphore.     */
+	int shmid;                    /* Segment ID.    */
+	struct futex_test_data *data; /* Shared state.  */
+	long long lat[4];             /* Latencies.     */
+
+	/* Create shared state. */
+	shmid = shmget(IPC_PRIVATE, sizeof(struct futex_test_data),
+		IPC_CREAT | S_IRUSR | S_IWUSR);
+	if (shmid < 0)
+		return (-1);
+	if ((data = shmat(shmid, NULL, 0)) == (void *) -1)
+		return (-1);
+	if (shmctl(shmid, IPC_RMID, NULL) < 0)
+		return (-1);
+
+	pthread_mutex_init(&data->mutex, NULL);
+	SEM_CREATE(sem, 6);
+	SEM_INIT(sem, 1);
+
+	lat[0] = futex_test_run(data, -1, 0);
+	lat[1] = futex_test_run(data, sem, 0);
+	lat[2] = futex_test_run(data, -1, 1);
+	lat[3] = futex_test_run(data, sem, 1);
+
+	SEM_DESTROY(sem);
+	if (shmdt(data) < 0)
+		return (-1);
+
+	for (int i = 0; i < 4; i++)
+	{
+		if (lat[i] < 0)
+			return (-1);
+	}
+
+	/* Print timing statistics. */
+	if (flags & VERBOSE)
+	{
+		printf("  uncontended mutex:     %d ns\n", (int)lat[0]);
+		printf("  uncontended semaphore: %d ns\n", (int)lat[1]);
+		printf("  contended mutex:       %d ns\n", (int)lat[2]);
+		printf("  contended semaphore:   %d ns\n", (int)lat[3]);
+	}
+
+	return (0);
+}
+
+
+/*============================================================================*
+ *                               Thread Test                                  *
+ *============================================================================*/
+
+/**
+ * @brief Number of threads to spawn.
+ */
+#define THREAD_TEST_NR_THREADS 8
+
+/**
+ * @brief Shared state of thread test.
+ */
+static struct futex_test_data thread_test_data = {
+	PTHREAD_MUTEX_INITIALIZER, 0
+};
+
+/**
+ * @brief Increments the shared counter.
+ *
+ * @param arg Value to return.
+ *
+ * @returns @p arg.
+ */
+static void *thread_test_worker(void *arg)
+{
+	futex_test_mutex(&thread_test_data);
+
+	return (arg);
+}
+
+/**
+ * @brief Progress of errno check of thread test.
+ */
+static volatile int thread_test_step = 0;
+
+/**
+ * @brief Sets errno, and checks that it survives an error in another thread.
+ *
+ * @param arg Value to return.
+ *
+ * @returns @p arg if errno was kept, and NULL otherwise.
+ */
+static void *thread_test_errno(void *arg)
+{
+	struct timespec tick = { 0, 10000000 };
+
+	close(-1);
+	thread_test_step = 1;
+
+	/* Wait for the other thread to fail. */
+	while (thread_test_step != 2)
+		nanosleep(&tick, NULL);
+
+	return ((errno == EBADF) ? arg : NULL);
+}
+
+/**
+ * @brief Thread test.
+ *
+ * @details Spawns threads that increment a counter in ordinary data under a
+ *          mutex, joins them, and checks both the counter and the values
+ *          they returned. Then checks that errors in one thread do not
+ *          change errno in another. The spawn time is compared to that of
+ *          fork().
+ *
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+static int thread_test(void)
+{
+	pthread_t tids[THREAD_TEST_NR_THREADS]; /* Threads.       */
+	pid_t pid;                              /* Child process. */
+	void *ret;                              /* Return value.  */
+	long long t0, t1, t2;                   /* Samples.       */
+	struct timespec ts;                     /* Working time.  */
+	struct timespec tick = { 0, 10000000 }; /* Polling delay. */
+	int err;                                /* Error number.  */
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	t0 = TS_TO_NS(ts);
+
+	for (int i = 0; i < THREAD_TEST_NR_THREADS; i++)
+	{
+		if (pthread_create(&tids[i], NULL, thread_test_worker, &tids[i]))
+			return (-1);
+	}
+
+	for (int i = 0; i < THREAD_TEST_NR_THREADS; i++)
+	{
+		if (pthread_join(tids[i], &ret))
+			return (-1);
+
+		/* Wrong return value. */
+		if (ret != &tids[i])
+			return (-1);
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	t1 = TS_TO_NS(ts);
+
+	/* Lost update. */
+	if (thread_test_data.counter !=
+		(THREAD_TEST_NR_THREADS << FUTEX_TEST_LOG_NR_OPS))
+		return (-1);
+
+	/* Per-thread errno. */
+	thread_test_step = 0;
+	if (pthread_create(&tids[0], NULL, thread_test_errno, &tids[0]))
+		return (-1);
+	while (thread_test_step != 1)
+		nanosleep(&tick, NULL);
+	open("/nonexistent", O_RDONLY);
+	err = errno;
+	thread_test_step = 2;
+	if (pthread_join(tids[0], &ret))
+		return (-1);
+	if ((ret != &tids[0]) || (err != ENOENT))
+		return (-1);
+
+	/* Same work with processes, for comparison. */
+	thread_test_data.counter = 0;
+	for (int i = 0; i < THREAD_TEST_NR_THREADS; i++)
+	{
+		if ((pid = fork()) < 0)
+			return (-1);
+
+		if (pid == 0)
+		{
+			thread_test_worker(NULL);
+			_exit(EXIT_SUCCESS);
+		}
+	}
+	for (int i = 0; i < THREAD_TEST_NR_THREADS; i++)
+		wait(NULL);
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	t2 = TS_TO_NS(ts);
+
+	/* Print timing statistics. */
+	if (flags & VERBOSE)
+	{
+		printf("  pthread_create+join: %d ns for %d threads\n",
+			(int)(t1 - t0), THREAD_TEST_NR_THREADS);
+		printf("  fork+wait:           %d ns for %d processes\n",
+			(int)(t2 - t1), THREAD_TEST_NR_THREADS);
+	}
+
+	return (0);
+}
+
+
+/*============================================================================*
+ *                               malloc test                                  *
+ *============================================================================*/
+
+/**
+ * @brief Number of live objects in malloc test.
+ */
+#define MALLOC_TEST_NR_OBJS 256
+
+/**
+ * @brief Number of operations in malloc test.
+ */
+#define MALLOC_TEST_NR_OPS 16384
+
+/**
+ * @brief Largest object size in malloc test.
+ */
+#define MALLOC_TEST_MAX_SIZE 1024
+
+/**
+ * @brief Number of realloc() steps in malloc test.
+ */
+#define MALLOC_TEST_NR_STEPS 4096
+
+/**
+ * @brief Generates a pseudo-random number for malloc test.
+ *
+ * @param seed Generator state.
+ *
+ * @returns A pseudo-random number.
+ */
+static unsigned malloc_test_rand(unsigned *seed)
+{
+	*seed = *seed*1103515245 + 12345;
+
+	return (*seed >> 16);
+}
+
+/**
+ * @brief malloc test.
+ *
+ * @details Allocates and frees objects of random sizes, filling each one with
+ *          a pattern that is checked when it is freed, and then grows a single
+ *          object one byte at a time with realloc(), as a string builder
+ *          would.
+ *
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+static int malloc_test(void)
+{
+	unsigned char *objs[MALLOC_TEST_NR_OBJS]; /* Live objects.   */
+	size_t sizes[MALLOC_TEST_NR_OBJS];        /* Object sizes.   */
+	unsigned char *p, *q;                     /* Working object. */
+	unsigned seed = 1;                        /* Random seed.    */
+	unsigned nmoves = 0;                      /* Moved objects.  */
+	long long t0, t1, t2;                     /* Samples.        */
+	struct timespec ts;                       /* Working time.   */
+	int ret = -1;                             /* Test result.    */
+
+	memset(objs, 0, sizeof(objs));
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	t0 = TS_TO_NS(ts);
+
+	/* Random allocations and frees. */
+	for (int i = 0; i < MALLOC_TEST_NR_OPS; i++)
+	{
+		int j = malloc_test_rand(&seed)%MALLOC_TEST_NR_OBJS;
+
+		/* Check and free. */
+		if (objs[j] != NULL)
+		{
+			for (size_t k = 0; k < sizes[j]; k++)
+			{
+				if (objs[j][k] != (unsigned char)(j + k))
+					goto out;
+			}
+
+			free(objs[j]);
+			objs[j] = NULL;
+			continue;
+		}
+
+		sizes[j] = malloc_test_rand(&seed)%MALLOC_TEST_MAX_SIZE + 1;
+		if ((objs[j] = malloc(sizes[j])) == NULL)
+			goto out;
+
+		for (size_t k = 0; k < sizes[j]; k++)
+			objs[j][k] = (unsigned char)(j + k);
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	t1 = TS_TO_NS(ts);
+
+	/* Grow an object one byte at a time. */
+	p = NULL;
+	for (int i = 0; i < MALLOC_TEST_NR_STEPS; i++)
+	{
+		if ((q = realloc(p, i + 1)) == NULL)
+		{
+			free(p);
+			goto out;
+		}
+
+		if ((p != NULL) && (q != p))
+			nmoves++;
+
+		p = q;
+		p[i] = (unsigned char)i;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	t2 = TS_TO_NS(ts);
+
+	/* Contents were lost. */
+	for (int i = 0; i < MALLOC_TEST_NR_STEPS; i++)
+	{
+		if (p[i] != (unsigned char)i)
+		{
+			free(p);
+			goto out;
+		}
+	}
+
+	free(p);
+
+	/* Print timing statistics. */
+	if (flags & VERBOSE)
+	{
+		printf("  malloc+free: %d ns for %d operations\n",
+			(int)(t1 - t0), MALLOC_TEST_NR_OPS);
+		printf("  realloc:     %d ns for %d steps, %d moves\n",
+			(int)(t2 - t1), MALLOC_TEST_NR_STEPS, nmoves);
+	}
+
+	ret = 0;
+
+out:
+	for (int i = 0; i < MALLOC_TEST_NR_OBJS; i++)
+		free(objs[i]);
+
+	return (ret);
+}
+
+/*============================================================================*
+ *                               string test                                  *
+ *============================================================================*/
+
+/**
+ * @brief Size of string test buffers.
+ */
+#define STRING_TEST_SIZE 640
+
+/**
+ * @brief Number of rounds in string test.
+ */
+#define STRING_TEST_NR_ROUNDS 4096
+
+/**
+ * @brief Buffers for string test.
+ */
+static unsigned char string_test_src[STRING_TEST_SIZE];
+static unsigned char string_test_dst[STRING_TEST_SIZE];
+static unsigned char string_test_ref[STRING_TEST_SIZE];
+
+/**
+ * @brief Reference memcpy().
+ */
+static void ref_memcpy(unsigned char *s1, const unsigned char *s2, size_t n)
+{
+	while (n-- > 0)
+		*s1++ = *s2++;
+}
+
+/**
+ * @brief Reference memset().
+ */
+static void ref_memset(unsigned char *s, int c, size_t n)
+{
+	while (n-- > 0)
+		*s++ = c;
+}
+
+/**
+ * @brief Reference strlen().
+ */
+static size_t ref_strlen(const unsigned char *s)
+{
+	size_t n = 0;
+
+	while (s[n] != '\0')
+		n++;
+
+	return (n);
+}
+
+/**
+ * @brief Reference memchr().
+ */
+static const void *ref_memchr(const unsigned char *s, int c, size_t n)
+{
+	for (size_t i = 0; i < n; i++)
+	{
+		if (s[i] == (unsigned char)c)
+			return (&s[i]);
+	}
+
+	return (NULL);
+}
+
+/**
+ * @brief Reference strcmp().
+ */
+static int ref_strcmp(const unsigned char *s1, const unsigned char *s2)
+{
+	while ((*s1 == *s2) && (*s1 != '\0'))
+	{
+		s1++;
+		s2++;
+	}
+
+	return (*s1 - *s2);
+}
+
+/**
+ * @brief Asserts if two integers have the same sign.
+ */
+#define SAME_SIGN(a, b) \
+	((((a) < 0) == ((b) < 0)) && (((a) > 0) == ((b) > 0)))
+
+/**
+ * @brief String test.
+ *
+ * @details Differential test of the word-at-a-time string routines of the C
+ *          library against plain byte loops, over random contents, lengths
+ *          and alignments. Every byte of the target buffers is checked, so
+ *          that writes out of bounds are caught as well.
+ *
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+static int string_test(void)
+{
+	unsigned seed = 1;                     /* Random seed.       */
+	unsigned char *src = string_test_src;  /* Source buffer.     */
+	unsigned char *dst = string_test_dst;  /* Target buffer.     */
+	unsigned char *ref = string_test_ref;  /* Reference buffer.  */
+
+	for (int i = 0; i < STRING_TEST_NR_ROUNDS; i++)
+	{
+		size_t so, doff, n; /* Offsets and length. */
+		int c;              /* Working byte.       */
+
+		so = malloc_test_rand(&seed)%8;
+		doff = malloc_test_rand(&seed)%8;
+		n = malloc_test_rand(&seed)%((i & 1) ? 64 : STRING_TEST_SIZE - 16);
+
+		/* Random contents, with a few zero bytes. */
+		for (int j = 0; j < STRING_TEST_SIZE; j++)
+		{
+			src[j] = (malloc_test_rand(&seed)%16) ?
+				malloc_test_rand(&seed) : 0;
+			dst[j] = ref[j] = malloc_test_rand(&seed);
+		}
+		src[STRING_TEST_SIZE - 1] = '\0';
+
+		/* memcpy(). */
+		memcpy(dst + doff, src + so, n);
+		ref_memcpy(ref + doff, src + so, n);
+		if (memcmp(dst, ref, STRING_TEST_SIZE))
+			return (-1);
+
+		/* memmove(), both directions. */
+		memmove(dst + doff, dst + so, n);
+		memmove(ref + doff, ref + so, n);
+		if (memcmp(dst, ref, STRING_TEST_SIZE))
+			return (-1);
+
+		/* memset(). */
+		c = malloc_test_rand(&seed);
+		memset(dst + doff, c, n);
+		ref_memset(ref + doff, c, n);
+		if (memcmp(dst, ref, STRING_TEST_SIZE))
+			return (-1);
+
+		/* strlen(). */
+		if (strlen((char *)src + so) != ref_strlen(src + so))
+			return (-1);
+
+		/* memchr(), for a byte that is likely to be found. */
+		c = src[so + malloc_test_rand(&seed)%(n + 1)] | ((i & 2) ? ~0xff : 0);
+		if (memchr(src + so, c, n) != ref_memchr(src + so, c, n))
+			return (-1);
+
+		/* strcmp(), with the same and different alignments. */
+		ref_memcpy(dst, src, STRING_TEST_SIZE);
+		if (i & 4)
+			dst[so + malloc_test_rand(&seed)%64] ^= 1 << (i%8);
+		if (!SAME_SIGN(strcmp((char *)src + so, (char *)dst + so),
+			ref_strcmp(src + so, dst + so)))
+			return (-1);
+		if (!SAME_SIGN(strcmp((char *)src + so, (char *)dst + doff),
+			ref_strcmp(src + so, dst + doff)))
+			return (-1);
+	}
+
+	return (0);
+}
+
+/*============================================================================*
+ *                                copy test                                   *
+ *============================================================================*/
+
+/**
+ * @brief Size of file copied by copy test.
+ *
+ * @details Close to the maximum file size of the root file system.
+ */
+#define COPY_TEST_SIZE 0x80000
+
+/**
+ * @brief Number of times that the file is copied in copy test.
+ */
+#define COPY_TEST_NR_COPIES 8
+
+/**
+ * @brief Source and target files of copy test.
+ */
+/**@{*/
+#define COPY_TEST_SRC "/copytest.src"
+#define COPY_TEST_DST "/copytest.dst"
+/**@}*/
+
+/**
+ * @brief Copies a file for copy test.
+ *
+ * @param in_kernel Use copy_file_range() instead of read() and write()?
+ *
+ * @returns Zero upon successful completion, and non-zero otherwise.
+ */
+static int copy_test_copy(int in_kernel)
+{
+	int fd1, fd2;           /* Files.         */
+	ssize_t n;              /* Bytes copied.  */
+	size_t total;           /* Total copied.  */
+	static char buf[1024];  /* Copy buffer.   */
+
+	if ((fd1 = open(COPY_TEST_SRC, O_RDONLY)) < 0)
+		return (-1);
+	if ((fd2 = open(COPY_TEST_DST, O_WRONLY | O_CREAT | O_TRUNC,
+		S_IRUSR | S_IWUSR)) < 0)
+	{
+		close(fd1);
+		return (-1);
+	}
+
+	total = 0;
+	do
+	{
+		/* Copy inside the kernel. */
+		if (in_kernel)
+			n = copy_file_range(fd1, NULL, fd2, NULL, COPY_TEST_SIZE, 0);
+
+		/* Shuttle data through a user buffer. */
+		else if ((n = read(fd1, buf, sizeof(buf))) > 0)
+		{
+			if (write(fd2, buf, n) != n)
+				n = -1;
+		}
+
+		total += (n > 0) ? n : 0;
+	} while (n > 0);
+
+	close(fd2);
+	close(fd1);
+
+	return ((n < 0) || (total != COPY_TEST_SIZE));
+}
+
+/**
+ * @brief Checks the target file of copy test.
+ *
+ * @returns Zero if the target file holds the expected data, and non-zero
+ *          otherwise.
+ */
+static int copy_test_check(void)
+{
+	int fd;                 /* Target file.  */
+	ssize_t n;              /* Bytes read.   */
+	size_t off;             /* File offset.  */
+	static char buf[1024];  /* Read buffer.  */
+
+	if ((fd = open(COPY_TEST_DST, O_RDONLY)) < 0)
+		return (-1);
+
+	for (off = 0; (n = read(fd, buf, sizeof(buf))) > 0; off += n)
+	{
+		for (ssize_t i = 0; i < n; i++)
+		{
+			if (buf[i] != (char)((off + i)%251))
+			{
+				close(fd);
+				return (-1);
+			}
+		}
+	}
+
+	close(fd);
+
+	return ((n < 0) || (off != COPY_TEST_SIZE));
+}
+
+/**
+ * @brief File copy test.
+ *
+ * @details Copies a large file a number of times, first with read() and
+ *          write() through a 1 KB buffer, as cp used to do, and then with
+ *          copy_file_range(), and compares their throughput.
+ *
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+static int copy_test(void)
+{
+	int fd;                /* Source file.   */
+	long long t0, t1, t2;  /* Samples.       */
+	struct timespec ts;    /* Working time.  */
+	static char buf[1024]; /* Write buffer.  */
+	int ret = -1;          /* Test result.   */
+
+	/* Create source file. */
+	if ((fd = open(COPY_TEST_SRC, O_WRONLY | O_CREAT | O_TRUNC,
+		S_IRUSR | S_IWUSR)) < 0)
+		return (-1);
+	for (size_t off = 0; off < COPY_TEST_SIZE; off += sizeof(buf))
+	{
+		for (size_t i = 0; i < sizeof(buf); i++)
+			buf[i] = (char)((off + i)%251);
+		if (write(fd, buf, sizeof(buf)) != sizeof(buf))
+		{
+			close(fd);
+			goto out;
+		}
+	}
+	close(fd);
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	t0 = TS_TO_NS(ts);
+
+	for (int i = 0; i < COPY_TEST_NR_COPIES; i++)
+	{
+		if (copy_test_copy(0))
+			goto out;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	t1 = TS_TO_NS(ts);
+
+	if (copy_test_check())
+		goto out;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	t2 = TS_TO_NS(ts);
+
+	for (int i = 0; i < COPY_TEST_NR_COPIES; i++)
+	{
+		if (copy_test_copy(1))
+			goto out;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	t2 = TS_TO_NS(ts) - t2;
+
+	if (copy_test_check())
+		goto out;
+
+	/* Print timing statistics. */
+	if (flags & VERBOSE)
+	{
+		printf("  read+write:      %d ns for %d bytes\n",
+			(int)(t1 - t0), COPY_TEST_SIZE*COPY_TEST_NR_COPIES);
+		printf("  copy_file_range: %d ns for %d bytes\n",
+			(int)t2, COPY_TEST_SIZE*COPY_TEST_NR_COPIES);
+	}
+
+	ret = 0;
+
+out:
+	unlink(COPY_TEST_DST);
+	unlink(COPY_TEST_SRC);
+	return (ret);
+}
+
+/*============================================================================*
+ *                               uio test                                     *
+ *============================================================================*/
+
+/**
+ * @brief Scratch file of uio test.
+ */
+#define UIO_TEST_FILE "/uiotest"
+
+/**
+ * @brief Positional and vectored I/O test.
+ *
+ * @details Gathers three buffers into a file with writev(), patches it with
+ *          pwrite(), and scatters it back with readv(), checking that
+ *          positional I/O leaves the file offset alone.
+ *
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+static int uio_test(void)
+{
+	int fd;                /* Scratch file.   */
+	struct iovec iov[3];   /* Buffers.        */
+	char a[4], b[8], c[4]; /* Read buffers.   */
+	char buf[16];          /* Working buffer. */
+	int ret = -1;          /* Test result.    */
+
+	if ((fd = open(UIO_TEST_FILE, O_RDWR | O_CREAT | O_TRUNC,
+		S_IRUSR | S_IWUSR)) < 0)
+		return (-1);
+
+	/* Gather. */
+	iov[0].iov_base = "abcd";     iov[0].iov_len = 4;
+	iov[1].iov_base = "efghijkl"; iov[1].iov_len = 8;
+	iov[2].iov_base = "mnop";     iov[2].iov_len = 4;
+	if (writev(fd, iov, 3) != 16)
+		goto out;
+
+	/* Positional write does not move the offset. */
+	if (pwrite(fd, "EF", 2, 4) != 2)
+		goto out;
+	if (lseek(fd, 0, SEEK_CUR) != 16)
+		goto out;
+
+	/* Positional read does not move the offset. */
+	if ((pread(fd, buf, 16, 0) != 16) || (memcmp(buf, "abcdEFghijklmnop", 16)))
+		goto out;
+	if (lseek(fd, 0, SEEK_CUR) != 16)
+		goto out;
+
+	/* Scatter. */
+	if (lseek(fd, 0, SEEK_SET) != 0)
+		goto out;
+	iov[0].iov_base = a; iov[0].iov_len = sizeof(a);
+	iov[1].iov_base = b; iov[1].iov_len = sizeof(b);
+	iov[2].iov_base = c; iov[2].iov_len = sizeof(c);
+	if (readv(fd, iov, 3) != 16)
+		goto out;
+	if (memcmp(a, "abcd", 4) || memcmp(b, "EFghijkl", 8) || memcmp(c, "mnop", 4))
+		goto out;
+
+	/* Short read at end of file. */
+	if ((lseek(fd, 10, SEEK_SET) != 10) || (readv(fd, iov, 3) != 6))
+		goto out;
+
+	ret = 0;
+
+out:
+	close(fd);
+	unlink(UIO_TEST_FILE);
+	return (ret);
+}
+
+/*============================================================================*
+ *                              getcwd test                                   *
+ *============================================================================*/
+
+/**
+ * @brief Empty directory that is aliased by getcwd test.
  */
-#define SEM_CREATE(a, b) (assert(((a) = semget(b)) >= 0))
+#define GETCWD_TEST_DIR "/home"
 
 /**
- * @brief Initializes a semaphore.
+ * @name Aliases of getcwd test directory.
  */
-#define SEM_INIT(a, b) (assert(semctl((a), SETVAL, (b)) == 0))
+/**@{*/
+#define GETCWD_TEST_NAME1 "/dev/cwdtest1" /**< Original name. */
+#define GETCWD_TEST_NAME2 "/dev/cwdtest2" /**< New name.      */
+/**@}*/
 
 /**
- * @brief Destroys a semaphore.
+ * @brief Checks the path name of the current working directory.
+ *
+ * @param expected Expected path name (NULL for any name of it).
+ *
+ * @returns Zero if getcwd() names the current working directory, and
+ *          non-zero otherwise.
  */
-#define SEM_DESTROY(x) (assert(semctl((x), IPC_RMID, 0) == 0))
+static int getcwd_check(const char *expected)
+{
+	char buf[PATH_MAX]; /* Path name.       */
+	struct stat st1;    /* Working dir.     */
+	struct stat st2;    /* Named directory. */
+
+	if (getcwd(buf, sizeof(buf)) == NULL)
+		return (-1);
+
+	if ((expected != NULL) && (strcmp(buf, expected)))
+		return (-1);
+
+	/* The name must lead to the working directory. */
+	if ((stat(".", &st1) < 0) || (stat(buf, &st2) < 0))
+		return (-1);
+
+	return ((st1.st_dev != st2.st_dev) || (st1.st_ino != st2.st_ino));
+}
 
 /**
- * @brief Ups a semaphore.
+ * @brief Working directory name test.
+ *
+ * @details Walks into a nested directory and checks getcwd(). Then renames
+ *          the working directory the way mv does, with link() and unlink(),
+ *          and removes it, checking that getcwd() still names it correctly,
+ *          either from the kernel name cache or from the library fallback.
+ *          There is no mkdir() system call, so the nested directory is a
+ *          link to an empty directory, which needs superuser privileges.
+ *
+ * @returns Zero if passed on test, and non-zero otherwise.
  */
-#define SEM_UP(x) (assert(semop((x), 1) == 0))
+static int getcwd_test(void)
+{
+	int ret = -1; /* Test result. */
+
+	/* Leftovers from a previous run. */
+	unlink(GETCWD_TEST_NAME1);
+	unlink(GETCWD_TEST_NAME2);
+
+	/* Plain directory. */
+	if ((chdir("/dev") < 0) || (getcwd_check("/dev")))
+		goto out;
+
+	/* Nested directory. */
+	if (link(GETCWD_TEST_DIR, GETCWD_TEST_NAME1) < 0)
+		goto out;
+	if ((chdir(GETCWD_TEST_NAME1) < 0) || (getcwd_check(GETCWD_TEST_NAME1)))
+		goto out;
+
+	/* Rename working directory. */
+	if (link(GETCWD_TEST_NAME1, GETCWD_TEST_NAME2) < 0)
+		goto out;
+	if (unlink(GETCWD_TEST_NAME1) < 0)
+		goto out;
+	if (getcwd_check(NULL))
+		goto out;
+
+	/* New name is learnt on the way in. */
+	if ((chdir(GETCWD_TEST_NAME2) < 0) || (getcwd_check(GETCWD_TEST_NAME2)))
+		goto out;
+
+	/* Remove that name. */
+	if (unlink(GETCWD_TEST_NAME2) < 0)
+		goto out;
+	if (getcwd_check(GETCWD_TEST_DIR))
+		goto out;
+
+	ret = 0;
+
+out:
+	chdir("/");
+	unlink(GETCWD_TEST_NAME1);
+	unlink(GETCWD_TEST_NAME2);
+	return (ret);
+}
+
+/*============================================================================*
+ *                              dirent test                                   *
+ *============================================================================*/
 
 /**
- * @brief Downs a semaphore.
+ * @brief Directory that is filled by dirent test.
  */
-#define SEM_DOWN(x) (assert(semop((x), -1) == 0))
+#define DIRENT_TEST_DIR "/home"
 
 /**
- * @brief Puts an item in a buffer.
+ * @brief Number of files created by dirent test.
+ *
+ * @details Chosen so that the directory does not fit in a single getdents()
+ *          buffer of readdir().
  */
-#define PUT_ITEM(a, b)                                \
-{                                                     \
-	assert(lseek((a), 0, SEEK_SET) != -1);            \
-	assert(write((a), &(b), sizeof(b)) == sizeof(b)); \
-}                                                     \
+#define DIRENT_TEST_NR_FILES 80
 
 /**
- * @brief Gets an item from a buffer.
+ * @brief Maximum number of entries tracked by dirent test.
  */
-#define GET_ITEM(a, b)                               \
-{                                                    \
-	assert(lseek((a), 0, SEEK_SET) != -1);           \
-	assert(read((a), &(b), sizeof(b)) == sizeof(b)); \
-}                                                    \
+#define DIRENT_TEST_MAX_ENTRIES (DIRENT_TEST_NR_FILES + 16)
 
 /**
- * @brief Producer-Consumer problem with semaphores.
+ * @brief Builds the name of a file created by dirent test.
  *
- * @details Reproduces consumer-producer scenario using semaphores.
+ * @param buf Buffer where the name should be stored.
+ * @param i   Number of the file.
+ */
+static void dirent_name(char *buf, int i)
+{
+	strcpy(buf, DIRENT_TEST_DIR "/dt00");
+	buf[strlen(buf) - 2] = '0' + i/10;
+	buf[strlen(buf) - 1] = '0' + i%10;
+}
+
+/**
+ * @brief Directory reading test.
+ *
+ * @details Fills a directory with more entries than fit in one getdents()
+ *          buffer, and checks that readdir() returns every entry exactly
+ *          once. Then rewinds the directory stream and checks that the
+ *          listing restarts from the first entry.
  *
  * @returns Zero if passed on test, and non-zero otherwise.
  */
-int semaphore_test3(void)
+static int dirent_test(void)
 {
-	pid_t pid;                  /* Process ID.              */
-	int buffer_fd;              /* Buffer file descriptor.  */
-	int empty;                  /* Empty positions.         */
-	int full;                   /* Full positions.          */
-	int mutex;                  /* Mutex.                   */
-	const int BUFFER_SIZE = 32; /* Buffer size.             */
-	const int NR_ITEMS = 512;   /* Number of items to send. */
+	int fd;                                         /* File descriptor.  */
+	DIR *dirp;                                      /* Directory stream. */
+	struct dirent *dp;                              /* Directory entry.  */
+	int nentries;                                   /* Entries read.     */
+	struct dirent first;                            /* First entry.      */
+	char names[DIRENT_TEST_MAX_ENTRIES][NAME_MAX];  /* Entries read.     */
+	int seen[DIRENT_TEST_NR_FILES];                 /* Files seen.       */
+	char filename[PATH_MAX];                        /* File name.        */
+	int ret = -1;                                   /* Test result.      */
+
+	/* Create files. */
+	for (int i = 0; i < DIRENT_TEST_NR_FILES; i++)
+	{
+		dirent_name(filename, i);
+		unlink(filename);
+		if ((fd = open(filename, O_WRONLY | O_CREAT, S_IRUSR | S_IWUSR)) < 0)
+			goto out;
+		close(fd);
+		seen[i] = 0;
+	}
 
-	/* Create buffer.*/
-	buffer_fd = open("buffer", O_RDWR | O_CREAT, S_IRUSR | S_IWUSR);
-	if (buffer_fd < 0)
-		return (-1);
+	if ((dirp = opendir(DIRENT_TEST_DIR)) == NULL)
+		goto out;
 
-	/* Create semaphores. */
-	SEM_CREATE(mutex, 1);
-	SEM_CREATE(empty, 2);
-	SEM_CREATE(full, 3);
+	/* Read directory. */
+	nentries = 0;
+	while ((dp = readdir(dirp)) != NULL)
+	{
+		if (nentries == DIRENT_TEST_MAX_ENTRIES)
+			goto out1;
 
-	/* Initialize semaphores. */
-	SEM_INIT(full, 0);
-	SEM_INIT(empty, BUFFER_SIZE);
-	SEM_INIT(mutex, 1);
+		/* Entries must not repeat. */
+		for (int i = 0; i < nentries; i++)
+		{
+			if (!strncmp(names[i], dp->d_name, NAME_MAX))
+				goto out1;
+		}
+		strncpy(names[nentries], dp->d_name, NAME_MAX);
 
-	if ((pid = fork()) < 0)
-		return (-1);
+		if (nentries++ == 0)
+			memcpy(&first, dp, sizeof(struct dirent));
 
-	/* Producer. */
-	else if (pid == 0)
-	{
-		for (int item = 0; item < NR_ITEMS; item++)
+		/* One of our files. */
+		if ((dp->d_name[0] == 'd') && (dp->d_name[1] == 't'))
 		{
-			SEM_DOWN(empty);
-			SEM_DOWN(mutex);
-
-			PUT_ITEM(buffer_fd, item);
+			int i = (dp->d_name[2] - '0')*10 + (dp->d_name[3] - '0');
 
-			SEM_UP(mutex);
-			SEM_UP(full);
+			if ((i >= 0) && (i < DIRENT_TEST_NR_FILES))
+				seen[i]++;
 		}
+	}
 
-		_exit(EXIT_SUCCESS);
+	/* Every file must have been seen. */
+	for (int i = 0; i < DIRENT_TEST_NR_FILES; i++)
+	{
+		if (seen[i] != 1)
+			goto out1;
 	}
 
-	/* Consumer. */
-	else
+	/* Listing restarts from the first entry. */
+	rewinddir(dirp);
+	if ((dp = readdir(dirp)) == NULL)
+		goto out1;
+	if ((dp->d_ino != first.d_ino) || (strncmp(dp->d_name, first.d_name, NAME_MAX)))
+		goto out1;
+
+	ret = 0;
+
+out1:
+	closedir(dirp);
+out:
+	for (int i = 0; i < DIRENT_TEST_NR_FILES; i++)
 	{
-		int item;
+		dirent_name(filename, i);
+		unlink(filename);
+	}
+	return (ret);
+}
 
-		do
-		{
-			SEM_DOWN(full);
-			SEM_DOWN(mutex);
+/*============================================================================*
+ *                               poll test                                    *
+ *============================================================================*/
 
-			GET_ITEM(buffer_fd, item);
+/**
+ * @brief I/O multiplexing test.
+ *
+ * @details Checks that an empty non-blocking pipe fails with EAGAIN, that
+ *          poll() and select() time out on idle pipes, and that they wake up
+ *          when a child process writes to one of two polled pipes.
+ *
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+static int poll_test(void)
+{
+	pid_t pid;            /* Child process.  */
+	int p1[2], p2[2];     /* Pipes.          */
+	char ch;              /* Working byte.   */
+	struct pollfd fds[2]; /* Polled pipes.   */
+	fd_set rfds;          /* Read set.       */
+	struct timeval tv;    /* Select timeout. */
+	int ret = -1;         /* Test result.    */
+
+	if (pipe(p1) < 0)
+		return (-1);
+	if (pipe(p2) < 0)
+	{
+		close(p1[0]); close(p1[1]);
+		return (-1);
+	}
 
-			SEM_UP(mutex);
-			SEM_UP(empty);
-		} while (item != (NR_ITEMS - 1));
+	/* Empty non-blocking pipe. */
+	if (fcntl(p1[0], F_SETFL, O_NONBLOCK) < 0)
+		goto out;
+	if ((read(p1[0], &ch, 1) != -1) || (errno != EAGAIN))
+		goto out;
+
+	fds[0].fd = p1[0]; fds[0].events = POLLIN;
+	fds[1].fd = p2[0]; fds[1].events = POLLIN;
+
+	/* Nothing to read yet. */
+	if (poll(fds, 2, 0) != 0)
+		goto out;
+	if (poll(fds, 2, 50) != 0)
+		goto out;
+	FD_ZERO(&rfds);
+	FD_SET(p1[0], &rfds);
+	tv.tv_sec = 0; tv.tv_usec = 50000;
+	if ((select(p1[0] + 1, &rfds, NULL, NULL, &tv) != 0) || (FD_ISSET(p1[0], &rfds)))
+		goto out;
+
+	/* Wake up on write. */
+	if ((pid = fork()) < 0)
+		goto out;
+	if (pid == 0)
+	{
+		close(p1[0]); close(p2[0]);
+		write(p2[1], "x", 1);
+		_exit(EXIT_SUCCESS);
 	}
+	close(p2[1]); p2[1] = -1;
+	if (poll(fds, 2, -1) != 1)
+		goto out;
+	if ((fds[0].revents != 0) || (!(fds[1].revents & POLLIN)))
+		goto out;
+	wait(NULL);
 
-	/* Destroy semaphores. */
-	SEM_DESTROY(mutex);
-	SEM_DESTROY(empty);
-	SEM_DESTROY(full);
+	/* Ready for select() as well. */
+	FD_ZERO(&rfds);
+	FD_SET(p1[0], &rfds);
+	FD_SET(p2[0], &rfds);
+	if ((select(p2[0] + 1, &rfds, NULL, NULL, NULL) != 1) || (FD_ISSET(p1[0], &rfds)))
+		goto out;
+	if ((!FD_ISSET(p2[0], &rfds)) || (read(p2[0], &ch, 1) != 1) || (ch != 'x'))
+		goto out;
+
+	/* Writer is gone. */
+	if ((poll(&fds[1], 1, 0) != 1) || (!(fds[1].revents & POLLHUP)))
+		goto out;
+
+	ret = 0;
+
+out:
+	close(p1[0]); close(p1[1]);
+	close(p2[0]);
+	if (p2[1] >= 0)
+		close(p2[1]);
+	return (ret);
+}
 
-	close(buffer_fd);
-	unlink("buffer");
+/*============================================================================*
+ *                              Shell test                                    *
+ *============================================================================*/
 
-	return (0);
+/**
+ * @brief Script of shell test.
+ */
+#define SHELL_TEST_SCRIPT "/tshtest"
+
+/**
+ * @brief Number of commands in the script of shell test.
+ */
+#define SHELL_TEST_NR_CMDS 1000
+
+/**
+ * @brief Runs a shell script that repeats a command line.
+ *
+ * @param cmd Command line.
+ *
+ * @returns Zero if the shell succeeds, and non-zero otherwise.
+ */
+static int shell_run(const char *cmd)
+{
+	int fd;         /* Script file.    */
+	int status;     /* Exit status.    */
+	pid_t pid, ret; /* Child process.  */
+	size_t len;     /* Command length. */
+	char *const argv[] = { "tsh", NULL };
+
+	/* Write script. */
+	if ((fd = open(SHELL_TEST_SCRIPT, O_WRONLY | O_CREAT | O_TRUNC,
+		S_IRUSR | S_IWUSR)) < 0)
+		return (-1);
+	len = strlen(cmd);
+	for (int i = 0; i < SHELL_TEST_NR_CMDS; i++)
+	{
+		if ((write(fd, cmd, len) != (ssize_t)len) || (write(fd, "\n", 1) != 1))
+		{
+			close(fd);
+			return (-1);
+		}
+	}
+	close(fd);
+
+	if ((pid = fork()) < 0)
+		return (-1);
+
+	/* Child process. */
+	if (pid == 0)
+	{
+		close(0);
+		open(SHELL_TEST_SCRIPT, O_RDONLY);
+		close(1);
+		open("/dev/null", O_WRONLY);
+		execv("/bin/tsh", argv);
+		_exit(EXIT_FAILURE);
+	}
+
+	/* Wait for child. */
+	do
+	{
+		if ((ret = wait(&status)) < 0)
+			return (-1);
+	} while (ret != pid);
+
+	return (!(WIFEXITED(status) && (WEXITSTATUS(status) == EXIT_SUCCESS)));
 }
 
+/**
+ * @brief Shell script throughput test.
+ *
+ * @details Runs a script of small pipelines, first spawning an external echo
+ *          for each of them, and then using the built-in one.
+ *
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+static int shell_test(void)
+{
+	clock_t t0, t1, t2; /* Elapsed times.      */
+	struct tms timing;  /* Timing information. */
+	int ret = -1;       /* Test result.        */
+
+	t0 = times(&timing);
+
+	if (shell_run("/bin/echo hello | cat"))
+		goto out;
+
+	t1 = times(&timing);
+
+	if (shell_run("echo hello | cat"))
+		goto out;
+
+	t2 = times(&timing);
+
+	/* Print timing statistics. */
+	if (flags & VERBOSE)
+	{
+		printf("  external echo | cat: %d ticks for %d pipelines\n",
+			t1 - t0, SHELL_TEST_NR_CMDS);
+		printf("  built-in echo | cat: %d ticks for %d pipelines\n",
+			t2 - t1, SHELL_TEST_NR_CMDS);
+	}
+
+	ret = 0;
+
+out:
+	unlink(SHELL_TEST_SCRIPT);
+	return (ret);
+}
 
 /*============================================================================*
  *                                FPU test                                    *
@@ -687,6 +2915,22 @@ static void usage(void)
 	printf("  ipc   Interprocess Communication Test\n");
 	printf("  swp   Swapping Test\n");
 	printf("  sched Scheduling Test\n");
+	printf("  spawn Process Spawning Test\n");
+	printf("  mmap  Memory Mapping Test\n");
+	printf("  pipe  Pipe Bandwidth Test\n");
+	printf("  fork  Fork Storm Test\n");
+	printf("  clock High-Resolution Clock Test\n");
+	printf("  sys   Null System Call Test\n");
+	printf("  futex Futex Test\n");
+	printf("  thread Thread Test\n");
+	printf("  malloc Memory Allocator Test\n");
+	printf("  string String Routines Test\n");
+	printf("  copy  File Copy Test\n");
+	printf("  uio   Positional and Vectored I/O Test\n");
+	printf("  cwd   Working Directory Name Test\n");
+	printf("  dirent Directory Reading Test\n");
+	printf("  poll  I/O Multiplexing Test\n");
+	printf("  tsh   Shell Script Throughput Test\n");
 
 	exit(EXIT_SUCCESS);
 }
@@ -739,12 +2983,146 @@ int main(int argc, char **argv)
 			
 		}
 
+		/* Process spawning test. */
+		else if (!strcmp(argv[i], "spawn"))
+		{
+			printf("Process Spawning Test\n");
+			printf("  Result:             [%s]\n",
+				(!spawn_test()) ? "PASSED" : "FAILED");
+		}
+
+		/* Memory mapping test. */
+		else if (!strcmp(argv[i], "mmap"))
+		{
+			printf("Memory Mapping Test\n");
+			printf("  Result:             [%s]\n",
+				(!mmap_test()) ? "PASSED" : "FAILED");
+		}
+
+		/* Pipe bandwidth test. */
+		else if (!strcmp(argv[i], "pipe"))
+		{
+			printf("Pipe Bandwidth Test\n");
+			printf("  Result:             [%s]\n",
+				(!pipe_test()) ? "PASSED" : "FAILED");
+		}
+
+		/* Fork storm test. */
+		else if (!strcmp(argv[i], "fork"))
+		{
+			printf("Fork Storm Test\n");
+			printf("  Result:             [%s]\n",
+				(!forkstorm_test()) ? "PASSED" : "FAILED");
+		}
+
+		/* High-resolution clock test. */
+		else if (!strcmp(argv[i], "clock"))
+		{
+			printf("High-Resolution Clock Test\n");
+			printf("  Result:             [%s]\n",
+				(!clock_test()) ? "PASSED" : "FAILED");
+		}
+
+		/* Null system call test. */
+		else if (!strcmp(argv[i], "sys"))
+		{
+			printf("Null System Call Test\n");
+			printf("  Result:             [%s]\n",
+				(!syscall_test()) ? "PASSED" : "FAILED");
+		}
+
+		/* Futex test. */
+		else if (!strcmp(argv[i], "futex"))
+		{
+			printf("Futex Test\n");
+			printf("  Result:             [%s]\n",
+				(!futex_test()) ? "PASSED" : "FAILED");
+		}
+
+		/* Thread test. */
+		else if (!strcmp(argv[i], "thread"))
+		{
+			printf("Thread Test\n");
+			printf("  Result:             [%s]\n",
+				(!thread_test()) ? "PASSED" : "FAILED");
+		}
+
+		/* malloc test. */
+		else if (!strcmp(argv[i], "malloc"))
+		{
+			printf("Memory Allocator Test\n");
+			printf("  Result:             [%s]\n",
+				(!malloc_test()) ? "PASSED" : "FAILED");
+		}
+
+		/* String test. */
+		else if (!strcmp(argv[i], "string"))
+		{
+			printf("String Routines Test\n");
+			printf("  Result:             [%s]\n",
+				(!string_test()) ? "PASSED" : "FAILED");
+		}
+
+		/* File copy test. */
+		else if (!strcmp(argv[i], "copy"))
+		{
+			printf("File Copy Test\n");
+			printf("  Result:             [%s]\n",
+				(!copy_test()) ? "PASSED" : "FAILED");
+		}
+
+		/* Positional and vectored I/O test. */
+		else if (!strcmp(argv[i], "uio"))
+		{
+			printf("Positional and Vectored I/O Test\n");
+			printf("  Result:             [%s]\n",
+				(!uio_test()) ? "PASSED" : "FAILED");
+		}
+
+		/* Working directory name test. */
+		else if (!strcmp(argv[i], "cwd"))
+		{
+			printf("Working Directory Name Test\n");
+			printf("  Result:             [%s]\n",
+				(!getcwd_test()) ? "PASSED" : "FAILED");
+		}
+
+		/* Directory reading test. */
+		else if (!strcmp(argv[i], "dirent"))
+		{
+			printf("Directory Reading Test\n");
+			printf("  Result:             [%s]\n",
+				(!dirent_test()) ? "PASSED" : "FAILED");
+		}
+
+		/* I/O multiplexing test. */
+		else if (!strcmp(argv[i], "poll"))
+		{
+			printf("I/O Multiplexing Test\n");
+			printf("  Result:             [%s]\n",
+				(!poll_test()) ? "PASSED" : "FAILED");
+		}
+
+		/* Shell script throughput test. */
+		else if (!strcmp(argv[i], "tsh"))
+		{
+			printf("Shell Script Throughput Test\n");
+			printf("  Result:             [%s]\n",
+				(!shell_test()) ? "PASSED" : "FAILED");
+		}
+
 		/* IPC test. */
 		else if (!strcmp(argv[i], "ipc"))
 		{
 			printf("Interprocess Communication Tests\n");
 			printf("  producer consumer [%s]\n",
 				(!semaphore_test3()) ? "PASSED" : "FAILED");
+			printf("  shm ring buffer   [%s]\n",
+				(!semaphore_test4()) ? "PASSED" : "FAILED");
+			printf("  semaphore set     [%s]\n",
+				(!semaphore_test5()) ? "PASSED" : "FAILED");
+			printf("  shm read-only     [%s]\n",
+				(!shm_test()) ? "PASSED" : "FAILED");
 		}
 
 		/* FPU test. */
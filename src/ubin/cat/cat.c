@@ -39,46 +39,35 @@ static int nfiles = 0;         /* Number of files to concatenate. */
  */
 static void cat(char *filename)
 {
-	int fd;           /* File descriptor.        */
-	int off;          /* Buffer offset.          */
-	char buf[BUFSIZ]; /* Buffer.                 */
-	ssize_t n, nread; /* Bytes actually read.    */
-	ssize_t nwritten; /* Bytes actually written. */
+	FILE *file;       /* File stream.     */
+	size_t n;         /* Bytes read.      */
+	char buf[BUFSIZ]; /* Buffer.          */
 
-	fd = open(filename, O_RDONLY);
+	file = fopen(filename, "r");
 
 	/* Failed to open file. */
-	if (fd < 0)
+	if (file == NULL)
 	{
 		fprintf(stderr, "cat: cannot open %s\n", filename);
 		return;
 	}
 
 	/* Concatenate file. */
-	do
+	while ((n = fread(buf, 1, BUFSIZ, file)) > 0)
 	{
-		/* Error while reading. */
-		if ((nread = read(fd, buf, BUFSIZ)) < 0)
-			fprintf(stderr, "cat: cannot read %s\n", filename);
-
-		n = nread;
-
-		off = 0;
-		do
+		/* Failed to write. */
+		if (fwrite(buf, 1, n, stdout) != n)
 		{
-			nwritten = write(fileno(stdout), &buf[off], nread);
+			fprintf(stderr, "cat: write error\n");
+			exit(errno);
+		}
+	}
 
-			/* Failed to write. */
-			if (nwritten < 0)
-			{
-				fprintf(stderr, "cat: write error\n");
-				exit(errno);
-			}
-			off += nwritten;
-		} while ((nread -= nwritten) > 0);
-	} while (n == BUFSIZ);
+	/* Error while reading. */
+	if (ferror(file))
+		fprintf(stderr, "cat: cannot read %s\n", filename);
 
-	close(fd);
+	fclose(file);
 }
 
 /*
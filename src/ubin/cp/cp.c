@@ -19,6 +19,7 @@
 
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <errno.h>
 #include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -29,6 +30,9 @@
 #define VERSION_MAJOR 1 /* Major version. */
 #define VERSION_MINOR 0 /* Minor version. */
 
+/* Bytes copied by each copy_file_range() call. */
+#define COPY_CHUNK (64*1024)
+
 /* Filenames. */
 static const char *src = NULL;  /* Source file. */
 static const char *dest = NULL; /* Destination file. */
@@ -36,24 +40,37 @@ static const char *dest = NULL; /* Destination file. */
 /*
  * Copies a file.
  */
-static void do_cp(int src, int dest)
+static void do_cp(FILE *src, FILE *dest)
 {
-	ssize_t count;    /* Bytes read/written.  */
-	char buf[BUFSIZ]; /* Buffer.              */
-
-	/* Copy source file into destination file. */
-	while ((count = read(src, buf, BUFSIZ)) > 0) {
-		count = write(dest, buf, count);
+	ssize_t n;        /* Bytes copied in kernel. */
+	size_t count;     /* Bytes read/written.     */
+	char buf[BUFSIZ]; /* Buffer.                 */
+
+	/* Copy source file into destination file inside the kernel. */
+	while ((n = copy_file_range(fileno(src), NULL, fileno(dest), NULL,
+		COPY_CHUNK, 0)) > 0)
+		/* noop */ ;
+
+	/* Done. */
+	if (n == 0)
+		return;
+
+	/* Not supported for these files, so fall back to buffered copy. */
+	if (errno != EINVAL) {
+		fprintf(stderr, "cp: write error\n");
+		exit(EXIT_FAILURE);
+	}
 
+	while ((count = fread(buf, 1, BUFSIZ, src)) > 0) {
 		/* Write error. */
-		if (count < 0) {
+		if (fwrite(buf, 1, count, dest) != count) {
 			fprintf(stderr, "cp: write error\n");
 			exit(EXIT_FAILURE);
 		}
 	}
 
 	/* Error while reading. */
-	if (count < 0) {
+	if (ferror(src)) {
 		fprintf(stderr, "cp: read error\n");
 		exit(EXIT_FAILURE);
 	}
@@ -66,7 +83,8 @@ static void cp(const char *dest, const char *src)
 {
 	dev_t dev;        /* Source file device number.        */
 	ino_t ino;        /* Source file inode number.         */
-	int srcfd;        /* Source file file descriptor.      */
+	FILE *srcfile;    /* Source file stream.               */
+	FILE *destfile;   /* Destination file stream.          */
 	int destfd;       /* Destination file file descriptor. */
 	struct stat st;   /* Working file's status.            */
 	mode_t mode;      /* Creation mode.                    */
@@ -102,10 +120,10 @@ static void cp(const char *dest, const char *src)
 		}
 	}
 
-	srcfd = open(src, O_RDONLY);
+	srcfile = fopen(src, "r");
 
 	/* Failed to open source file. */
-	if (srcfd == -1) {
+	if (srcfile == NULL) {
 		fprintf(stderr, "cp: cannot open %s\n", src);
 		exit(EXIT_FAILURE);
 	}
@@ -113,15 +131,21 @@ static void cp(const char *dest, const char *src)
 	destfd = open(dest, O_WRONLY | O_TRUNC | O_CREAT, mode);
 
 	/* Failed to open destination file. */
-	if (destfd == -1) {
+	if ((destfd == -1) || ((destfile = fdopen(destfd, "w")) == NULL)) {
 		fprintf(stderr, "cp: cannot open %s\n", dest);
 		exit(EXIT_FAILURE);
 	}
 
-	do_cp(srcfd, destfd);
+	do_cp(srcfile, destfile);
+
+	/* Failed to flush destination file. */
+	if (fflush(destfile) == EOF) {
+		fprintf(stderr, "cp: write error\n");
+		exit(EXIT_FAILURE);
+	}
 
-	close(destfd);
-	close(srcfd);
+	fclose(destfile);
+	fclose(srcfile);
 }
 
 /*
@@ -18,6 +18,8 @@
  */
 
 #include <sys/stat.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -142,12 +144,50 @@ static void buildname(char *name1, char *name2, char *strbuf)
 	}
 }
 
+/*
+ * Copies file 1 onto file 2, for moves across devices.
+ */
+static int copy(const char *name1, const char *name2, mode_t mode)
+{
+	ssize_t n; /* Bytes copied. */
+	int fd1;   /* File 1.       */
+	int fd2;   /* File 2.       */
+
+	/* Failed to open file 1. */
+	if ((fd1 = open(name1, O_RDONLY)) < 0)
+		return (-1);
+
+	/* Failed to create file 2. */
+	if ((fd2 = open(name2, O_WRONLY | O_CREAT | O_TRUNC, mode)) < 0)
+	{
+		close(fd1);
+		return (-1);
+	}
+
+	/* Copy data inside the kernel. */
+	while ((n = copy_file_range(fd1, NULL, fd2, NULL, 64*1024, 0)) > 0)
+		/* noop */ ;
+
+	close(fd2);
+	close(fd1);
+
+	/* Failed to copy. */
+	if (n < 0)
+	{
+		unlink(name2);
+		return (-1);
+	}
+
+	return (0);
+}
+
 /*
  * Creates a link between two files
  */
 int main(int argc, char *const argv[])
 {
 	char *name2;           /* Name of file 2. */
+	mode_t mode;           /* Mode of file 1. */
 	struct stat st;        /* stat() buffer.  */
 	char strbuf[PATH_MAX]; /* String buffer.  */
 
@@ -169,6 +209,8 @@ int main(int argc, char *const argv[])
 		return (EXIT_FAILURE);
 	}
 
+	mode = st.st_mode;
+
 again:
 	/* File 2 already exits... */
 	if (stat(name2, &st) == 0)
@@ -192,8 +234,12 @@ again:
 	/* Failed to link(). */
 	if (link(args.name1, name2) < 0)
 	{
-		fprintf(stderr, "mv: cannot link()\n");
-		return (EXIT_FAILURE);
+		/* Files on different devices, so copy data instead. */
+		if ((errno != EXDEV) || (copy(args.name1, name2, mode) < 0))
+		{
+			fprintf(stderr, "mv: cannot link()\n");
+			return (EXIT_FAILURE);
+		}
 	}
 
 	/* Failed to unlink(). */
@@ -24,6 +24,7 @@
 #include <string.h>
 #include <unistd.h>
 #include "builtin.h"
+#include "hash.h"
 #include "tsh.h"
 
 /*
@@ -48,6 +49,18 @@ static int builtin_cd(int argc, const char **argv)
 	return (EXIT_SUCCESS);
 }
 
+/*
+ * Writes arguments to the standard output.
+ */
+static int builtin_echo(int argc, const char **argv)
+{
+	for (int i = 1; i < argc; i++)
+		printf("%s%s", argv[i], (i + 1 < argc) ? " " : "");
+	putchar('\n');
+
+	return (EXIT_SUCCESS);
+}
+
 /*
  * Exits the shell.
  */
@@ -62,6 +75,40 @@ static int builtin_exit(int argc, const char **argv)
 	return (0);
 }
 
+/*
+ * Manages remembered command locations.
+ */
+static int builtin_hash(int argc, const char **argv)
+{
+	int ret = EXIT_SUCCESS;
+
+	/* Print remembered locations. */
+	if (argc < 2)
+	{
+		hash_print();
+		return (EXIT_SUCCESS);
+	}
+
+	/* Forget all locations. */
+	if (!strcmp(argv[1], "-r"))
+	{
+		hash_clear();
+		return (EXIT_SUCCESS);
+	}
+
+	/* Remember locations. */
+	for (int i = 1; i < argc; i++)
+	{
+		if (hash_lookup(argv[i]) == NULL)
+		{
+			fprintf(stderr, "hash: %s: not found\n", argv[i]);
+			ret = EXIT_FAILURE;
+		}
+	}
+
+	return (ret);
+}
+
 /*
  * Waits for all child processes to complete.
  */
@@ -86,8 +133,12 @@ builtin_t getbuiltin(const char *cmdname)
 {
 	if (!strcmp(cmdname, "cd"))
 		return (&builtin_cd);
+	else if (!strcmp(cmdname, "echo"))
+		return (&builtin_echo);
 	else if (!strcmp(cmdname, "exit"))
 		return (&builtin_exit);
+	else if (!strcmp(cmdname, "hash"))
+		return (&builtin_hash);
 	else if (!strcmp(cmdname, "wait"))
 		return (&builtin_wait);
 
@@ -0,0 +1,184 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sys/stat.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tsh.h"
+#include "hash.h"
+
+/**
+ * @brief Remembered command location.
+ */
+struct hashent
+{
+	char name[NAME_MAX + 1]; /**< Command name (empty if unused). */
+	char path[PATH_MAX];     /**< Full path name.                 */
+	unsigned hits;           /**< Number of lookups served.       */
+};
+
+/**
+ * @brief Command location cache.
+ *
+ * @details Entries are direct-mapped on the hash of the command name, so a
+ *          colliding command simply takes over the slot.
+ */
+static struct hashent hashtab[HASH_SIZE];
+
+/**
+ * @brief Hashes a command name.
+ *
+ * @param name Target command name.
+ *
+ * @returns The slot of @p name in the cache.
+ */
+static struct hashent *hash_slot(const char *name)
+{
+	unsigned h = 0;
+
+	while (*name != '\0')
+		h = h*31 + (unsigned char)*name++;
+
+	return (&hashtab[h%HASH_SIZE]);
+}
+
+/**
+ * @brief Searches the PATH for a command.
+ *
+ * @param name Target command name.
+ * @param path Buffer where the full path name shall be stored.
+ *
+ * @returns Zero if the command was found, and non-zero otherwise.
+ */
+static int hash_search(const char *name, char *path)
+{
+	size_t len;      /* Command name length. */
+	const char *dir; /* Working directory.   */
+	const char *end; /* End of directory.    */
+	struct stat st;  /* File status.         */
+
+	len = strlen(name) + 1;
+
+	for (dir = getenv("PATH"); (dir != NULL) && (*dir != '\0'); dir = end)
+	{
+		if ((end = strchr(dir, ':')) == NULL)
+			end = strchr(dir, '\0');
+
+		/* Path name too long. */
+		if ((size_t)(end - dir) + 1 + len > PATH_MAX)
+			goto next;
+
+		memcpy(path, dir, end - dir);
+		path[end - dir] = '/';
+		memcpy(&path[(end - dir) + 1], name, len);
+
+		/* Found. */
+		if ((stat(path, &st) == 0) && (S_ISREG(st.st_mode)))
+			return (0);
+
+next:
+		if (*end == ':')
+			end++;
+	}
+
+	return (-1);
+}
+
+/**
+ * @brief Locates a command.
+ *
+ * @details Commands with a slash in their names are not looked up. Otherwise,
+ *          the remembered location is used, and the PATH is only searched on
+ *          a cache miss.
+ *
+ * @param name Target command name.
+ *
+ * @returns The full path name of the command, or NULL if it was not found.
+ */
+const char *hash_lookup(const char *name)
+{
+	struct hashent *e;   /* Cache entry.    */
+	char path[PATH_MAX]; /* Full path name. */
+
+	/* Explicit path. */
+	if (strchr(name, '/') != NULL)
+		return (name);
+
+	/* Not cacheable. */
+	if (strlen(name) > NAME_MAX)
+		return (NULL);
+
+	e = hash_slot(name);
+
+	/* Hit. */
+	if (!strcmp(e->name, name))
+	{
+		e->hits++;
+		return (e->path);
+	}
+
+	/* Miss. */
+	if (hash_search(name, path))
+		return (NULL);
+
+	strcpy(e->name, name);
+	strcpy(e->path, path);
+	e->hits = 1;
+
+	return (e->path);
+}
+
+/**
+ * @brief Forgets the location of a command.
+ *
+ * @param name Target command name.
+ */
+void hash_forget(const char *name)
+{
+	struct hashent *e;
+
+	e = hash_slot(name);
+
+	if (!strcmp(e->name, name))
+		e->name[0] = '\0';
+}
+
+/**
+ * @brief Forgets all remembered command locations.
+ */
+void hash_clear(void)
+{
+	for (int i = 0; i < HASH_SIZE; i++)
+		hashtab[i].name[0] = '\0';
+}
+
+/**
+ * @brief Prints remembered command locations.
+ */
+void hash_print(void)
+{
+	for (int i = 0; i < HASH_SIZE; i++)
+	{
+		if (hashtab[i].name[0] != '\0')
+			printf("%u\t%s\n", hashtab[i].hits, hashtab[i].path);
+	}
+}
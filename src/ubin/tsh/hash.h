@@ -0,0 +1,34 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _HASH_H_
+#define _HASH_H_
+
+	/**
+	 * @brief Number of remembered command locations.
+	 */
+	#define HASH_SIZE 16
+
+	/* Forward definitions. */
+	extern const char *hash_lookup(const char *);
+	extern void hash_forget(const char *);
+	extern void hash_clear(void);
+	extern void hash_print(void);
+
+#endif /* _HASH_H_ */
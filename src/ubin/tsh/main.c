@@ -34,6 +34,7 @@
 #include <ctype.h>
 
 #include "builtin.h"
+#include "hash.h"
 #include "tsh.h"
 #include "history.h"
 
@@ -62,6 +63,10 @@ static struct history *hist = NULL;
  */
 static void switch_canonical(void)
 {
+	/* Not a terminal. */
+	if (!(shflags & SH_INTERACTIVE))
+		return;
+
 	if (tcsetattr(fileno(stdin), TCSANOW, &canonical) < 0)
 	{
 		fprintf(stderr, "%s: failed to switch to canonical mode\n", TSH_NAME);
@@ -74,6 +79,10 @@ static void switch_canonical(void)
  */
 static void switch_raw(void)
 {
+	/* Not a terminal. */
+	if (!(shflags & SH_INTERACTIVE))
+		return;
+
 	if (tcsetattr(fileno(stdin), TCSANOW, &raw) < 0)
 	{
 		fprintf(stderr, "%s: failed to switch to raw mode\n", TSH_NAME);
@@ -155,26 +164,97 @@ static void closeredir(int *redir)
 		close(redir[1]);
 }
 
+/*
+ * Runs a built-in command inside the shell.
+ *
+ * This is only done for standalone commands and for the last stage of
+ * a pipeline, so the standard output is temporarily redirected to a
+ * file, and never to a pipe that nobody is reading yet.
+ */
+static int runbuiltin(builtin_t cmd, const char **args, int argc, int *redir)
+{
+	int ret;        /* Exit status.     */
+	int saved = -1; /* Standard output. */
+
+	/* Redirect output. */
+	if (redir[1] != -1)
+	{
+		fflush(stdout);
+
+		if ((saved = dup(1)) == -1)
+			goto error;
+		if (dup2(redir[1], 1) == -1)
+		{
+			close(saved);
+			goto error;
+		}
+	}
+
+	ret = cmd(argc, args);
+
+	/* Restore output. */
+	if (saved != -1)
+	{
+		fflush(stdout);
+		dup2(saved, 1);
+		close(saved);
+	}
+
+	return (ret);
+
+error:
+	fprintf(stderr, "%s: failed to redirect\n", args[0]);
+	return (EXIT_FAILURE);
+}
+
 /*
  * Runs a command.
  */
 static void runcmd(const char **args, int argc, int *redir, int flags)
 {
-	int i;         /* Loop index.       */
-	int status;    /* Exit status.      */
-	pid_t pid;     /* Child process ID. */
-	builtin_t cmd; /* Built-in command. */
+	int i;                /* Loop index.       */
+	int status;           /* Exit status.      */
+	pid_t pid;            /* Child process ID. */
+	builtin_t cmd;        /* Built-in command. */
+	const char *path;     /* Command location. */
+	int retried = 0;      /* Searched again?   */
+	char stale[PATH_MAX]; /* Stale location.   */
 
-	/* Checks built-in. */
-	if ((cmd = getbuiltin(args[0])) != NULL)
+	cmd = getbuiltin(args[0]);
+
+	/*
+	 * Standalone built-in or last stage of a
+	 * pipeline, so run it in the shell itself.
+	 */
+	if ((cmd != NULL) && (!(flags & CMD_PIPE)))
 	{
+		shret = runbuiltin(cmd, args, argc, redir);
 		closeredir(redir);
-		if ((shret = cmd(argc, args)) != EXIT_SUCCESS)
+		if (shret != EXIT_SUCCESS)
 			sherror();
 		return;
 	}
 
-	pid = fork();
+	/* Locate command. */
+	path = NULL;
+	if ((cmd == NULL) && ((path = hash_lookup(args[0])) == NULL))
+	{
+		fprintf(stderr, "%s: command not found\n", args[0]);
+		shret = EXIT_FAILURE;
+		goto error;
+	}
+
+spawn:
+
+	/*
+	 * The child of an external command only sets up
+	 * signals and redirections before calling execv(),
+	 * so it can safely borrow our address space. Built-in
+	 * commands run in the child, so they need a copy.
+	 */
+	if (cmd != NULL)
+		fflush(stdout);
+	pid = (cmd != NULL) ? fork() : vfork();
 
 	/* Failed to fork. */
 	if (pid < 0)
@@ -187,15 +267,17 @@ static void runcmd(const char **args, int argc, int *redir, int flags)
 	/* Parent process. */
 	if (pid > 0)
 	{
-		closeredir(redir);
-
 		/* Piping... */
 		if (flags & CMD_PIPE)
+		{
+			closeredir(redir);
 			return;
+		}
 
 		/* Asynchronous execution. */
 		if (flags & CMD_ASYNC)
 		{
+			closeredir(redir);
 			printf("[%d]+\n", pid);
 			return;
 		}
@@ -204,6 +286,23 @@ static void runcmd(const char **args, int argc, int *redir, int flags)
 		while (wait(&status) != pid)
 			/* noop */;
 
+		/*
+		 * The remembered location may be stale,
+		 * so search again, and run the command
+		 * if it has moved somewhere else.
+		 */
+		if ((cmd == NULL) && (path != args[0]) && (!retried) &&
+			(WIFEXITED(status)) && (WEXITSTATUS(status) == CMD_STALE))
+		{
+			retried = 1;
+			strcpy(stale, path);
+			hash_forget(args[0]);
+			if (((path = hash_lookup(args[0])) != NULL) && (strcmp(path, stale)))
+				goto spawn;
+		}
+
+		closeredir(redir);
+
 		/* Abnormal termination. */
 		if (status != EXIT_SUCCESS)
 		{
@@ -251,15 +350,35 @@ static void runcmd(const char **args, int argc, int *redir, int flags)
 			if (dup2(redir[i], i) == -1)
 			{
 				fprintf(stderr, "%s: failed to redirect\n", args[0]);
-				exit(EXIT_FAILURE);
+				_exit(EXIT_FAILURE);
 			}
 			close(redir[i]);
 		}
 	}
 
-	execvp(args[0], (char * const *)args);
+	/* Built-in command. */
+	if (cmd != NULL)
+	{
+		status = cmd(argc, args);
+		fflush(stdout);
+		_exit(status);
+	}
+
+	execv(path, (char * const *)args);
+
+	/* Remembered location is stale. */
+	if ((errno == ENOENT) && (path != args[0]))
+	{
+		/* The parent waits for us, and searches again. */
+		if ((!(flags & (CMD_PIPE | CMD_ASYNC))) && (!retried))
+			_exit(CMD_STALE);
+
+		/* Nobody waits for us, so search on our own. */
+		execvp(args[0], (char * const *)args);
+	}
+
 	fprintf(stderr, "%s: failed to execute\n", args[0]);
-	exit(EXIT_FAILURE);
+	_exit(EXIT_FAILURE);
 
 error:
 	sherror();
@@ -596,6 +715,18 @@ static int readline(char *line, int length, FILE *stream)
 	int size; /* # of characters left in buffer. */
 	char *p;  /* Write pointer.                  */
 
+	/* Command file. */
+	if (!(shflags & SH_INTERACTIVE))
+	{
+		if (fgets(line, length, stream) == NULL)
+			return (0);
+
+		if ((p = strchr(line, '\n')) != NULL)
+			*p = '\0';
+
+		return (1);
+	}
+
 	fd = fileno(stream);
 	size = length;
 	p =  line;
@@ -708,7 +839,7 @@ static void readargs(int argc, char **argv)
 	infile = NULL;
 
 	/* Read program arguments. */
-	for (i = 0; i < argc; i++)
+	for (i = 1; i < argc; i++)
 	{
 		arg = argv[i];
 
@@ -730,7 +861,7 @@ static void readargs(int argc, char **argv)
 	}
 
 	/* Read from standard input. */
-	if (input == NULL)
+	if (infile == NULL)
 	{
 		input = stdin;
 
@@ -791,7 +922,8 @@ int main(int argc, char **argv)
 		puts(SH_COPYRIGHT);
 
 	/* Configure tty to work in raw mode. */
-	configure_tty();
+	if (shflags & SH_INTERACTIVE)
+		configure_tty();
 
 	/* Initialize command stack. */
 	hist = history_init(HISTORY_SIZE);
@@ -813,7 +945,8 @@ int main(int argc, char **argv)
 
 			/* End of file. */
 			case 0:
-				puts("\n");
+				if (shflags & SH_INTERACTIVE)
+					puts("\n");
 				goto out;
 
 			/* Parse command line. */
@@ -47,6 +47,9 @@
 	#define CMD_ASYNC 001 /* Asynchronous? */
 	#define CMD_PIPE  002 /* Piping?       */
 
+	/* Exit status of a child that found a stale command location. */
+	#define CMD_STALE 126
+
 	/* Shell flags. */
 	#define SH_INTERACTIVE 001 /* Interactive? */
 